@@ -6,6 +6,7 @@ QMAKE_DOCS = $$PWD/doc/qtorm.qdocconf
 
 PUBLIC_HEADERS += \
     qormabstractprovider.h \
+    qormaggregate.h \
     qormclassproperty.h \
     qormentityinstancecache.h \
     qormentitylistmodel.h \
@@ -19,10 +20,12 @@ PUBLIC_HEADERS += \
     qormpropertymapping.h \
     qormquery.h \
     qormquerybuilder.h \
+    qormquerycursor.h \
     qormqueryresult.h \
     qormrelation.h \
     qormsession.h \
     qormsessionconfiguration.h \
+    qormsessionnotifier.h \
     qormsqliteconfiguration.h \
     qormsqliteprovider.h \
     qormtransactiontoken.h \
@@ -34,6 +37,7 @@ PRIVATE_HEADERS = \
 
 SOURCES += \
     qormabstractprovider.cpp \
+    qormaggregate.cpp \
     qormclassproperty.cpp \
     qormentityinstancecache.cpp \
     qormentitylistmodel.cpp \
@@ -52,6 +56,7 @@ SOURCES += \
     qormrelation.cpp \
     qormsession.cpp \
     qormsessionconfiguration.cpp \
+    qormsessionnotifier.cpp \
     qormsqliteconfiguration.cpp \
     qormsqliteprovider.cpp \
     qormsqlitestatementgenerator_p.cpp \
@@ -19,9 +19,45 @@
  */
 
 #include "qormabstractprovider.h"
+#include "qormerror.h"
 
 QT_BEGIN_NAMESPACE
 
+namespace
+{
+    class QOrmQueryResultCursor : public QOrmAbstractCursor
+    {
+    public:
+        explicit QOrmQueryResultCursor(QOrmQueryResult<QObject> result)
+            : m_result{std::move(result)}
+        {
+        }
+
+        QObject* next() override
+        {
+            if (m_result.hasError() || m_position >= m_result.toVector().size())
+                return nullptr;
+
+            return m_result.toVector()[m_position++];
+        }
+
+        QOrmError error() const override { return m_result.error(); }
+
+    private:
+        QOrmQueryResult<QObject> m_result;
+        int m_position{0};
+    };
+} // namespace
+
+QOrmAbstractCursor::~QOrmAbstractCursor() = default;
+
 QOrmAbstractProvider::~QOrmAbstractProvider() = default;
 
+std::unique_ptr<QOrmAbstractCursor> QOrmAbstractProvider::openCursor(
+    const QOrmQuery& query,
+    QOrmEntityInstanceCache& entityInstanceCache)
+{
+    return std::make_unique<QOrmQueryResultCursor>(execute(query, entityInstanceCache));
+}
+
 QT_END_NAMESPACE
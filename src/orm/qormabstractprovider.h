@@ -24,6 +24,8 @@
 #include <QtOrm/qormglobal.h>
 #include <QtOrm/qormqueryresult.h>
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 class QObject;
@@ -32,6 +34,18 @@ class QOrmError;
 class QOrmMetadataCache;
 class QOrmQuery;
 
+// A forward-only result of a read query. The entity instances are read from the backend as the
+// consumer advances.
+class Q_ORM_EXPORT QOrmAbstractCursor
+{
+public:
+    virtual ~QOrmAbstractCursor();
+
+    // Returns the next entity instance, or nullptr at the end of the result or on error.
+    [[nodiscard]] virtual QObject* next() = 0;
+    [[nodiscard]] virtual QOrmError error() const = 0;
+};
+
 class Q_ORM_EXPORT QOrmAbstractProvider
 {
 public:
@@ -48,6 +62,12 @@ public:
     virtual QOrmQueryResult<QObject> execute(const QOrmQuery& query,
                                              QOrmEntityInstanceCache& entityInstanceCache) = 0;
 
+    // Opens a cursor for a read query. The default implementation executes the query and iterates
+    // over its result.
+    [[nodiscard]] virtual std::unique_ptr<QOrmAbstractCursor> openCursor(
+        const QOrmQuery& query,
+        QOrmEntityInstanceCache& entityInstanceCache);
+
     [[nodiscard]] virtual int capabilities() const = 0;
 };
 
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2019-2022 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qormaggregate.h"
+
+#include <QDebug>
+
+QT_BEGIN_NAMESPACE
+
+QDebug operator<<(QDebug dbg, const QOrmAggregate& aggregate)
+{
+    QDebugStateSaver saver{dbg};
+    dbg.noquote().nospace() << "QOrmAggregate(" << aggregate.function();
+
+    if (aggregate.mapping() != nullptr)
+        dbg << ", " << aggregate.mapping()->classPropertyName();
+    else if (aggregate.classProperty() != nullptr)
+        dbg << ", " << aggregate.classProperty()->descriptor();
+
+    dbg << ")";
+    return dbg;
+}
+
+QT_END_NAMESPACE
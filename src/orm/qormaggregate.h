@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2019-2022 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QORMAGGREGATE_H
+#define QORMAGGREGATE_H
+
+#include <QtOrm/qormclassproperty.h>
+#include <QtOrm/qormglobal.h>
+#include <QtOrm/qormpropertymapping.h>
+
+#include <optional>
+#include <variant>
+
+QT_BEGIN_NAMESPACE
+
+// An aggregate column of a query. Without a property, COUNT(*) is computed. Like filter
+// expressions, aggregates are declared with class properties and resolved to property mappings
+// when the query is built.
+class Q_ORM_EXPORT QOrmAggregate
+{
+public:
+    using AggregateProperty = std::variant<QOrmClassProperty, QOrmPropertyMapping>;
+
+    explicit QOrmAggregate(QOrm::AggregateFunction function)
+        : m_function{function}
+    {
+    }
+
+    QOrmAggregate(QOrm::AggregateFunction function, AggregateProperty aggregateProperty)
+        : m_function{function}
+        , m_aggregateProperty{std::move(aggregateProperty)}
+    {
+    }
+
+    QOrm::AggregateFunction function() const { return m_function; }
+
+    bool hasProperty() const { return m_aggregateProperty.has_value(); }
+    bool isResolved() const
+    {
+        return !hasProperty() ||
+               std::holds_alternative<QOrmPropertyMapping>(*m_aggregateProperty);
+    }
+
+    const QOrmClassProperty* classProperty() const
+    {
+        return hasProperty() ? std::get_if<QOrmClassProperty>(&*m_aggregateProperty) : nullptr;
+    }
+
+    const QOrmPropertyMapping* mapping() const
+    {
+        return hasProperty() ? std::get_if<QOrmPropertyMapping>(&*m_aggregateProperty) : nullptr;
+    }
+
+private:
+    QOrm::AggregateFunction m_function{QOrm::AggregateFunction::Count};
+    std::optional<AggregateProperty> m_aggregateProperty;
+};
+
+Q_ORM_EXPORT QDebug operator<<(QDebug debug, const QOrmAggregate& aggregate);
+
+QT_END_NAMESPACE
+
+#endif
@@ -54,4 +54,29 @@ QOrmFilterExpression QOrmClassProperty::notContains(const QVariant& value) const
     return QOrmFilterTerminalPredicate{*this, QOrm::Comparison::NotContains, value};
 }
 
+QOrmFilterExpression QOrmClassProperty::between(const QVariant& lower, const QVariant& upper) const
+{
+    return QOrmFilterTerminalPredicate{*this,
+                                       QOrm::Comparison::Between,
+                                       QVariantList{lower, upper}};
+}
+
+QOrmFilterExpression QOrmClassProperty::notBetween(const QVariant& lower,
+                                                   const QVariant& upper) const
+{
+    return QOrmFilterTerminalPredicate{*this,
+                                       QOrm::Comparison::NotBetween,
+                                       QVariantList{lower, upper}};
+}
+
+QOrmFilterExpression QOrmClassProperty::startsWith(const QString& prefix) const
+{
+    return QOrmFilterTerminalPredicate{*this, QOrm::Comparison::StartsWith, prefix};
+}
+
+QOrmFilterExpression QOrmClassProperty::equalsIgnoringCase(const QString& value) const
+{
+    return QOrmFilterTerminalPredicate{*this, QOrm::Comparison::EqualIgnoringCase, value};
+}
+
 QT_END_NAMESPACE
@@ -39,6 +39,14 @@ public:
     QOrmFilterExpression contains(const QVariant& value) const;
     QOrmFilterExpression notContains(const QVariant& value) const;
 
+    // lower <= property <= upper; also suitable for date and time ranges
+    QOrmFilterExpression between(const QVariant& lower, const QVariant& upper) const;
+    QOrmFilterExpression notBetween(const QVariant& lower, const QVariant& upper) const;
+    // case-sensitive prefix match that can use an index of the column
+    QOrmFilterExpression startsWith(const QString& prefix) const;
+    // case-insensitive for ASCII characters only
+    QOrmFilterExpression equalsIgnoringCase(const QString& value) const;
+
 private:
     QString m_descriptor;
 };
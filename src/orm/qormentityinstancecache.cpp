@@ -22,10 +22,16 @@
 #include "qormglobal_p.h"
 #include "qormmetadata.h"
 
-#include <QMap>
+#include <QHash>
+#include <QMetaMethod>
 #include <QMetaProperty>
 #include <QSet>
 #include <QVariant>
+#include <QVector>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 
@@ -34,29 +40,513 @@ class QOrmEntityInstanceCachePrivate : public QObject
     Q_OBJECT        
 
     friend class QOrmEntityInstanceCache;
-    using ObjectId = QPair<QString, QVariant>;
+    using ObjectId = QPair<const QMetaObject*, QVariant>;
+
+    // Instances of one entity by object ID. Integral object IDs are hashed as integers, so that
+    // IDs read from the database compare equal to the property values whatever their integral
+    // type; all other object IDs are hashed by their string representation.
+    struct IdentityMap
+    {
+        QHash<qint64, QObject*> byIntegralId;
+        QHash<QString, QObject*> byStringId;
+    };
+
+    [[nodiscard]] static bool toIntegralId(const QVariant& objectId, qint64& integralId);
+
+    struct Entry
+    {
+        ObjectId objectId;
+        // trim generation of the last access
+        quint64 lastUsed{0};
+    };
+
+    // Data shared by the cached instances of one entity
+    struct EntityInfo
+    {
+        QOrmMetadata metadata;
+        // distinct NOTIFY signals of the mapped properties
+        QVector<QMetaMethod> notifySignals;
+        // names of the mapped properties by the method index of their NOTIFY signal
+        QHash<int, QVector<QString>> propertiesBySignal;
+        // mapped properties without NOTIFY signal, written whenever the instance is modified
+        QSet<QString> unnotifiedProperties;
+    };
+
+    [[nodiscard]] QObject* find(const QMetaObject* qMetaObject, const QVariant& objectId) const;
+    void insert(const ObjectId& objectId, QObject* instance);
+    void remove(const ObjectId& objectId);
+    void touch(const QObject* instance);
+    [[nodiscard]] const EntityInfo& entityInfo(const QOrmMetadata& metadata);
+    [[nodiscard]] const EntityInfo& entityInfoOf(const QObject* instance) const;
+    [[nodiscard]] const QOrmMetadata& metadataOf(const QObject* instance) const;
+
+    [[nodiscard]] static QVariant snapshotValue(const QObject* instance,
+                                                const QOrmPropertyMapping& mapping);
+    void takeSnapshot(const QObject* instance);
+    void updateSnapshot(const QObject* instance, size_t mappingIndex);
+    [[nodiscard]] bool isModified(const QObject* instance) const;
+    [[nodiscard]] QSet<QString> modifiedProperties(const QObject* instance) const;
+    void removeAssignedUnfetched(const QObject* instance);
+    void collectReferences(const QObject* instance, QSet<const QObject*>& referenced) const;
+    void collectReferences(const QObject* instance,
+                           const QOrmMetadata& metadata,
+                           QSet<const QObject*>& referenced) const;
+    [[nodiscard]] QVector<QObject*> evictable(const QVector<QObject*>& candidates,
+                                              int maxCount) const;
+    void detachReferences(QObject* instance, const QSet<const QObject*>& evicted);
 
 private slots:
     void onEntityInstanceChanged();
 
 private:
-    QHash<QObject*, ObjectId> m_cache;
-    QMap<ObjectId, QObject*> m_byObjectId;
-    QSet<const QObject*> m_modifiedInstances;    
+    QHash<QObject*, Entry> m_cache;
+    QHash<const QMetaObject*, IdentityMap> m_byObjectId;
+    QHash<const QMetaObject*, EntityInfo> m_entities;
+    QOrm::ChangeTracking m_changeTracking{QOrm::ChangeTracking::NotifySignals};
+    // ChangeTracking::NotifySignals: properties of the instances which emitted a NOTIFY signal
+    QHash<const QObject*, QSet<QString>> m_modifiedProperties;
+    // ChangeTracking::Snapshots: mapped property values when the instance was last synchronized
+    QHash<const QObject*, std::vector<QVariant>> m_snapshots;
+    QHash<const QObject*, QHash<QString, QVariant>> m_unfetchedProperties;
+    // pin counts of the instances which must not be evicted
+    QHash<const QObject*, int> m_pins;
+    // offsets into m_insertions where the nested recordings started
+    QVector<int> m_recordingStarts;
+    QVector<QObject*> m_insertions;
+
+    int m_maxSize{0};
+    quint64 m_generation{0};
+    qint64 m_hits{0};
+    qint64 m_misses{0};
+    qint64 m_evictions{0};
 };
 
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-inline bool operator<(const QVariant& lhs, const QVariant& rhs)
+bool QOrmEntityInstanceCachePrivate::toIntegralId(const QVariant& objectId, qint64& integralId)
+{
+    switch (static_cast<QMetaType::Type>(objectId.userType()))
+    {
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::Long:
+        case QMetaType::ULong:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+        case QMetaType::Short:
+        case QMetaType::UShort:
+            integralId = objectId.toLongLong();
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+QObject* QOrmEntityInstanceCachePrivate::find(const QMetaObject* qMetaObject,
+                                              const QVariant& objectId) const
+{
+    auto identityMap = m_byObjectId.constFind(qMetaObject);
+
+    if (identityMap == std::cend(m_byObjectId))
+        return nullptr;
+
+    qint64 integralId = 0;
+
+    return toIntegralId(objectId, integralId)
+               ? identityMap->byIntegralId.value(integralId, nullptr)
+               : identityMap->byStringId.value(objectId.toString(), nullptr);
+}
+
+void QOrmEntityInstanceCachePrivate::insert(const ObjectId& objectId, QObject* instance)
+{
+    IdentityMap& identityMap = m_byObjectId[objectId.first];
+    qint64 integralId = 0;
+
+    if (toIntegralId(objectId.second, integralId))
+        identityMap.byIntegralId.insert(integralId, instance);
+    else
+        identityMap.byStringId.insert(objectId.second.toString(), instance);
+}
+
+void QOrmEntityInstanceCachePrivate::remove(const ObjectId& objectId)
+{
+    auto identityMap = m_byObjectId.find(objectId.first);
+
+    if (identityMap == std::end(m_byObjectId))
+        return;
+
+    qint64 integralId = 0;
+
+    if (toIntegralId(objectId.second, integralId))
+        identityMap->byIntegralId.remove(integralId);
+    else
+        identityMap->byStringId.remove(objectId.second.toString());
+}
+
+void QOrmEntityInstanceCachePrivate::touch(const QObject* instance)
+{
+    auto entry = m_cache.find(const_cast<QObject*>(instance));
+
+    if (entry != std::end(m_cache))
+        entry->lastUsed = m_generation;
+}
+
+auto QOrmEntityInstanceCachePrivate::entityInfo(const QOrmMetadata& metadata) -> const EntityInfo&
+{
+    auto info = m_entities.find(&metadata.qMetaObject());
+
+    if (info != std::end(m_entities))
+        return *info;
+
+    info = m_entities.insert(&metadata.qMetaObject(), {metadata, {}, {}});
+
+    for (const QOrmPropertyMapping& mapping : metadata.propertyMappings())
+    {
+        if (mapping.isTransient() && !mapping.isReference())
+            continue;
+
+        QMetaProperty property = mapping.qMetaProperty();
+
+        if (!property.hasNotifySignal())
+        {
+            info->unnotifiedProperties.insert(mapping.classPropertyName());
+            continue;
+        }
+
+        QVector<QString>& properties = info->propertiesBySignal[property.notifySignalIndex()];
+
+        if (properties.isEmpty())
+            info->notifySignals.push_back(property.notifySignal());
+
+        properties.push_back(mapping.classPropertyName());
+    }
+
+    return *info;
+}
+
+auto QOrmEntityInstanceCachePrivate::entityInfoOf(const QObject* instance) const
+    -> const EntityInfo&
+{
+    auto entry = m_cache.find(const_cast<QObject*>(instance));
+    Q_ASSERT(entry != std::end(m_cache));
+
+    auto info = m_entities.find(entry->objectId.first);
+    Q_ASSERT(info != std::end(m_entities));
+
+    return *info;
+}
+
+const QOrmMetadata& QOrmEntityInstanceCachePrivate::metadataOf(const QObject* instance) const
+{
+    return entityInfoOf(instance).metadata;
+}
+
+// References are compared by identity, not by the values of the referenced instances.
+QVariant QOrmEntityInstanceCachePrivate::snapshotValue(const QObject* instance,
+                                                       const QOrmPropertyMapping& mapping)
+{
+    if (mapping.isTransient() && !mapping.isReference())
+        return {};
+
+    QVariant value = QOrmPrivate::propertyValue(instance, mapping);
+
+    if (!mapping.isReference())
+        return value;
+
+    auto address = [](const QObject* o) {
+        return QVariant{static_cast<qulonglong>(reinterpret_cast<quintptr>(o))};
+    };
+
+    if (!mapping.isTransient())
+        return address(value.value<QObject*>());
+
+    QVariantList addresses;
+
+    for (const QObject* child : value.value<QVector<QObject*>>())
+        addresses.push_back(address(child));
+
+    return addresses;
+}
+
+void QOrmEntityInstanceCachePrivate::takeSnapshot(const QObject* instance)
+{
+    const std::vector<QOrmPropertyMapping>& mappings = metadataOf(instance).propertyMappings();
+    std::vector<QVariant>& snapshot = m_snapshots[instance];
+
+    snapshot.resize(mappings.size());
+
+    for (size_t i = 0; i < mappings.size(); ++i)
+        snapshot[i] = snapshotValue(instance, mappings[i]);
+}
+
+void QOrmEntityInstanceCachePrivate::updateSnapshot(const QObject* instance, size_t mappingIndex)
+{
+    auto snapshot = m_snapshots.find(instance);
+
+    if (snapshot == std::end(m_snapshots))
+        return;
+
+    const std::vector<QOrmPropertyMapping>& mappings = metadataOf(instance).propertyMappings();
+    Q_ASSERT(mappingIndex < mappings.size());
+
+    (*snapshot)[mappingIndex] = snapshotValue(instance, mappings[mappingIndex]);
+}
+
+bool QOrmEntityInstanceCachePrivate::isModified(const QObject* instance) const
 {
-    QPartialOrdering ordering = QVariant::compare(lhs, rhs);
-    return ordering == QPartialOrdering::Less;
+    if (m_changeTracking == QOrm::ChangeTracking::NotifySignals)
+        return m_modifiedProperties.contains(instance);
+
+    auto snapshot = m_snapshots.find(instance);
+
+    if (snapshot == std::end(m_snapshots))
+        return false;
+
+    const std::vector<QOrmPropertyMapping>& mappings = metadataOf(instance).propertyMappings();
+
+    for (size_t i = 0; i < mappings.size(); ++i)
+    {
+        if ((*snapshot)[i] != snapshotValue(instance, mappings[i]))
+            return true;
+    }
+
+    return false;
+}
+
+QSet<QString> QOrmEntityInstanceCachePrivate::modifiedProperties(const QObject* instance) const
+{
+    QSet<QString> result;
+
+    if (m_changeTracking == QOrm::ChangeTracking::NotifySignals)
+    {
+        auto modified = m_modifiedProperties.find(instance);
+
+        if (modified != std::end(m_modifiedProperties))
+        {
+            result = *modified;
+            result.unite(entityInfoOf(instance).unnotifiedProperties);
+        }
+
+        return result;
+    }
+
+    auto snapshot = m_snapshots.find(instance);
+
+    if (snapshot == std::end(m_snapshots))
+        return result;
+
+    const std::vector<QOrmPropertyMapping>& mappings = metadataOf(instance).propertyMappings();
+
+    for (size_t i = 0; i < mappings.size(); ++i)
+    {
+        if ((*snapshot)[i] != snapshotValue(instance, mappings[i]))
+            result.insert(mappings[i].classPropertyName());
+    }
+
+    return result;
+}
+
+// With snapshots, assignments to unfetched properties are only detected by comparison. As with
+// NOTIFY signals, an unfetched property that has been assigned is considered fetched.
+void QOrmEntityInstanceCachePrivate::removeAssignedUnfetched(const QObject* instance)
+{
+    if (m_changeTracking != QOrm::ChangeTracking::Snapshots)
+        return;
+
+    auto unfetched = m_unfetchedProperties.find(instance);
+    auto snapshot = m_snapshots.find(instance);
+
+    if (unfetched == std::end(m_unfetchedProperties) || snapshot == std::end(m_snapshots))
+        return;
+
+    const std::vector<QOrmPropertyMapping>& mappings = metadataOf(instance).propertyMappings();
+
+    for (size_t i = 0; i < mappings.size(); ++i)
+    {
+        if (unfetched->contains(mappings[i].classPropertyName()) &&
+            (*snapshot)[i] != snapshotValue(instance, mappings[i]))
+        {
+            unfetched->remove(mappings[i].classPropertyName());
+        }
+    }
+
+    if (unfetched->isEmpty())
+        m_unfetchedProperties.erase(unfetched);
+}
+
+// Collects the fetched many-to-one and one-to-many references of an instance.
+void QOrmEntityInstanceCachePrivate::collectReferences(const QObject* instance,
+                                                       QSet<const QObject*>& referenced) const
+{
+    collectReferences(instance, metadataOf(instance), referenced);
+}
+
+void QOrmEntityInstanceCachePrivate::collectReferences(const QObject* instance,
+                                                       const QOrmMetadata& metadata,
+                                                       QSet<const QObject*>& referenced) const
+{
+    const QHash<QString, QVariant> unfetched = m_unfetchedProperties.value(instance);
+
+    for (const QOrmPropertyMapping& mapping : metadata.propertyMappings())
+    {
+        if (!mapping.isReference() || unfetched.contains(mapping.classPropertyName()))
+            continue;
+
+        QVariant value = QOrmPrivate::propertyValue(instance, mapping);
+
+        if (mapping.isTransient())
+        {
+            for (const QObject* child : value.value<QVector<QObject*>>())
+                referenced.insert(child);
+        }
+        else
+        {
+            referenced.insert(value.value<QObject*>());
+        }
+    }
+}
+
+// Up to maxCount of the candidates, in their order, which are not in use: pinned instances, the
+// instances they reference, and modified instances are kept. The references of modified instances
+// are unsaved changes as well: the instances they reference are kept, at the price of evicting
+// fewer instances.
+QVector<QObject*> QOrmEntityInstanceCachePrivate::evictable(const QVector<QObject*>& candidates,
+                                                            int maxCount) const
+{
+    QSet<const QObject*> retained;
+
+    for (auto it = std::cbegin(m_pins); it != std::cend(m_pins); ++it)
+    {
+        retained.insert(it.key());
+
+        if (m_cache.contains(const_cast<QObject*>(it.key())))
+            collectReferences(it.key(), retained);
+    }
+
+    // With snapshots, telling whether an instance is modified compares all of its properties, so
+    // only the candidates needed are checked instead of the whole cache.
+    QSet<const QObject*> evicted;
+
+    for (QObject* candidate : candidates)
+    {
+        if (evicted.size() == maxCount)
+            break;
+
+        if (!retained.contains(candidate) && !isModified(candidate))
+            evicted.insert(candidate);
+    }
+
+    QSet<const QObject*> referenced;
+
+    for (auto it = std::cbegin(m_cache); it != std::cend(m_cache) && !evicted.isEmpty(); ++it)
+    {
+        if (evicted.contains(it.key()))
+            continue;
+
+        referenced.clear();
+        collectReferences(it.key(), referenced);
+
+        if (referenced.intersects(evicted) && isModified(it.key()))
+            evicted.subtract(referenced);
+    }
+
+    QVector<QObject*> instances;
+    instances.reserve(evicted.size());
+
+    for (QObject* candidate : candidates)
+    {
+        if (evicted.contains(candidate))
+            instances.push_back(candidate);
+    }
+
+    return instances;
+}
+
+// Replaces the references of an instance to evicted instances with unfetched properties, which
+// can be loaded again with QOrmSession::load().
+void QOrmEntityInstanceCachePrivate::detachReferences(QObject* instance,
+                                                      const QSet<const QObject*>& evicted)
+{
+    const QOrmMetadata& metadata = metadataOf(instance);
+    const std::vector<QOrmPropertyMapping>& mappings = metadata.propertyMappings();
+
+    for (size_t i = 0; i < mappings.size(); ++i)
+    {
+        const QOrmPropertyMapping& mapping = mappings[i];
+
+        if (!mapping.isReference() ||
+            m_unfetchedProperties.value(instance).contains(mapping.classPropertyName()))
+        {
+            continue;
+        }
+
+        QVariant value = QOrmPrivate::propertyValue(instance, mapping);
+        QVariant key;
+
+        if (mapping.isTransient())
+        {
+            const QVector<QObject*> children = value.value<QVector<QObject*>>();
+
+            if (std::none_of(std::cbegin(children),
+                             std::cend(children),
+                             [&evicted](const QObject* child) { return evicted.contains(child); }))
+            {
+                continue;
+            }
+
+            key = QOrmPrivate::objectIdPropertyValue(instance, metadata);
+            value = QOrmPrivate::referenceCollectionValue(mapping, {});
+        }
+        else
+        {
+            const QObject* referencedInstance = value.value<QObject*>();
+
+            if (!evicted.contains(referencedInstance))
+                continue;
+
+            key = QOrmPrivate::objectIdPropertyValue(referencedInstance,
+                                                     *mapping.referencedEntity());
+            value = QVariant::fromValue<QObject*>(nullptr);
+        }
+
+        const QSet<QString> modifiedProperties = m_modifiedProperties.value(instance);
+
+        if (!QOrmPrivate::setPropertyValue(instance, mapping, value))
+            Q_ORM_UNEXPECTED_STATE;
+
+        // after the assignment, which marks the property as fetched
+        m_unfetchedProperties[instance].insert(mapping.classPropertyName(), key);
+
+        if (m_changeTracking == QOrm::ChangeTracking::Snapshots)
+            updateSnapshot(instance, i);
+        else if (modifiedProperties.isEmpty())
+            m_modifiedProperties.remove(instance);
+        else
+            m_modifiedProperties.insert(instance, modifiedProperties);
+    }
 }
-#endif
 
 void QOrmEntityInstanceCachePrivate::onEntityInstanceChanged()
 {
     Q_ASSERT(m_cache.contains(sender()));
-    m_modifiedInstances.insert(sender());
+
+    const QVector<QString> properties =
+        entityInfoOf(sender()).propertiesBySignal.value(senderSignalIndex());
+    QSet<QString>& modifiedProperties = m_modifiedProperties[sender()];
+
+    for (const QString& propertyName : properties)
+        modifiedProperties.insert(propertyName);
+
+    // an unfetched property that has been assigned is considered fetched
+    auto unfetched = m_unfetchedProperties.find(sender());
+
+    if (unfetched != std::end(m_unfetchedProperties))
+    {
+        for (const QString& propertyName : properties)
+            unfetched->remove(propertyName);
+
+        if (unfetched->isEmpty())
+            m_unfetchedProperties.erase(unfetched);
+    }
 }
 
 QOrmEntityInstanceCache::QOrmEntityInstanceCache()
@@ -66,18 +556,28 @@ QOrmEntityInstanceCache::QOrmEntityInstanceCache()
 
 QOrmEntityInstanceCache::~QOrmEntityInstanceCache()
 {
+    // deleting an instance removes its connections
     for (auto it = std::begin(d->m_cache); it != std::end(d->m_cache); ++it)
-    {
-        it.key()->disconnect(d.get());
         delete it.key();
-    }
 
     d->m_cache.clear();
 }
 
 QObject* QOrmEntityInstanceCache::get(const QOrmMetadata& meta, const QVariant& objectId)
 {
-    return d->m_byObjectId.value(qMakePair(meta.className(), objectId), nullptr);
+    QObject* instance = d->find(&meta.qMetaObject(), objectId);
+
+    if (instance != nullptr)
+    {
+        ++d->m_hits;
+        d->touch(instance);
+    }
+    else
+    {
+        ++d->m_misses;
+    }
+
+    return instance;
 }
 
 bool QOrmEntityInstanceCache::contains(const QObject* instance) const
@@ -93,17 +593,25 @@ void QOrmEntityInstanceCache::insert(const QOrmMetadata& metadata, QObject* inst
     if (d->m_cache.contains(instance))
         return;
 
-    auto objectId =
-        qMakePair(metadata.className(), QOrmPrivate::objectIdPropertyValue(instance, metadata));
+    auto objectId = qMakePair(&metadata.qMetaObject(),
+                              QOrmPrivate::objectIdPropertyValue(instance, metadata));
+
+    d->m_cache.insert(instance, {objectId, d->m_generation});
+    d->insert(objectId, instance);
 
-    d->m_cache.insert(instance, objectId);
-    d->m_byObjectId.insert(objectId, instance);
+    if (!d->m_recordingStarts.isEmpty())
+        d->m_insertions.push_back(instance);
 }
 
 QObject* QOrmEntityInstanceCache::take(QObject* instance)
 {
-    d->m_byObjectId.remove(d->m_cache[instance]);
-    d->m_modifiedInstances.remove(instance);
+    if (d->m_changeTracking == QOrm::ChangeTracking::NotifySignals)
+        instance->disconnect(d.data());
+
+    d->remove(d->m_cache.value(instance).objectId);
+    d->m_modifiedProperties.remove(instance);
+    d->m_snapshots.remove(instance);
+    d->m_unfetchedProperties.remove(instance);
     d->m_cache.remove(instance);
 
     return instance;
@@ -111,29 +619,324 @@ QObject* QOrmEntityInstanceCache::take(QObject* instance)
 
 void QOrmEntityInstanceCache::finalize(const QOrmMetadata& metadata, QObject* instance)
 {
-    for (const QOrmPropertyMapping& mapping : metadata.propertyMappings())
-    {
-        if (mapping.isTransient() && !mapping.isReference())
-            continue;
+    Q_ASSERT(d->m_cache.contains(instance));
 
-        // connect to NOTIFY signals of the entity to mark the instance dirty on any change
-        QMetaMethod notifySignal = mapping.qMetaProperty().notifySignal();
-        int slotIndex = QOrmEntityInstanceCachePrivate::staticMetaObject.indexOfSlot(
-            "onEntityInstanceChanged()");
-        QMetaMethod slot = QOrmEntityInstanceCachePrivate::staticMetaObject.method(slotIndex);
+    const QOrmEntityInstanceCachePrivate::EntityInfo& info = d->entityInfo(metadata);
 
-        QObject::connect(instance, notifySignal, d.get(), slot);
+    if (d->m_changeTracking == QOrm::ChangeTracking::Snapshots)
+    {
+        d->takeSnapshot(instance);
+        return;
     }
+
+    static const QMetaMethod slot = QOrmEntityInstanceCachePrivate::staticMetaObject.method(
+        QOrmEntityInstanceCachePrivate::staticMetaObject.indexOfSlot(
+            "onEntityInstanceChanged()"));
+
+    // connect to NOTIFY signals of the entity to mark the instance dirty on any change
+    for (const QMetaMethod& notifySignal : info.notifySignals)
+        QObject::connect(instance, notifySignal, d.data(), slot);
 }
 
 bool QOrmEntityInstanceCache::isModified(const QObject* instance) const
 {
-    return d->m_modifiedInstances.contains(instance);
+    return d->isModified(instance);
+}
+
+QSet<QString> QOrmEntityInstanceCache::modifiedProperties(const QObject* instance) const
+{
+    return d->modifiedProperties(instance);
 }
 
 void QOrmEntityInstanceCache::markUnmodified(const QObject* instance) const
 {
-    d->m_modifiedInstances.remove(instance);
+    if (d->m_changeTracking == QOrm::ChangeTracking::Snapshots)
+    {
+        if (d->m_snapshots.contains(instance))
+            d->takeSnapshot(instance);
+    }
+    else
+    {
+        d->m_modifiedProperties.remove(instance);
+    }
+
+    d->touch(instance);
+}
+
+void QOrmEntityInstanceCache::markUnfetched(const QObject* instance,
+                                            const QString& propertyName,
+                                            const QVariant& key)
+{
+    d->m_unfetchedProperties[instance].insert(propertyName, key);
+}
+
+void QOrmEntityInstanceCache::markFetched(const QObject* instance, const QString& propertyName)
+{
+    // the value has been read from the database and is not a change
+    if (d->m_changeTracking == QOrm::ChangeTracking::Snapshots && d->m_snapshots.contains(instance))
+    {
+        const std::vector<QOrmPropertyMapping>& mappings =
+            d->metadataOf(instance).propertyMappings();
+
+        for (size_t i = 0; i < mappings.size(); ++i)
+        {
+            if (mappings[i].classPropertyName() == propertyName)
+            {
+                d->updateSnapshot(instance, i);
+                break;
+            }
+        }
+    }
+    else if (auto modified = d->m_modifiedProperties.find(instance);
+             modified != std::end(d->m_modifiedProperties))
+    {
+        modified->remove(propertyName);
+
+        if (modified->isEmpty())
+            d->m_modifiedProperties.erase(modified);
+    }
+
+    auto unfetched = d->m_unfetchedProperties.find(instance);
+
+    if (unfetched == std::end(d->m_unfetchedProperties))
+        return;
+
+    unfetched->remove(propertyName);
+
+    if (unfetched->isEmpty())
+        d->m_unfetchedProperties.erase(unfetched);
+}
+
+bool QOrmEntityInstanceCache::isFetched(const QObject* instance,
+                                        const QString& propertyName) const
+{
+    d->removeAssignedUnfetched(instance);
+
+    return !d->m_unfetchedProperties.value(instance).contains(propertyName);
+}
+
+QVariant QOrmEntityInstanceCache::unfetchedKey(const QObject* instance,
+                                               const QString& propertyName) const
+{
+    d->removeAssignedUnfetched(instance);
+
+    return d->m_unfetchedProperties.value(instance).value(propertyName);
+}
+
+QSet<QString> QOrmEntityInstanceCache::unfetchedProperties(const QObject* instance) const
+{
+    d->removeAssignedUnfetched(instance);
+
+    QSet<QString> result;
+    const QHash<QString, QVariant> unfetched = d->m_unfetchedProperties.value(instance);
+
+    for (auto it = std::cbegin(unfetched); it != std::cend(unfetched); ++it)
+        result.insert(it.key());
+
+    return result;
+}
+
+int QOrmEntityInstanceCache::maxSize() const
+{
+    return d->m_maxSize;
+}
+
+void QOrmEntityInstanceCache::setMaxSize(int maxSize)
+{
+    d->m_maxSize = maxSize;
+}
+
+void QOrmEntityInstanceCache::trim()
+{
+    quint64 generation = d->m_generation++;
+
+    if (d->m_maxSize <= 0 || d->m_cache.size() <= d->m_maxSize)
+        return;
+
+    // Evict down to 90% of the maximum size, so that the scan of the whole cache is not repeated
+    // for every instance read afterwards.
+    int targetSize = d->m_maxSize - d->m_maxSize / 10;
+
+    std::vector<std::pair<quint64, QObject*>> lastUses;
+
+    for (auto it = std::cbegin(d->m_cache); it != std::cend(d->m_cache); ++it)
+    {
+        if (it->lastUsed != generation)
+            lastUses.emplace_back(it->lastUsed, it.key());
+    }
+
+    // least recently used first
+    std::sort(std::begin(lastUses), std::end(lastUses));
+
+    QVector<QObject*> candidates;
+    candidates.reserve(static_cast<int>(lastUses.size()));
+
+    for (const auto& lastUse : lastUses)
+        candidates.push_back(lastUse.second);
+
+    QVector<QObject*> instances = d->evictable(candidates, d->m_cache.size() - targetSize);
+
+    evict(instances);
+
+    d->m_evictions += instances.size();
+}
+
+void QOrmEntityInstanceCache::pin(const QObject* instance)
+{
+    ++d->m_pins[instance];
+}
+
+void QOrmEntityInstanceCache::unpin(const QObject* instance)
+{
+    auto it = d->m_pins.find(instance);
+
+    if (it == std::end(d->m_pins))
+        return;
+
+    if (--*it == 0)
+        d->m_pins.erase(it);
+}
+
+void QOrmEntityInstanceCache::evict(const QVector<QObject*>& instances)
+{
+    if (instances.isEmpty())
+        return;
+
+    QSet<const QObject*> evicted;
+
+    for (const QObject* instance : instances)
+        evicted.insert(instance);
+
+    for (auto it = std::begin(d->m_cache); it != std::end(d->m_cache); ++it)
+    {
+        if (!evicted.contains(it.key()))
+            d->detachReferences(it.key(), evicted);
+    }
+
+    for (QObject* instance : instances)
+    {
+        delete take(instance);
+    }
+}
+
+void QOrmEntityInstanceCache::evictUnused(const QVector<QObject*>& instances)
+{
+    QVector<QObject*> candidates;
+    candidates.reserve(instances.size());
+
+    for (QObject* instance : instances)
+    {
+        if (d->m_cache.contains(instance))
+            candidates.push_back(instance);
+    }
+
+    evict(d->evictable(candidates, candidates.size()));
+}
+
+void QOrmEntityInstanceCache::evictUnreachable(const QVector<QObject*>& instances,
+                                               const QOrmMetadata& rootMetadata,
+                                               const QVector<QObject*>& roots)
+{
+    QSet<const QObject*> unreached;
+
+    for (QObject* instance : instances)
+    {
+        if (d->m_cache.contains(instance))
+            unreached.insert(instance);
+    }
+
+    QVector<const QObject*> reached;
+    QSet<const QObject*> referenced;
+
+    for (const QObject* root : roots)
+    {
+        unreached.remove(root);
+        d->collectReferences(root, rootMetadata, referenced);
+    }
+
+    // breadth-first through the references among the instances
+    while (!referenced.isEmpty() && !unreached.isEmpty())
+    {
+        reached.clear();
+
+        for (const QObject* instance : referenced)
+        {
+            if (unreached.remove(instance))
+                reached.push_back(instance);
+        }
+
+        referenced.clear();
+
+        for (const QObject* instance : reached)
+            d->collectReferences(instance, referenced);
+    }
+
+    QVector<QObject*> evicted;
+    evicted.reserve(unreached.size());
+
+    for (QObject* instance : instances)
+    {
+        if (unreached.remove(instance))
+            evicted.push_back(instance);
+    }
+
+    evict(evicted);
+}
+
+void QOrmEntityInstanceCache::beginRecordingInsertions()
+{
+    d->m_recordingStarts.push_back(d->m_insertions.size());
+}
+
+QVector<QObject*> QOrmEntityInstanceCache::endRecordingInsertions()
+{
+    Q_ASSERT(!d->m_recordingStarts.isEmpty());
+
+    int start = d->m_recordingStarts.takeLast();
+
+    // the enclosing recording, if any, keeps the insertions of this one
+    const QVector<QObject*> recorded = d->m_recordingStarts.isEmpty()
+                                           ? std::exchange(d->m_insertions, {})
+                                           : d->m_insertions.mid(start);
+    QVector<QObject*> insertions;
+    QSet<QObject*> seen;
+
+    for (QObject* instance : recorded)
+    {
+        if (d->m_cache.contains(instance) && !seen.contains(instance))
+        {
+            insertions.push_back(instance);
+            seen.insert(instance);
+        }
+    }
+
+    return insertions;
+}
+
+QOrm::ChangeTracking QOrmEntityInstanceCache::changeTracking() const
+{
+    return d->m_changeTracking;
+}
+
+void QOrmEntityInstanceCache::setChangeTracking(QOrm::ChangeTracking changeTracking)
+{
+    Q_ASSERT(d->m_cache.isEmpty());
+    d->m_changeTracking = changeTracking;
+}
+
+qint64 QOrmEntityInstanceCache::hits() const
+{
+    return d->m_hits;
+}
+
+qint64 QOrmEntityInstanceCache::misses() const
+{
+    return d->m_misses;
+}
+
+qint64 QOrmEntityInstanceCache::evictions() const
+{
+    return d->m_evictions;
 }
 
 QT_END_NAMESPACE
@@ -23,6 +23,8 @@
 
 #include <QtCore/qglobal.h>
 #include <QtCore/qscopedpointer.h>
+#include <QtCore/qset.h>
+#include <QtCore/qstring.h>
 #include <QtOrm/qormglobal.h>
 
 QT_BEGIN_NAMESPACE
@@ -45,8 +47,59 @@ public:
 
     void finalize(const QOrmMetadata& metadata, QObject* instance);
     bool isModified(const QObject* instance) const;
+    // Mapped properties assigned since the instance was cached or last marked unmodified
+    [[nodiscard]] QSet<QString> modifiedProperties(const QObject* instance) const;
     void markUnmodified(const QObject* instance) const;
 
+    // Properties declared with FETCH LAZY are not read with their entity instance. The key is the
+    // value needed to load the property later: the foreign key of a many-to-one reference or the
+    // object ID of the instance for a one-to-many reference.
+    void markUnfetched(const QObject* instance, const QString& propertyName, const QVariant& key);
+    void markFetched(const QObject* instance, const QString& propertyName);
+    [[nodiscard]] bool isFetched(const QObject* instance, const QString& propertyName) const;
+    [[nodiscard]] QVariant unfetchedKey(const QObject* instance,
+                                        const QString& propertyName) const;
+    [[nodiscard]] QSet<QString> unfetchedProperties(const QObject* instance) const;
+
+    // Maximum number of cached instances; 0 means unlimited. trim() evicts the least recently used
+    // unmodified instances which were not used since the previous trim(). References of other
+    // instances to an evicted instance become unfetched. Evicted instances are deleted.
+    [[nodiscard]] int maxSize() const;
+    void setMaxSize(int maxSize);
+    void trim();
+    // Pinned instances, e.g. the rows of a model, are never evicted by trim(), nor are the
+    // instances they reference. Pins are counted: an instance pinned twice stays pinned until it
+    // is unpinned twice.
+    void pin(const QObject* instance);
+    void unpin(const QObject* instance);
+    // Removes the instances from the cache and deletes them. References of other instances to them
+    // become unfetched, as with trim().
+    void evict(const QVector<QObject*>& instances);
+    // Evicts those of the instances which trim() could evict: instances which are modified,
+    // pinned or referenced by a pinned or modified instance stay cached.
+    void evictUnused(const QVector<QObject*>& instances);
+
+    // Evicts those of the instances which cannot be reached from the roots, instances of
+    // rootMetadata, through references among the instances, e.g. the instances read only for the
+    // rows which a filter has rejected.
+    void evictUnreachable(const QVector<QObject*>& instances,
+                          const QOrmMetadata& rootMetadata,
+                          const QVector<QObject*>& roots);
+
+    // Records the instances inserted until endRecordingInsertions(), including those read for
+    // references, e.g. to evict everything a query has read. Recordings can be nested: the
+    // enclosing recording includes the insertions of the nested one.
+    void beginRecordingInsertions();
+    [[nodiscard]] QVector<QObject*> endRecordingInsertions();
+
+    // The change tracking mode can only be changed while the cache is empty.
+    [[nodiscard]] QOrm::ChangeTracking changeTracking() const;
+    void setChangeTracking(QOrm::ChangeTracking changeTracking);
+
+    [[nodiscard]] qint64 hits() const;
+    [[nodiscard]] qint64 misses() const;
+    [[nodiscard]] qint64 evictions() const;
+
 private:
     QScopedPointer<QOrmEntityInstanceCachePrivate> d;
 };
@@ -57,4 +57,32 @@ void QOrmEntityListModelBase::setOrder(QVariantList order)
     }
 }
 
+int QOrmEntityListModelBase::pageSize() const
+{
+    return m_pageSize;
+}
+
+void QOrmEntityListModelBase::setPageSize(int pageSize)
+{
+    if (m_pageSize != pageSize)
+    {
+        m_pageSize = pageSize;
+        Q_EMIT pageSizeChanged();
+    }
+}
+
+int QOrmEntityListModelBase::totalCount() const
+{
+    return m_totalCount;
+}
+
+void QOrmEntityListModelBase::setTotalCount(int totalCount)
+{
+    if (m_totalCount != totalCount)
+    {
+        m_totalCount = totalCount;
+        Q_EMIT totalCountChanged();
+    }
+}
+
 QT_END_NAMESPACE
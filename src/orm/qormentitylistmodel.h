@@ -25,10 +25,12 @@
 #include <QtCore/qbytearray.h>
 #include <QtCore/qdebug.h>
 #include <QtCore/qhash.h>
+#include <QtCore/qmetaobject.h>
 #include <QtCore/qvariant.h>
 #include <QtCore/qvector.h>
 
 #include <QtOrm/private/qormglobal_p.h>
+#include <QtOrm/qormentityinstancecache.h>
 #include <QtOrm/qormglobal.h>
 #include <QtOrm/qormmetadata.h>
 #include <QtOrm/qormmetadatacache.h>
@@ -36,6 +38,8 @@
 #include <QtOrm/qormqueryresult.h>
 #include <QtOrm/qormsession.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 class Q_ORM_EXPORT QOrmEntityListModelBase : public QAbstractListModel
@@ -44,6 +48,8 @@ class Q_ORM_EXPORT QOrmEntityListModelBase : public QAbstractListModel
 
     Q_PROPERTY(QVariantMap filter READ filter WRITE setFilter NOTIFY filterChanged)
     Q_PROPERTY(QVariantList order READ order WRITE setOrder NOTIFY orderChanged)
+    Q_PROPERTY(int pageSize READ pageSize WRITE setPageSize NOTIFY pageSizeChanged)
+    Q_PROPERTY(int totalCount READ totalCount NOTIFY totalCountChanged)
 
 public:
     QOrmEntityListModelBase(QObject* parent = nullptr);
@@ -54,6 +60,13 @@ public:
     QVariantList order() const;
     void setOrder(QVariantList order);
 
+    // Number of rows read by read() and by every fetchMore(); 0 reads all rows at once.
+    int pageSize() const;
+    void setPageSize(int pageSize);
+
+    // Number of rows matching the filter, including the rows not fetched yet.
+    int totalCount() const;
+
 public Q_SLOTS:
     virtual QObject* at(int index) const = 0;
     virtual int indexOf(QObject* entityInstance) const = 0;
@@ -68,6 +81,8 @@ Q_SIGNALS:
     void entityInstanceRemoved();
     void filterChanged();
     void orderChanged();    
+    void pageSizeChanged();
+    void totalCountChanged();
 
 protected Q_SLOTS:
     virtual void onFilterChanged() = 0;
@@ -75,8 +90,12 @@ protected Q_SLOTS:
     virtual void readData() = 0;
 
 protected:
+    void setTotalCount(int totalCount);
+
     QVariantMap m_filter;
     QVariantList m_order;
+    int m_pageSize{100};
+    int m_totalCount{0};
 };
 
 template<typename T>
@@ -94,29 +113,25 @@ public:
         for (const QOrmPropertyMapping& propertyMapping :
              m_session.metadataCache()->get<T>().propertyMappings())
         {
-            m_roles.insert(std::make_pair(roleIndex, propertyMapping));
+            QByteArray typeName{propertyMapping.qMetaProperty().typeName()};
+            bool isInstanceList =
+                (typeName.startsWith("QList<") || typeName.startsWith("QVector<")) &&
+                typeName.endsWith("*>");
+
+            m_roles.push_back(Role{propertyMapping.qMetaProperty(), isInstanceList});
             m_roleNames.insert(roleIndex, propertyMapping.classPropertyName().toUtf8());
             roleIndex++;
         }
     }
 
+    ~QOrmEntityListModel() override { unpinRows(); }
+
     QObject* at(int index) const override
     {
         return index >= 0 && index < m_data.size() ? m_data[index] : nullptr;
     }
 
-    int indexOf(QObject* instance) const override
-    {
-        for (int i = 0; i < m_data.size(); ++i)
-        {
-            if (static_cast<void*>(m_data[i]) == static_cast<void*>(instance))
-            {
-                return i;
-            }
-        }
-
-        return -1;
-    }
+    int indexOf(QObject* instance) const override { return m_rows.value(instance, -1); }
 
     QObject* create(QVariantMap properties) override
     {
@@ -146,11 +161,11 @@ public:
                     QObject* referencedInstance = propertyValue.value<QObject*>();
                     auto backReferenceContainer =
                         QOrmPrivate::propertyValue(referencedInstance,
-                                                   backReference->classPropertyName())
+                                                   *backReference)
                             .value<QVector<QObject*>>();
                     backReferenceContainer.push_back(instance);
                     if (!QOrmPrivate::setPropertyValue(referencedInstance,
-                                                       backReference->classPropertyName(),
+                                                       *backReference,
                                                        QVariant::fromValue(backReferenceContainer)))
                     {
                         qFatal("Unable to update back-reference");
@@ -162,7 +177,7 @@ public:
         if (m_session.merge(instance))
         {
             Q_EMIT entityInstanceCreated();
-            read();
+            insertRow(instance);
             return instance;
         }
 
@@ -191,11 +206,11 @@ public:
                 {
                     auto backReferenceContainer =
                         QOrmPrivate::propertyValue(referencedInstance,
-                                                   backReference->classPropertyName())
+                                                   *backReference)
                             .value<QVector<QObject*>>();
                     backReferenceContainer.removeAll(entityInstance);
                     if (!QOrmPrivate::setPropertyValue(referencedInstance,
-                                                       backReference->classPropertyName(),
+                                                       *backReference,
                                                        QVariant::fromValue(backReferenceContainer)))
                     {
                         qFatal("Unable to update back-reference");
@@ -204,10 +219,19 @@ public:
             }
         }
 
+        int row = indexOf(entityInstance);
+        bool isCounted = row >= 0 || matchesFilter(qobject_cast<T*>(entityInstance));
+
         if (m_session.remove(qobject_cast<T*>(entityInstance)))
         {
             Q_EMIT entityInstanceRemoved();
-            read();
+
+            if (row >= 0)
+                removeRow(row);
+
+            if (isCounted)
+                setTotalCount(m_totalCount - 1);
+
             return true;
         }
 
@@ -216,25 +240,59 @@ public:
 
     bool removeAt(int index) override
     {
-        if (index >= 0 && index <= m_data.size() && m_session.remove(m_data[index]))
-        {
-            read();
-            return true;
-        }
-        return false;
+        return index >= 0 && index < m_data.size() && remove(m_data[index]);
     }
 
-    bool update(QObject* instance) override {
+    bool update(QObject* instance) override
+    {
         T* t = qobject_cast<T*>(instance);
+
         if (!t)
             return false;
-        if (m_session.merge(t)) {
-            int row = indexOf(instance);
-            Q_ASSERT(row >= 0);
-            emit dataChanged(index(row), index(row));
+
+        int row = indexOf(instance);
+        bool wasMatching = row >= 0 || isStoredMatching(t);
+
+        if (!m_session.merge(t))
+            return false;
+
+        if (!matchesFilter(t))
+        {
+            if (row >= 0)
+                removeRow(row);
+
+            if (wasMatching)
+                setTotalCount(m_totalCount - 1);
+
             return true;
         }
-        return false;
+
+        if (row < 0)
+        {
+            insertRow(t, wasMatching);
+            return true;
+        }
+
+        int newRow = sortedRow(t, row);
+
+        // moved past the fetched rows: fetchMore() reads it again at its new position
+        if (newRow == m_data.size() - 1 && newRow != row && m_data.size() < m_totalCount)
+        {
+            removeRow(row);
+            return true;
+        }
+
+        if (newRow != row)
+        {
+            int destinationRow = newRow > row ? newRow + 1 : newRow;
+            beginMoveRows(QModelIndex{}, row, row, QModelIndex{}, destinationRow);
+            m_data.move(row, newRow);
+            updateRows(std::min(row, newRow), std::max(row, newRow) + 1);
+            endMoveRows();
+        }
+
+        emit dataChanged(index(newRow), index(newRow));
+        return true;
     }
 
     void read() override
@@ -246,20 +304,53 @@ public:
 
     int rowCount(const QModelIndex& = QModelIndex{}) const { return m_data.size(); }
 
+    bool canFetchMore(const QModelIndex& parent) const override
+    {
+        return !parent.isValid() && m_data.size() < m_totalCount;
+    }
+
+    void fetchMore(const QModelIndex& parent) override
+    {
+        if (parent.isValid())
+            return;
+
+        QVector<T*> page = readPage();
+
+        // Nothing follows the last fetched row although more rows were counted: rows were removed
+        // or changed by someone else since. If rows are still missing after counting them again,
+        // they moved before the fetched ones, and all rows are read again.
+        if (page.isEmpty())
+        {
+            int totalCount = countRows();
+
+            if (totalCount > m_data.size())
+                read();
+            else
+                setTotalCount(totalCount);
+
+            return;
+        }
+
+        beginInsertRows(QModelIndex{}, m_data.size(), m_data.size() + page.size() - 1);
+        m_data += page;
+        updateRows(m_data.size() - page.size());
+        endInsertRows();
+    }
+
     QHash<int, QByteArray> roleNames() const { return m_roleNames; }
 
     QVariant data(const QModelIndex& index, int role) const
     {
-        if (index.row() >= 0 && index.row() < m_data.size())
+        int roleIndex = role - Qt::UserRole;
+
+        if (index.row() >= 0 && index.row() < m_data.size() && roleIndex >= 0 &&
+            roleIndex < m_roles.size())
         {
-            const QOrmPropertyMapping& propertyMapping = m_roles.at(role);
+            const Role& roleAccessor = m_roles[roleIndex];
 
-            QVariant propertyValue =
-                m_data[index.row()]->property(propertyMapping.classPropertyName().toUtf8().data());
+            QVariant propertyValue = roleAccessor.property.read(m_data[index.row()]);
 
-            if ((QString{propertyValue.typeName()}.startsWith("QList<") ||
-                 QString{propertyValue.typeName()}.startsWith("QVector<")) &&
-                QString{propertyValue.typeName()}.endsWith("*>"))
+            if (roleAccessor.isInstanceList)
             {
                 QVariantList list;
 
@@ -277,67 +368,361 @@ public:
     }
 
 private:
-    void onFilterChanged() override { readData(); }
+    void onFilterChanged() override { read(); }
 
-    void onOrderChanged() override { readData(); }
+    void onOrderChanged() override { read(); }
 
+    // Counts the rows matching the filter and reads the first page.
     void readData() override
     {
-        std::optional<QOrmFilterExpression> filterExpression;
-        std::vector<QOrmOrder> order;
+        unpinRows();
+        m_data.clear();
+        m_rows.clear();
+
+        setTotalCount(countRows());
+
+        if (m_totalCount > 0)
+        {
+            m_data = readPage();
+            updateRows();
+        }
+    }
+
+    int countRows() const
+    {
+        qint64 count = makeQuery().count();
+
+        if (count < 0)
+        {
+            qCWarning(qtorm) << "Unable to count the rows of" << metadata().className() << ":"
+                             << m_session.lastError();
+            return 0;
+        }
+
+        return static_cast<int>(count);
+    }
+
+    // Reads the rows following the fetched ones. The page starts right after the last fetched
+    // instance if its ordered properties can be compared; otherwise the fetched rows are skipped.
+    QVector<T*> readPage()
+    {
+        auto query = makeQuery();
+
+        if (!m_data.isEmpty())
+        {
+            if (isKeyset(m_data.last()))
+                query.after(m_data.last());
+            else
+                query.offset(m_data.size());
+        }
+
+        if (m_pageSize > 0)
+            query.limit(m_pageSize);
+
+        QOrmQueryResult<T> result = query.select();
+
+        if (result.hasError())
+        {
+            qCWarning(qtorm) << "Unable to read the rows of" << metadata().className() << ":"
+                             << result.error();
+            return {};
+        }
+
+        return result.toVector();
+    }
+
+    bool isKeyset(const T* instance) const
+    {
+        if (metadata().objectIdMapping() == nullptr)
+            return false;
+
+        for (const auto& orderProperty : orderProperties())
+        {
+            const QOrmPropertyMapping* mapping =
+                metadata().classPropertyMapping(orderProperty.first);
+
+            if (mapping == nullptr)
+                return false;
+
+            QVariant value = QOrmPrivate::propertyValue(instance, *mapping);
+
+            if (value.isNull() || (mapping->isReference() && value.value<QObject*>() == nullptr))
+                return false;
+        }
+
+        return true;
+    }
+
+    std::vector<std::pair<QString, Qt::SortOrder>> orderProperties() const
+    {
+        std::vector<std::pair<QString, Qt::SortOrder>> order;
+
+        for (const QVariant& orderItem : m_order)
+        {
+            if (orderItem.type() == QVariant::Map)
+            {
+                QVariantMap orderItemMap = orderItem.toMap();
+
+                for (auto it = std::cbegin(orderItemMap); it != std::cend(orderItemMap); ++it)
+                    order.emplace_back(it.key(), it.value().value<Qt::SortOrder>());
+            }
+            else if (orderItem.type() == QVariant::String)
+            {
+                order.emplace_back(orderItem.toString(), Qt::AscendingOrder);
+            }
+            else
+            {
+                qCritical("Unexpected order type");
+            }
+        }
+
+        return order;
+    }
+
+    std::optional<QOrmFilterExpression> filterExpression() const
+    {
+        std::optional<QOrmFilterExpression> expression;
 
         for (auto it = std::begin(m_filter); it != std::end(m_filter); ++it)
         {
             auto predicate = QOrmClassProperty{it.key().toUtf8().data()} == it.value();
 
-            if (filterExpression.has_value())
+            if (expression.has_value())
             {
-                filterExpression = *filterExpression && predicate;
+                expression = *expression && predicate;
             }
             else
             {
-                filterExpression = predicate;
+                expression = predicate;
             }
         }
 
+        return expression;
+    }
+
+    // The query of the filter and the order. The object ID breaks ties of the order so that the
+    // pages do not overlap.
+    QOrmQueryBuilder<T> makeQuery() const
+    {
         auto query = m_session.from<T>();
 
-        if (filterExpression.has_value())
+        if (auto expression = filterExpression(); expression.has_value())
         {
-            query.filter(*filterExpression);
+            query.filter(*expression);
         }
 
-        for (const QVariant& orderItem : m_order)
+        const QOrmPropertyMapping* objectIdMapping = metadata().objectIdMapping();
+        bool isOrderedByObjectId = false;
+
+        for (const auto& [classProperty, direction] : orderProperties())
         {
-            if (orderItem.type() == QVariant::Map)
+            query.order(QOrmClassProperty{classProperty.toUtf8().data()}, direction);
+
+            if (objectIdMapping != nullptr && objectIdMapping->classPropertyName() == classProperty)
+                isOrderedByObjectId = true;
+        }
+
+        if (objectIdMapping != nullptr && !isOrderedByObjectId)
+            query.order(QOrmClassProperty{objectIdMapping->classPropertyName().toUtf8().data()});
+
+        return query;
+    }
+
+    const QOrmMetadata& metadata() const { return m_session.metadataCache()->get<T>(); }
+
+    // Inserts an instance at its position under the current order, unless it belongs to the rows
+    // not fetched yet. isCounted tells whether the total count already includes the instance.
+    void insertRow(T* instance, bool isCounted = false)
+    {
+        if (!matchesFilter(instance))
+            return;
+
+        bool isFetchedToEnd = m_data.size() + (isCounted ? 1 : 0) >= m_totalCount;
+        int row = sortedRow(instance);
+
+        if (!isCounted)
+            setTotalCount(m_totalCount + 1);
+
+        if (row == m_data.size() && !isFetchedToEnd)
+            return;
+
+        beginInsertRows(QModelIndex{}, row, row);
+        m_data.insert(row, instance);
+        updateRows(row);
+        endInsertRows();
+    }
+
+    void removeRow(int row)
+    {
+        beginRemoveRows(QModelIndex{}, row, row);
+        m_session.entityInstanceCache()->unpin(m_data[row]);
+        m_rows.remove(m_data[row]);
+        m_data.remove(row);
+        updateRows(row);
+        endRemoveRows();
+    }
+
+    // Updates the rows of the instances in [first, last) after m_data has changed. New rows are
+    // pinned in the entity instance cache, so that they are not evicted while the model shows them.
+    void updateRows(int first = 0, int last = -1)
+    {
+        if (last < 0)
+            last = m_data.size();
+
+        for (int row = first; row < last; ++row)
+        {
+            if (!m_rows.contains(m_data[row]))
+                m_session.entityInstanceCache()->pin(m_data[row]);
+
+            m_rows.insert(m_data[row], row);
+        }
+    }
+
+    void unpinRows()
+    {
+        for (auto it = std::cbegin(m_rows); it != std::cend(m_rows); ++it)
+            m_session.entityInstanceCache()->unpin(it.key());
+    }
+
+    // Whether the stored state of the instance matches the filter, i.e. whether the instance is
+    // counted by totalCount even if it is not fetched.
+    bool isStoredMatching(const T* instance) const
+    {
+        if (!QOrmPrivate::hasAssignedObjectId(instance, metadata()))
+            return false;
+
+        const QOrmPropertyMapping* objectIdMapping = metadata().objectIdMapping();
+        auto predicate = QOrmClassProperty{objectIdMapping->classPropertyName().toUtf8().data()} ==
+                         QOrmPrivate::objectIdPropertyValue(instance, metadata());
+
+        auto query = m_session.from<T>();
+
+        if (auto expression = filterExpression(); expression.has_value())
+            query.filter(*expression && predicate);
+        else
+            query.filter(predicate);
+
+        qint64 count = query.count();
+
+        if (count < 0)
+        {
+            qCWarning(qtorm) << "Unable to count the rows of" << metadata().className() << ":"
+                             << m_session.lastError();
+        }
+
+        return count > 0;
+    }
+
+    bool matchesFilter(const T* instance) const
+    {
+        for (auto it = std::cbegin(m_filter); it != std::cend(m_filter); ++it)
+        {
+            const QOrmPropertyMapping* mapping = metadata().classPropertyMapping(it.key());
+
+            if (mapping == nullptr)
+                return false;
+
+            QVariant value = it.value();
+
+            // references are filtered by instances or by object IDs
+            if (mapping->isReference() && value.value<QObject*>() != nullptr)
             {
-                QVariantMap orderItemMap = orderItem.toMap();
+                value = QOrmPrivate::objectIdPropertyValue(value.value<QObject*>(),
+                                                           *mapping->referencedEntity());
+            }
 
-                for (auto it = std::cbegin(orderItemMap); it != std::cend(orderItemMap); ++it)
-                {
-                    query.order(QOrmClassProperty{it.key().toUtf8().data()},
-                                it.value().value<Qt::SortOrder>());
-                }
+            if (QOrmPrivate::compareValues(sortValue(instance, *mapping), value) != 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    // The row of the instance under the current order among the other fetched rows; skippedRow is
+    // the current row of the instance.
+    int sortedRow(const T* instance, int skippedRow = -1) const
+    {
+        std::vector<std::pair<const QOrmPropertyMapping*, Qt::SortOrder>> sortKeys;
+
+        for (const auto& [classProperty, direction] : orderProperties())
+        {
+            const QOrmPropertyMapping* mapping = metadata().classPropertyMapping(classProperty);
+
+            if (mapping != nullptr)
+                sortKeys.emplace_back(mapping, direction);
+        }
+
+        if (metadata().objectIdMapping() != nullptr)
+            sortKeys.emplace_back(metadata().objectIdMapping(), Qt::AscendingOrder);
+
+        auto isAfter = [this, &sortKeys](const T* lhs, const T* rhs) {
+            for (const auto& [mapping, direction] : sortKeys)
+            {
+                int result = QOrmPrivate::compareValues(sortValue(lhs, *mapping),
+                                                        sortValue(rhs, *mapping));
+
+                if (result != 0)
+                    return direction == Qt::AscendingOrder ? result > 0 : result < 0;
             }
-            else if (orderItem.type() == QVariant::String)
+
+            return false;
+        };
+
+        // binary search for the first row after the instance
+        int first = 0;
+        int count = m_data.size() - (skippedRow >= 0 ? 1 : 0);
+
+        while (count > 0)
+        {
+            int step = count / 2;
+            int row = first + step;
+
+            if (skippedRow >= 0 && row >= skippedRow)
+                ++row;
+
+            if (isAfter(m_data[row], instance))
             {
-                query.order(QOrmClassProperty{orderItem.toString().toUtf8().data()},
-                            Qt::AscendingOrder);
+                count = step;
             }
             else
             {
-                qCritical("Unexpected order type");
+                first += step + 1;
+                count -= step + 1;
             }
         }
 
-        m_data = query.select().toVector();
+        return first;
+    }
+
+    // References are ordered and filtered by the object ID of the referenced instance.
+    QVariant sortValue(const T* instance, const QOrmPropertyMapping& mapping) const
+    {
+        QVariant value = QOrmPrivate::propertyValue(instance, mapping);
+
+        if (!mapping.isReference())
+            return value;
+
+        const QObject* referencedInstance = value.value<QObject*>();
+
+        return referencedInstance == nullptr
+                   ? QVariant{}
+                   : QOrmPrivate::objectIdPropertyValue(referencedInstance,
+                                                        *mapping.referencedEntity());
     }
 
 private:
     QOrmSession& m_session;
     QVector<T*> m_data;
+    QHash<const QObject*, int> m_rows;
     QHash<int, QByteArray> m_roleNames;
-    std::unordered_map<int, QOrmPropertyMapping> m_roles;
+
+    // Role Qt::UserRole + i reads the i-th property mapping.
+    struct Role
+    {
+        QMetaProperty property;
+        bool isInstanceList;
+    };
+    QVector<Role> m_roles;
 };
 
 QT_END_NAMESPACE
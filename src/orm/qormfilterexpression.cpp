@@ -27,11 +27,12 @@
 QT_BEGIN_NAMESPACE
 
 /*
- * TerminalPredicate = PROP COMP VAL ;
+ * TerminalPredicate = ( PROP | PROP ARITH ( PROP | VAL ) ) COMP VAL ;
  * Expr = [ '(' ] ( TerminalPredicate | BinaryPredicate | UnaryPredicate ) [ ')' ] ;
  * BinaryPredicate = Expr OP Expr
  * UnaryPredicate = '!' Expr
  * COMP = '<' | '>' | '<=' | '>=' | '==' | '!=' ;
+ * ARITH = '+' | '-' | '*' | '/' ;
  * OP = '&&' | '||' ;
  *
  */
@@ -98,13 +99,26 @@ QOrmFilterTerminalPredicate::QOrmFilterTerminalPredicate(
 {
 }
 
+QOrmFilterTerminalPredicate::QOrmFilterTerminalPredicate(
+        const QOrmFilterArithmeticTerm& arithmeticTerm,
+        QOrm::Comparison comparison,
+        QVariant value)
+    : m_filterProperty{arithmeticTerm.filterProperty()},
+      m_arithmetic{std::make_pair(arithmeticTerm.arithmeticOperator(), arithmeticTerm.operand())},
+      m_comparison{comparison},
+      m_value{std::move(value)}
+{
+}
+
 /*!
  * \class QOrmFilterTerminalPredicate
  */
 
 bool QOrmFilterTerminalPredicate::isResolved() const
 {
-    return std::holds_alternative<QOrmPropertyMapping>(m_filterProperty);
+    return std::holds_alternative<QOrmPropertyMapping>(m_filterProperty) &&
+           (!m_arithmetic.has_value() ||
+            !std::holds_alternative<QOrmClassProperty>(m_arithmetic->second));
 }
 
 const QOrmClassProperty* QOrmFilterTerminalPredicate::classProperty() const
@@ -117,6 +131,19 @@ const QOrmPropertyMapping* QOrmFilterTerminalPredicate::propertyMapping() const
     return std::get_if<QOrmPropertyMapping>(&m_filterProperty);
 }
 
+std::optional<QOrm::ArithmeticOperator> QOrmFilterTerminalPredicate::arithmeticOperator() const
+{
+    if (!m_arithmetic.has_value())
+        return std::nullopt;
+
+    return m_arithmetic->first;
+}
+
+const QOrmFilterArithmeticTerm::Operand* QOrmFilterTerminalPredicate::arithmeticOperand() const
+{
+    return m_arithmetic.has_value() ? &m_arithmetic->second : nullptr;
+}
+
 QOrm::Comparison QOrmFilterTerminalPredicate::comparison() const
 {
     return m_comparison;
@@ -142,6 +169,34 @@ const QOrmFilterUnaryPredicate* QOrmFilterExpression::unaryPredicate() const
     return std::get_if<QOrmFilterUnaryPredicate>(&d->m_predicate);
 }
 
+/*!
+ * \class QOrmFilterArithmeticTerm
+ */
+
+QOrmFilterArithmeticTerm::QOrmFilterArithmeticTerm(FilterProperty filterProperty,
+                                                   QOrm::ArithmeticOperator arithmeticOperator,
+                                                   Operand operand)
+    : m_filterProperty{std::move(filterProperty)},
+      m_arithmeticOperator{arithmeticOperator},
+      m_operand{std::move(operand)}
+{
+}
+
+const QOrmFilterArithmeticTerm::FilterProperty& QOrmFilterArithmeticTerm::filterProperty() const
+{
+    return m_filterProperty;
+}
+
+QOrm::ArithmeticOperator QOrmFilterArithmeticTerm::arithmeticOperator() const
+{
+    return m_arithmeticOperator;
+}
+
+const QOrmFilterArithmeticTerm::Operand& QOrmFilterArithmeticTerm::operand() const
+{
+    return m_operand;
+}
+
 /*!
  * \class QOrmFilterBinaryPredicate
  */
@@ -221,16 +276,35 @@ QDebug operator<<(QDebug dbg, const QOrmFilterTerminalPredicate& predicate)
 
     dbg << "QOrmFilterTerminalPredicate(";
 
-    if (predicate.isResolved())
+    if (predicate.propertyMapping() != nullptr)
         dbg << *predicate.propertyMapping();
     else
         dbg << *predicate.classProperty();
 
+    if (predicate.arithmeticOperator().has_value())
+    {
+        dbg << ", " << *predicate.arithmeticOperator() << ", ";
+        std::visit([&dbg](const auto& operand) { dbg << operand; }, *predicate.arithmeticOperand());
+    }
+
     dbg << ", " << predicate.comparison() << ", " << predicate.value() << ")";
 
     return dbg;
 }
 
+QDebug operator<<(QDebug dbg, const QOrmFilterArithmeticTerm& term)
+{
+    QDebugStateSaver saver{dbg};
+
+    dbg << "QOrmFilterArithmeticTerm(";
+    std::visit([&dbg](const auto& property) { dbg << property; }, term.filterProperty());
+    dbg << ", " << term.arithmeticOperator() << ", ";
+    std::visit([&dbg](const auto& operand) { dbg << operand; }, term.operand());
+    dbg << ")";
+
+    return dbg;
+}
+
 QDebug operator<<(QDebug dbg, const QOrmFilterUnaryPredicate& predicate)
 {
     QDebugStateSaver saver{dbg};
@@ -251,6 +325,30 @@ QDebug operator<<(QDebug dbg, const QOrmFilterBinaryPredicate& predicate)
     return dbg;
 }
 
+QOrmFilterArithmeticTerm operator+(const QOrmClassProperty& property,
+                                   const QOrmFilterArithmeticTerm::Operand& operand)
+{
+    return {property, QOrm::ArithmeticOperator::Add, operand};
+}
+
+QOrmFilterArithmeticTerm operator-(const QOrmClassProperty& property,
+                                   const QOrmFilterArithmeticTerm::Operand& operand)
+{
+    return {property, QOrm::ArithmeticOperator::Subtract, operand};
+}
+
+QOrmFilterArithmeticTerm operator*(const QOrmClassProperty& property,
+                                   const QOrmFilterArithmeticTerm::Operand& operand)
+{
+    return {property, QOrm::ArithmeticOperator::Multiply, operand};
+}
+
+QOrmFilterArithmeticTerm operator/(const QOrmClassProperty& property,
+                                   const QOrmFilterArithmeticTerm::Operand& operand)
+{
+    return {property, QOrm::ArithmeticOperator::Divide, operand};
+}
+
 QOrmFilterUnaryPredicate operator!(const QOrmFilterExpression& rhs)
 {
     return {QOrm::UnaryLogicalOperator::Not, rhs};
@@ -28,6 +28,8 @@
 #include <QtCore/qshareddata.h>
 #include <QtCore/qvariant.h>
 
+#include <optional>
+#include <utility>
 #include <variant>
 
 QT_BEGIN_NAMESPACE
@@ -36,6 +38,7 @@ class QOrmFilterExpressionPrivate;
 class QVariant;
 
 class QOrmFilterTerminalPredicate;
+class QOrmFilterArithmeticTerm;
 class QOrmFilterBinaryPredicate;
 class QOrmFilterUnaryPredicate;
 
@@ -62,26 +65,58 @@ private:
     QSharedDataPointer<QOrmFilterExpressionPrivate> d;
 };
 
-class Q_ORM_EXPORT QOrmFilterTerminalPredicate
+// A property combined with a value or with another property by an arithmetic operator, e.g.
+// Q_ORM_CLASS_PROPERTY(price) * Q_ORM_CLASS_PROPERTY(quantity). Comparing it yields a terminal
+// predicate on the computed value.
+class Q_ORM_EXPORT QOrmFilterArithmeticTerm
 {
 public:
     using FilterProperty = std::variant<QOrmClassProperty, QOrmPropertyMapping>;
+    using Operand = std::variant<QVariant, QOrmClassProperty, QOrmPropertyMapping>;
+
+    QOrmFilterArithmeticTerm(FilterProperty filterProperty,
+                             QOrm::ArithmeticOperator arithmeticOperator,
+                             Operand operand);
+
+    Q_REQUIRED_RESULT const FilterProperty& filterProperty() const;
+    Q_REQUIRED_RESULT QOrm::ArithmeticOperator arithmeticOperator() const;
+    Q_REQUIRED_RESULT const Operand& operand() const;
+
+private:
+    FilterProperty m_filterProperty;
+    QOrm::ArithmeticOperator m_arithmeticOperator;
+    Operand m_operand;
+};
+
+class Q_ORM_EXPORT QOrmFilterTerminalPredicate
+{
+public:
+    using FilterProperty = QOrmFilterArithmeticTerm::FilterProperty;
 
     QOrmFilterTerminalPredicate(FilterProperty filterProperty,
                                 QOrm::Comparison comparison,
                                 QVariant value);
+    QOrmFilterTerminalPredicate(const QOrmFilterArithmeticTerm& arithmeticTerm,
+                                QOrm::Comparison comparison,
+                                QVariant value);
 
     Q_REQUIRED_RESULT bool isResolved() const;
 
     Q_REQUIRED_RESULT const QOrmClassProperty* classProperty() const;
     Q_REQUIRED_RESULT const QOrmPropertyMapping* propertyMapping() const;
 
+    // The arithmetic term applied to the property before the comparison, if any.
+    Q_REQUIRED_RESULT std::optional<QOrm::ArithmeticOperator> arithmeticOperator() const;
+    Q_REQUIRED_RESULT const QOrmFilterArithmeticTerm::Operand* arithmeticOperand() const;
+
     Q_REQUIRED_RESULT QOrm::Comparison comparison() const;
 
     Q_REQUIRED_RESULT QVariant value() const;
 
 private:
     std::variant<QOrmClassProperty, QOrmPropertyMapping> m_filterProperty;
+    std::optional<std::pair<QOrm::ArithmeticOperator, QOrmFilterArithmeticTerm::Operand>>
+        m_arithmetic;
     QOrm::Comparison m_comparison;
     QVariant m_value;
 };
@@ -119,6 +154,7 @@ private:
 
 extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmFilterExpression& expression);
 extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmFilterTerminalPredicate& predicate);
+extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmFilterArithmeticTerm& term);
 extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmFilterBinaryPredicate& predicate);
 extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmFilterUnaryPredicate& predicate);
 
@@ -285,6 +321,80 @@ operator>=(const QOrmFilterTerminalPredicate::FilterProperty& property, T&& valu
                                                                    std::forward<T>(value));
 }
 
+Q_REQUIRED_RESULT
+Q_ORM_EXPORT
+QOrmFilterArithmeticTerm operator+(const QOrmClassProperty& property,
+                                   const QOrmFilterArithmeticTerm::Operand& operand);
+
+Q_REQUIRED_RESULT
+Q_ORM_EXPORT
+QOrmFilterArithmeticTerm operator-(const QOrmClassProperty& property,
+                                   const QOrmFilterArithmeticTerm::Operand& operand);
+
+Q_REQUIRED_RESULT
+Q_ORM_EXPORT
+QOrmFilterArithmeticTerm operator*(const QOrmClassProperty& property,
+                                   const QOrmFilterArithmeticTerm::Operand& operand);
+
+Q_REQUIRED_RESULT
+Q_ORM_EXPORT
+QOrmFilterArithmeticTerm operator/(const QOrmClassProperty& property,
+                                   const QOrmFilterArithmeticTerm::Operand& operand);
+
+template<typename T>
+[[nodiscard]] inline QOrmFilterTerminalPredicate operator==(const QOrmFilterArithmeticTerm& term,
+                                                            T&& value)
+{
+    return {term,
+            QOrm::Comparison::Equal,
+            QtOrmPrivate::ValueConverter<T>::convert(std::forward<T>(value))};
+}
+
+template<typename T>
+[[nodiscard]] inline QOrmFilterTerminalPredicate operator!=(const QOrmFilterArithmeticTerm& term,
+                                                            T&& value)
+{
+    return {term,
+            QOrm::Comparison::NotEqual,
+            QtOrmPrivate::ValueConverter<T>::convert(std::forward<T>(value))};
+}
+
+template<typename T>
+[[nodiscard]] inline QOrmFilterTerminalPredicate operator<(const QOrmFilterArithmeticTerm& term,
+                                                           T&& value)
+{
+    return {term,
+            QOrm::Comparison::Less,
+            QtOrmPrivate::ValueConverter<T>::convert(std::forward<T>(value))};
+}
+
+template<typename T>
+[[nodiscard]] inline QOrmFilterTerminalPredicate operator<=(const QOrmFilterArithmeticTerm& term,
+                                                            T&& value)
+{
+    return {term,
+            QOrm::Comparison::LessOrEqual,
+            QtOrmPrivate::ValueConverter<T>::convert(std::forward<T>(value))};
+}
+
+template<typename T>
+[[nodiscard]] inline QOrmFilterTerminalPredicate operator>(const QOrmFilterArithmeticTerm& term,
+                                                           T&& value)
+{
+    return {term,
+            QOrm::Comparison::Greater,
+            QtOrmPrivate::ValueConverter<T>::convert(std::forward<T>(value))};
+}
+
+template<typename T>
+[[nodiscard]] inline QOrmFilterTerminalPredicate operator>=(const QOrmFilterArithmeticTerm& term,
+                                                            T&& value)
+{
+    return {term,
+            QOrm::Comparison::GreaterOrEqual,
+            QtOrmPrivate::ValueConverter<T>::convert(std::forward<T>(value))};
+}
+
 Q_REQUIRED_RESULT
 Q_ORM_EXPORT
 QOrmFilterUnaryPredicate operator!(const QOrmFilterExpression& operand);
@@ -57,6 +57,10 @@ namespace QOrm
             case Operation::Merge:
                 dbg << "Merge";
                 break;
+
+            case Operation::Upsert:
+                dbg << "Upsert";
+                break;
         }
 
         return dbg;
@@ -113,6 +117,37 @@ namespace QOrm
         return dbg;
     }
 
+    QDebug operator<<(QDebug dbg, AggregateFunction function)
+    {
+        QDebugStateSaver saver{dbg};
+        dbg.nospace() << "QOrm::AggregateFunction::";
+
+        switch (function)
+        {
+            case AggregateFunction::Count:
+                dbg << "Count";
+                break;
+
+            case AggregateFunction::Sum:
+                dbg << "Sum";
+                break;
+
+            case AggregateFunction::Min:
+                dbg << "Min";
+                break;
+
+            case AggregateFunction::Max:
+                dbg << "Max";
+                break;
+
+            case AggregateFunction::Avg:
+                dbg << "Avg";
+                break;
+        }
+
+        return dbg;
+    }
+
     QDebug operator<<(QDebug dbg, FilterExpressionType expressionType)
     {
         QDebugStateSaver saver{dbg};
@@ -183,6 +218,50 @@ namespace QOrm
             case Comparison::NotContains:
                 dbg << "NotContains";
                 break;
+
+            case Comparison::Between:
+                dbg << "Between";
+                break;
+
+            case Comparison::NotBetween:
+                dbg << "NotBetween";
+                break;
+
+            case Comparison::StartsWith:
+                dbg << "StartsWith";
+                break;
+
+            case Comparison::EqualIgnoringCase:
+                dbg << "EqualIgnoringCase";
+                break;
+        }
+
+        return dbg;
+    }
+
+    QDebug operator<<(QDebug dbg, ArithmeticOperator arithmeticOperator)
+    {
+        QDebugStateSaver saver{dbg};
+
+        dbg.nospace().noquote() << "QOrm::ArithmeticOperator::";
+
+        switch (arithmeticOperator)
+        {
+            case ArithmeticOperator::Add:
+                dbg << "Add";
+                break;
+
+            case ArithmeticOperator::Subtract:
+                dbg << "Subtract";
+                break;
+
+            case ArithmeticOperator::Multiply:
+                dbg << "Multiply";
+                break;
+
+            case ArithmeticOperator::Divide:
+                dbg << "Divide";
+                break;
         }
 
         return dbg;
@@ -84,11 +84,25 @@ namespace QOrm
         InList,
         NotInList,
         Contains,
-        NotContains
+        NotContains,
+        // the value is a QVariantList of the lower and the upper bound, both inclusive
+        Between,
+        NotBetween,
+        StartsWith,
+        EqualIgnoringCase
     };
     extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, QOrm::Comparison comparison);
     extern Q_ORM_EXPORT uint qHash(Comparison comparison) Q_DECL_NOTHROW;
 
+    enum class ArithmeticOperator
+    {
+        Add,
+        Subtract,
+        Multiply,
+        Divide
+    };
+    extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, QOrm::ArithmeticOperator arithmeticOperator);
+
     enum class BinaryLogicalOperator
     {
         And,
@@ -108,7 +122,8 @@ namespace QOrm
         Read,
         Update,
         Delete,
-        Merge
+        Merge,
+        Upsert
     };
     extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, Operation operation);
 
@@ -140,10 +155,42 @@ namespace QOrm
     };
     extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, QOrm::RelationType relationType);
 
+    enum class AggregateFunction
+    {
+        Count,
+        Sum,
+        Min,
+        Max,
+        Avg
+    };
+    extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, QOrm::AggregateFunction function);
+
     enum class QueryFlags
     {
         None = 0x00,
-        OverwriteCachedInstances = 0x01
+        OverwriteCachedInstances = 0x01,
+        // QOrmQueryBuilder::stream(): remove the entity instances the cursor has moved past from
+        // the entity instance cache and delete them
+        EvictStreamedInstances = 0x02
+    };
+
+    enum class FlushMode
+    {
+        // QOrmSession::merge() writes the entity instances immediately
+        Immediate,
+        // QOrmSession::merge() registers the entity instances; QOrmSession::flush() or the commit
+        // of the outermost transaction writes them
+        Deferred
+    };
+
+    // How the entity instance cache detects modified instances
+    enum class ChangeTracking
+    {
+        // connect to the NOTIFY signals of the mapped properties of every cached instance
+        NotifySignals,
+        // compare the mapped property values with a copy taken when the instance was cached or
+        // last synchronized with the database; properties need no NOTIFY signals
+        Snapshots
     };
 
     enum class Keyword
@@ -154,7 +201,8 @@ namespace QOrm
         Autogenerated,
         Identity,
         Transient,
-        Schema
+        Schema,
+        Fetch
     };
     inline auto qHash(Keyword value)
     {
@@ -19,12 +19,14 @@
  */
 
 #include "qormglobal_p.h"
+#include "qormentityinstancecache.h"
 #include "qormfilterexpression.h"
 #include "qormglobal.h"
 #include "qormquery.h"
 #include "qormrelation.h"
 
 #include <QDebug>
+#include <QSet>
 
 QT_BEGIN_NAMESPACE
 
@@ -42,34 +44,58 @@ namespace QOrmPrivate
                 if (predicate->isResolved())
                     return *predicate;
 
-                const QOrmPropertyMapping* propertyMapping = nullptr;
+                auto resolve = [&relation](const QOrmClassProperty& classProperty) {
+                    const QOrmPropertyMapping* propertyMapping = nullptr;
 
-                switch (relation.type())
-                {
-                    case QOrm::RelationType::Mapping:
-                        propertyMapping = relation.mapping()->classPropertyMapping(
-                            predicate->classProperty()->descriptor());
-                        break;
+                    switch (relation.type())
+                    {
+                        case QOrm::RelationType::Mapping:
+                            propertyMapping = relation.mapping()->classPropertyMapping(
+                                classProperty.descriptor());
+                            break;
+
+                        case QOrm::RelationType::Query:
+                            Q_ASSERT(relation.query()->projection().has_value());
+
+                            propertyMapping =
+                                relation.query()->projection()->classPropertyMapping(
+                                    classProperty.descriptor());
+                            break;
+                    }
+
+                    if (propertyMapping == nullptr)
+                    {
+                        qCritical()
+                            << "QtOrm: Unable to resolve filter expression for class property"
+                            << classProperty.descriptor() << ", relation" << relation;
+                        qFatal("QtOrm: Malformed query filter");
+                    }
 
-                    case QOrm::RelationType::Query:
-                        Q_ASSERT(relation.query()->projection().has_value());
+                    return *propertyMapping;
+                };
 
-                        propertyMapping = relation.query()->projection()->classPropertyMapping(
-                            predicate->classProperty()->descriptor());
-                        break;
-                }
+                QOrmPropertyMapping propertyMapping = predicate->propertyMapping() != nullptr
+                                                          ? *predicate->propertyMapping()
+                                                          : resolve(*predicate->classProperty());
 
-                if (propertyMapping == nullptr)
+                if (!predicate->arithmeticOperator().has_value())
                 {
-                    qCritical() << "QtOrm: Unable to resolve filter expression for class property"
-                                << predicate->classProperty()->descriptor() << ", relation"
-                                << relation;
-                    qFatal("QtOrm: Malformed query filter");
+                    return QOrmFilterTerminalPredicate{propertyMapping,
+                                                       predicate->comparison(),
+                                                       predicate->value()};
                 }
 
-                return QOrmFilterTerminalPredicate{*propertyMapping,
-                                                   predicate->comparison(),
-                                                   predicate->value()};
+                QOrmFilterArithmeticTerm::Operand operand = *predicate->arithmeticOperand();
+
+                if (const auto* classProperty = std::get_if<QOrmClassProperty>(&operand))
+                    operand = resolve(*classProperty);
+
+                return QOrmFilterTerminalPredicate{
+                    QOrmFilterArithmeticTerm{propertyMapping,
+                                             *predicate->arithmeticOperator(),
+                                             operand},
+                    predicate->comparison(),
+                    predicate->value()};
             }
 
             case QOrm::FilterExpressionType::BinaryPredicate:
@@ -123,12 +149,62 @@ namespace QOrmPrivate
         return repr;
     }
 
+    int compareValues(const QVariant& lhs, const QVariant& rhs)
+    {
+        if (lhs.isNull() || rhs.isNull())
+            return static_cast<int>(!lhs.isNull()) - static_cast<int>(!rhs.isNull());
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        QT_WARNING_PUSH
+        QT_WARNING_DISABLE_DEPRECATED
+
+        if (lhs < rhs)
+            return -1;
+
+        if (rhs < lhs)
+            return 1;
+
+        QT_WARNING_POP
+
+        if (lhs == rhs)
+            return 0;
+#else
+        QPartialOrdering ordering = QVariant::compare(lhs, rhs);
+
+        if (ordering == QPartialOrdering::Less)
+            return -1;
+
+        if (ordering == QPartialOrdering::Greater)
+            return 1;
+
+        if (ordering == QPartialOrdering::Equivalent)
+            return 0;
+#endif
+
+        // Unordered values, e.g. of unrelated types, do not match. They are ordered by type and by
+        // their string representation, so that the order stays stable.
+        if (lhs.userType() != rhs.userType())
+            return lhs.userType() < rhs.userType() ? -1 : 1;
+
+        if (int result = QString::compare(lhs.toString(), rhs.toString()); result != 0)
+            return result;
+
+        return lhs == rhs ? 0 : 1;
+    }
+
     std::optional<QString> crossReferenceError(const QOrmMetadata& entity,
-                                               const QObject* entityInstance)
+                                               const QObject* entityInstance,
+                                               const QOrmEntityInstanceCache* entityInstanceCache)
     {
+        auto isFetched = [entityInstanceCache](const QObject* instance,
+                                               const QOrmPropertyMapping& mapping) {
+            return entityInstanceCache == nullptr ||
+                   entityInstanceCache->isFetched(instance, mapping.classPropertyName());
+        };
+
         for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
         {
-            if (!mapping.isReference())
+            if (!mapping.isReference() || !isFetched(entityInstance, mapping))
                 continue;
 
             Q_ASSERT(mapping.referencedEntity() != nullptr);
@@ -146,7 +222,7 @@ namespace QOrmPrivate
                 QObject* referencedEntity =
                     propertyValue(entityInstance, mapping).value<QObject*>();
 
-                if (referencedEntity == nullptr)
+                if (referencedEntity == nullptr || !isFetched(referencedEntity, *backReference))
                     continue;
 
                 // T* <-> QVector<T*>
@@ -214,6 +290,9 @@ namespace QOrmPrivate
 
                 for (const QObject* referencedInstance : referencedInstances)
                 {
+                    if (!isFetched(referencedInstance, *backReference))
+                        continue;
+
                     // QVector<T*> <-> T*
                     // check that the entity on the other side references this one
                     QObject* backReferencedEntity =
@@ -240,6 +319,30 @@ namespace QOrmPrivate
 
         return std::nullopt;
     }
+
+    QVariant referenceCollectionValue(const QOrmPropertyMapping& mapping,
+                                      const QVector<QObject*>& referencedInstances)
+    {
+        if (mapping.dataTypeName().startsWith("QList<"))
+        {
+            return QVariant::fromValue(referencedInstances.toList());
+        }
+        else if (mapping.dataTypeName().startsWith("QVector<"))
+        {
+            return QVariant::fromValue(referencedInstances);
+        }
+        else if (mapping.dataTypeName().startsWith("QSet<"))
+        {
+            QSet<QObject*> result;
+
+            for (QObject* instance : referencedInstances)
+                result.insert(instance);
+
+            return QVariant::fromValue(result);
+        }
+
+        Q_ORM_UNEXPECTED_STATE;
+    }
 } // namespace QOrmPrivate
 
 Q_LOGGING_CATEGORY(qtorm, "qtorm", QtMsgType::QtWarningMsg)
@@ -28,12 +28,14 @@
 #include <QtCore/qloggingcategory.h>
 #include <QtCore/qstring.h>
 #include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
 
 #include <variant>
 #include <optional>
 
 QT_BEGIN_NAMESPACE
 
+class QOrmEntityInstanceCache;
 class QOrmFilterExpression;
 class QOrmRelation;
 
@@ -62,10 +64,13 @@ namespace QOrmPrivate
         return object->property(property.toUtf8().data());
     }
 
+    // The meta property of a mapping is resolved once by the metadata cache: reading and writing
+    // through it avoids the lookup by name and the UTF-8 conversion of the property name.
     Q_REQUIRED_RESULT
     inline QVariant propertyValue(const QObject* object, const QOrmPropertyMapping& mapping)
     {
-        return propertyValue(object, mapping.classPropertyName());
+        Q_ASSERT(mapping.qMetaProperty().isValid());
+        return mapping.qMetaProperty().read(object);
     }
 
     Q_REQUIRED_RESULT
@@ -74,11 +79,44 @@ namespace QOrmPrivate
         return object->setProperty(property.toUtf8().data(), value);
     }
 
+    Q_REQUIRED_RESULT
+    inline bool setPropertyValue(QObject* object,
+                                 const QOrmPropertyMapping& mapping,
+                                 const QVariant& value)
+    {
+        Q_ASSERT(mapping.qMetaProperty().isValid());
+        return mapping.qMetaProperty().write(object, value);
+    }
+
     Q_REQUIRED_RESULT
     inline QVariant objectIdPropertyValue(const QObject* entityInstance, const QOrmMetadata& meta)
     {
         Q_ASSERT(meta.objectIdMapping() != nullptr);
-        return propertyValue(entityInstance, meta.objectIdMapping()->classPropertyName());
+        return propertyValue(entityInstance, *meta.objectIdMapping());
+    }
+
+    // An autogenerated object ID is considered assigned if it differs from the default value of
+    // its type. Other object IDs are always assigned by the application.
+    Q_REQUIRED_RESULT
+    inline bool hasAssignedObjectId(const QObject* entityInstance, const QOrmMetadata& meta)
+    {
+        const QOrmPropertyMapping* objectIdMapping = meta.objectIdMapping();
+
+        if (objectIdMapping == nullptr)
+            return false;
+
+        if (!objectIdMapping->isAutogenerated())
+            return true;
+
+        QVariant objectId = propertyValue(entityInstance, *objectIdMapping);
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        QVariant defaultValue{objectId.userType(), nullptr};
+#else
+        QVariant defaultValue{objectId.metaType()};
+#endif
+
+        return !objectId.isNull() && objectId != defaultValue;
     }
 
     Q_REQUIRED_RESULT
@@ -115,10 +153,28 @@ namespace QOrmPrivate
     Q_ORM_EXPORT
     extern QString shortPropertyMappingRepresentation(const QOrmPropertyMapping& mapping);
 
+    // Converts the referenced entity instances to the container type of a one-to-many reference
+    // property: QList, QVector or QSet.
+    Q_REQUIRED_RESULT
+    Q_ORM_EXPORT
+    extern QVariant referenceCollectionValue(const QOrmPropertyMapping& mapping,
+                                             const QVector<QObject*>& referencedInstances);
+
+    // Orders values like SQLite does for values of the same column: null values come first.
+    // Values without an order do not compare equal. Returns a negative number, zero, or a positive
+    // number.
+    Q_REQUIRED_RESULT
+    Q_ORM_EXPORT
+    extern int compareValues(const QVariant& lhs, const QVariant& rhs);
+
+    // References whose other side is not fetched according to the entity instance cache, like
+    // FETCH LAZY collections or collections of evicted instances, are not checked.
     Q_REQUIRED_RESULT
     Q_ORM_EXPORT
-    extern std::optional<QString> crossReferenceError(const QOrmMetadata& entity,
-                                                      const QObject* entityInstance);
+    extern std::optional<QString> crossReferenceError(
+        const QOrmMetadata& entity,
+        const QObject* entityInstance,
+        const QOrmEntityInstanceCache* entityInstanceCache = nullptr);
 
     template<typename E>
     class Unexpected
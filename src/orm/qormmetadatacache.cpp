@@ -52,7 +52,8 @@ namespace
         {QOrm::Keyword::Column, QLatin1String("COLUMN")},
         {QOrm::Keyword::Identity, QLatin1String("IDENTITY")},
         {QOrm::Keyword::Transient, QLatin1String("TRANSIENT")},
-        {QOrm::Keyword::Autogenerated, QLatin1String("AUTOGENERATED")}};
+        {QOrm::Keyword::Autogenerated, QLatin1String("AUTOGENERATED")},
+        {QOrm::Keyword::Fetch, QLatin1String("FETCH")}};
 
     template<typename Iterable>
     KeywordPosition findNextKeyword(const QString& data,
@@ -301,6 +302,26 @@ namespace
                 ormPropertyInfo.insert(QOrm::Keyword::Autogenerated,
                                        isAutogenerated.value_or(true));
             }
+            else if (keywordPosition.keyword->id == QOrm::Keyword::Fetch)
+            {
+                auto extractResult = extractString(data, pos, PropertyKeywords);
+
+                QString fetchStrategy = extractResult.value;
+                keywordPosition = extractResult.nextKeyword;
+
+                if (fetchStrategy == QLatin1String("LAZY") ||
+                    fetchStrategy == QLatin1String("EAGER"))
+                {
+                    ormPropertyInfo.insert(QOrm::Keyword::Fetch, fetchStrategy);
+                }
+                else
+                {
+                    qFatal("QtOrm: syntax error in %s: Q_ORM_PROPERTY(%s FETCH <LAZY|EAGER>) "
+                           "requires either LAZY or EAGER.",
+                           qMetaObject.className(),
+                           qPrintable(propertyName));
+                }
+            }
         }
 
         return ormPropertyInfo;
@@ -320,6 +341,7 @@ class QOrmMetadataCachePrivate
         const QOrmMetadata* referencedEntity = nullptr;
         bool isTransient = false;
         bool isEnumeration{false};
+        bool isLazy{false};
         QMetaType::Type dataType{QMetaType::UnknownType};
     };
 
@@ -455,6 +477,14 @@ void QOrmMetadataCachePrivate::initialize(const QByteArray& className,
                    property.name());
         }
 
+        if (descriptor.isLazy && descriptor.referencedEntity == nullptr)
+        {
+            qFatal("QtOrm: The property %s::%s cannot be marked FETCH LAZY because it does not "
+                   "reference an entity.",
+                   qPrintable(className),
+                   property.name());
+        }
+
         data->m_propertyMappings.emplace_back(m_cache.at(className),
                                               property,
                                               descriptor.classPropertyName,
@@ -464,7 +494,8 @@ void QOrmMetadataCachePrivate::initialize(const QByteArray& className,
                                               descriptor.dataType,
                                               descriptor.referencedEntity,
                                               descriptor.isTransient,
-                                              userPropertyMetadata);
+                                              userPropertyMetadata,
+                                              descriptor.isLazy);
         auto idx = static_cast<int>(data->m_propertyMappings.size() - 1);
 
         data->m_classPropertyMappingIndex.insert(descriptor.classPropertyName, idx);
@@ -519,6 +550,12 @@ QOrmMetadataCachePrivate::MappingDescriptor QOrmMetadataCachePrivate::mappingDes
         isTransient = userPropertyMetadata.value(QOrm::Keyword::Transient).toBool();
     }
 
+    if (userPropertyMetadata.contains(QOrm::Keyword::Fetch))
+    {
+        descriptor.isLazy =
+            userPropertyMetadata.value(QOrm::Keyword::Fetch).toString() == QLatin1String("LAZY");
+    }
+
     descriptor.classPropertyName = QString::fromUtf8(property.name());
     descriptor.tableFieldName = tableFieldName;
     descriptor.isObjectId = isObjectId;
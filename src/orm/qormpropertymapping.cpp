@@ -40,6 +40,9 @@ QDebug operator<<(QDebug dbg, const QOrmPropertyMapping& propertyMapping)
     if (propertyMapping.isTransient())
         dbg << ", transient";
 
+    if (propertyMapping.isLazy())
+        dbg << ", lazy";
+
     dbg << ")";
 
     return dbg;
@@ -58,7 +61,8 @@ class QOrmPropertyMappingPrivate : public QSharedData
                                QMetaType::Type dataType,
                                const QOrmMetadata* referencedEntity,
                                bool isTransient,
-                               QOrmUserMetadata userMetadata)
+                               QOrmUserMetadata userMetadata,
+                               bool isLazy)
         : m_enclosingEntity{enclosingEntity}
         , m_qMetaProperty{std::move(qMetaProperty)}
         , m_classPropertyName{std::move(classPropertyName)}
@@ -69,6 +73,7 @@ class QOrmPropertyMappingPrivate : public QSharedData
         , m_referencedEntity{referencedEntity}
         , m_isTransient{isTransient}
         , m_userMetadata{std::move(userMetadata)}
+        , m_isLazy{isLazy}
     {
     }
 
@@ -82,6 +87,7 @@ class QOrmPropertyMappingPrivate : public QSharedData
     const QOrmMetadata* m_referencedEntity{nullptr};
     bool m_isTransient{false};
     QOrmUserMetadata m_userMetadata;
+    bool m_isLazy{false};
 };
 
 QOrmPropertyMapping::QOrmPropertyMapping(const QOrmMetadata& enclosingEntity,
@@ -93,7 +99,8 @@ QOrmPropertyMapping::QOrmPropertyMapping(const QOrmMetadata& enclosingEntity,
                                          QMetaType::Type dataType,
                                          const QOrmMetadata* referencedEntity,
                                          bool isTransient,
-                                         QOrmUserMetadata userMetadata)
+                                         QOrmUserMetadata userMetadata,
+                                         bool isLazy)
     : d{new QOrmPropertyMappingPrivate{enclosingEntity,
                                        std::move(qMetaProperty),
                                        std::move(classPropertyName),
@@ -103,7 +110,8 @@ QOrmPropertyMapping::QOrmPropertyMapping(const QOrmMetadata& enclosingEntity,
                                        dataType,
                                        referencedEntity,
                                        isTransient,
-                                       std::move(userMetadata)}}
+                                       std::move(userMetadata),
+                                       isLazy}}
 {
 }
 
@@ -172,6 +180,11 @@ bool QOrmPropertyMapping::isTransient() const
     return d->m_isTransient;
 }
 
+bool QOrmPropertyMapping::isLazy() const
+{
+    return d->m_isLazy;
+}
+
 const QOrmUserMetadata& QOrmPropertyMapping::userMetadata() const
 {
     return d->m_userMetadata;
@@ -45,7 +45,8 @@ public:
                         QMetaType::Type dataType,
                         const QOrmMetadata* referencedEntity,
                         bool isTransient,
-                        QOrmUserMetadata userMetadata);
+                        QOrmUserMetadata userMetadata,
+                        bool isLazy = false);
     QOrmPropertyMapping(const QOrmPropertyMapping&);
     QOrmPropertyMapping(QOrmPropertyMapping&&);
     ~QOrmPropertyMapping();
@@ -64,6 +65,7 @@ public:
     [[nodiscard]] bool isReference() const;
     [[nodiscard]] const QOrmMetadata* referencedEntity() const;
     [[nodiscard]] bool isTransient() const;
+    [[nodiscard]] bool isLazy() const;
     [[nodiscard]] const QOrmUserMetadata& userMetadata() const;
 
 private:
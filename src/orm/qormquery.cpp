@@ -19,9 +19,11 @@
  */
 
 #include "qormquery.h"
+#include "qormaggregate.h"
 #include "qormfilter.h"
 #include "qormmetadata.h"
 #include "qormorder.h"
+#include "qormpropertymapping.h"
 #include "qormrelation.h"
 
 #include <QDebug>
@@ -57,6 +59,15 @@ public:
     {
     }
 
+    QOrmQueryPrivate(QOrm::Operation operation,
+                     const QOrmMetadata& relation,
+                     const QVector<QObject*>& entityInstances)
+        : m_operation{operation}
+        , m_relation{relation}
+        , m_entityInstances{entityInstances}
+    {
+    }
+
     QOrm::Operation m_operation;
     QOrmRelation m_relation;
     std::optional<QOrmMetadata> m_projection;
@@ -64,9 +75,15 @@ public:
     std::optional<QOrmFilter> m_invokableFilter;
     std::vector<QOrmOrder> m_order;
     QObject* m_entityInstance{nullptr};
+    QVector<QObject*> m_entityInstances;
     QFlags<QOrm::QueryFlags> m_flags;
     std::optional<int> m_limit;
     std::optional<int> m_offset;
+    std::vector<QOrmPropertyMapping> m_columns;
+    std::vector<std::pair<QOrmPropertyMapping, QVariant>> m_assignments;
+    std::vector<QOrmAggregate> m_aggregates;
+    std::vector<QOrmPropertyMapping> m_groupBy;
+    std::vector<std::tuple<QOrmAggregate, QOrm::Comparison, QVariant>> m_having;
 };
 
 QOrmQuery::QOrmQuery(QOrm::Operation operation,
@@ -93,6 +110,13 @@ QOrmQuery::QOrmQuery(QOrm::Operation operation,
 {
 }
 
+QOrmQuery::QOrmQuery(QOrm::Operation operation,
+                     const QOrmMetadata& relation,
+                     const QVector<QObject*>& entityInstances)
+    : d{new QOrmQueryPrivate{operation, relation, entityInstances}}
+{
+}
+
 QOrmQuery::QOrmQuery(const QOrmQuery&) = default;
 
 QOrmQuery::QOrmQuery(QOrmQuery&&) = default;
@@ -138,6 +162,11 @@ const QObject* QOrmQuery::entityInstance() const
     return d->m_entityInstance;
 }
 
+const QVector<QObject*>& QOrmQuery::entityInstances() const
+{
+    return d->m_entityInstances;
+}
+
 const QFlags<QOrm::QueryFlags>& QOrmQuery::flags() const
 {
     return d->m_flags;
@@ -163,6 +192,58 @@ void QOrmQuery::setOffset(std::optional<int> offset)
     d->m_offset = offset;
 }
 
+const std::vector<QOrmPropertyMapping>& QOrmQuery::columns() const
+{
+    return d->m_columns;
+}
+
+void QOrmQuery::setColumns(const std::vector<QOrmPropertyMapping>& columns)
+{
+    d->m_columns = columns;
+}
+
+const std::vector<std::pair<QOrmPropertyMapping, QVariant>>& QOrmQuery::assignments() const
+{
+    return d->m_assignments;
+}
+
+void QOrmQuery::setAssignments(
+    const std::vector<std::pair<QOrmPropertyMapping, QVariant>>& assignments)
+{
+    d->m_assignments = assignments;
+}
+
+const std::vector<QOrmAggregate>& QOrmQuery::aggregates() const
+{
+    return d->m_aggregates;
+}
+
+void QOrmQuery::setAggregates(const std::vector<QOrmAggregate>& aggregates)
+{
+    d->m_aggregates = aggregates;
+}
+
+const std::vector<QOrmPropertyMapping>& QOrmQuery::groupBy() const
+{
+    return d->m_groupBy;
+}
+
+void QOrmQuery::setGroupBy(const std::vector<QOrmPropertyMapping>& groupBy)
+{
+    d->m_groupBy = groupBy;
+}
+
+const std::vector<std::tuple<QOrmAggregate, QOrm::Comparison, QVariant>>& QOrmQuery::having() const
+{
+    return d->m_having;
+}
+
+void QOrmQuery::setHaving(
+    const std::vector<std::tuple<QOrmAggregate, QOrm::Comparison, QVariant>>& having)
+{
+    d->m_having = having;
+}
+
 QDebug operator<<(QDebug dbg, const QOrmQuery& query)
 {
     QDebugStateSaver saver{dbg};
@@ -194,6 +275,11 @@ QDebug operator<<(QDebug dbg, const QOrmQuery& query)
         dbg << ", " << query.entityInstance();
     }
 
+    if (!query.entityInstances().isEmpty())
+    {
+        dbg << ", " << query.entityInstances().size() << " instances";
+    }
+
     if (query.limit().has_value())
     {
         dbg << ", limit " << *query.limit();
@@ -204,6 +290,31 @@ QDebug operator<<(QDebug dbg, const QOrmQuery& query)
         dbg << ", offset " << *query.offset();
     }
 
+    if (!query.columns().empty())
+    {
+        dbg << ", columns " << query.columns();
+    }
+
+    if (!query.aggregates().empty())
+    {
+        dbg << ", aggregates " << query.aggregates();
+    }
+
+    if (!query.groupBy().empty())
+    {
+        dbg << ", group by " << query.groupBy();
+    }
+
+    for (const auto& [aggregate, comparison, value] : query.having())
+    {
+        dbg << ", having " << aggregate << " " << comparison << " " << value;
+    }
+
+    for (const auto& [mapping, value] : query.assignments())
+    {
+        dbg << ", " << mapping.classPropertyName() << " = " << value;
+    }
+
     dbg << ")";
 
     return dbg;
@@ -23,17 +23,23 @@
 
 #include <QtCore/qglobal.h>
 #include <QtCore/qshareddata.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
 
 #include <QtOrm/qormglobal.h>
 #include <QtOrm/qormqueryresult.h>
 
 #include <vector>
 #include <optional>
+#include <tuple>
+#include <utility>
 
 QT_BEGIN_NAMESPACE
 
+class QOrmAggregate;
 class QOrmFilter;
 class QOrmOrder;
+class QOrmPropertyMapping;
 class QOrmQueryPrivate;
 class QOrmRelation;
 class QOrmMetadata;
@@ -49,6 +55,9 @@ public:
               const std::vector<QOrmOrder>& order,
               const QFlags<QOrm::QueryFlags>& flags);
     QOrmQuery(QOrm::Operation operation, const QOrmMetadata& relation, QObject* entityInstance);
+    QOrmQuery(QOrm::Operation operation,
+              const QOrmMetadata& relation,
+              const QVector<QObject*>& entityInstances);
     QOrmQuery(const QOrmQuery&);
     QOrmQuery(QOrmQuery&&);
     ~QOrmQuery();
@@ -77,6 +86,9 @@ public:
     Q_REQUIRED_RESULT
     const QObject* entityInstance() const;
 
+    Q_REQUIRED_RESULT
+    const QVector<QObject*>& entityInstances() const;
+
     Q_REQUIRED_RESULT
     const QFlags<QOrm::QueryFlags>& flags() const;
 
@@ -86,6 +98,28 @@ public:
     [[nodiscard]] std::optional<int> offset() const;
     void setOffset(std::optional<int> offset);
 
+    // Properties to read. If empty, all properties of the projection are read.
+    [[nodiscard]] const std::vector<QOrmPropertyMapping>& columns() const;
+    void setColumns(const std::vector<QOrmPropertyMapping>& columns);
+
+    // Update without entity instance: the values assigned to the rows matching the filter
+    [[nodiscard]] const std::vector<std::pair<QOrmPropertyMapping, QVariant>>& assignments() const;
+    void setAssignments(const std::vector<std::pair<QOrmPropertyMapping, QVariant>>& assignments);
+
+    // Read with aggregates: the aggregate values are computed instead of reading entity instances
+    [[nodiscard]] const std::vector<QOrmAggregate>& aggregates() const;
+    void setAggregates(const std::vector<QOrmAggregate>& aggregates);
+
+    // Read with aggregates: the rows are grouped by these properties
+    [[nodiscard]] const std::vector<QOrmPropertyMapping>& groupBy() const;
+    void setGroupBy(const std::vector<QOrmPropertyMapping>& groupBy);
+
+    // Read with aggregates: the conditions on the aggregates of a group, joined with AND
+    [[nodiscard]] const std::vector<std::tuple<QOrmAggregate, QOrm::Comparison, QVariant>>&
+    having() const;
+    void setHaving(
+        const std::vector<std::tuple<QOrmAggregate, QOrm::Comparison, QVariant>>& having);
+
 private:
     QSharedDataPointer<QOrmQueryPrivate> d;
 };
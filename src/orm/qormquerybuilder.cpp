@@ -21,12 +21,14 @@
 #include "qormquerybuilder.h"
 
 #include "qormabstractprovider.h"
+#include "qormaggregate.h"
 #include "qormerror.h"
 #include "qormfilter.h"
 #include "qormfilterexpression.h"
 #include "qormglobal_p.h"
 #include "qormmetadatacache.h"
 #include "qormorder.h"
+#include "qormpropertymapping.h"
 #include "qormquery.h"
 #include "qormqueryresult.h"
 #include "qormrelation.h"
@@ -34,6 +36,8 @@
 
 #include <QDebug>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 namespace QOrmPrivate
@@ -112,8 +116,149 @@ namespace QOrmPrivate
         std::vector<QOrmOrder> m_order;
         std::optional<int> m_limit{std::nullopt};
         std::optional<int> m_offset{std::nullopt};
+        const QObject* m_keysetInstance{nullptr};
+        bool m_isKeysetBefore{false};
+        std::vector<QOrmPropertyMapping> m_columns;
+        std::vector<QOrmPropertyMapping> m_groupBy;
+        std::vector<std::tuple<QOrmAggregate, QOrm::Comparison, QVariant>> m_having;
     };
 
+    // Invokable filters are applied to the instances after all rows have been read and
+    // instantiated. A query where the database cannot narrow down the rows is reported.
+    static void checkInvokableFilter(const QueryBuilderHelperPrivate& d,
+                                     const FoldedFilters& filters)
+    {
+        Q_ASSERT(d.m_projection.has_value());
+
+        if (d.m_limit.has_value() || d.m_offset.has_value())
+        {
+            qFatal("QtOrm: Invokable filters of %s cannot be combined with limit() or offset(): "
+                   "the rows would be limited before they are filtered",
+                   qPrintable(d.m_projection->className()));
+        }
+
+        if (!filters.expression.has_value())
+        {
+            qCWarning(qtorm).noquote()
+                << "Invokable filter without an expression filter: every row of"
+                << d.m_projection->className()
+                << "is read and instantiated before it is filtered. Use an expression filter to "
+                   "select the rows in the database.";
+        }
+    }
+
+    // The order of a keyset query: the object ID breaks ties between equal ordered properties.
+    static std::vector<QOrmOrder> keysetOrder(const QueryBuilderHelperPrivate& d)
+    {
+        Q_ASSERT(d.m_projection.has_value());
+
+        const QOrmPropertyMapping* objectIdMapping = d.m_projection->objectIdMapping();
+
+        if (objectIdMapping == nullptr)
+        {
+            qFatal("QtOrm: Keyset pagination requires an object ID in %s",
+                   qPrintable(d.m_projection->className()));
+        }
+
+        std::vector<QOrmOrder> order = d.m_order;
+
+        if (std::none_of(std::cbegin(order),
+                         std::cend(order),
+                         [](const QOrmOrder& o) { return o.mapping().isObjectId(); }))
+        {
+            order.emplace_back(*objectIdMapping, Qt::AscendingOrder);
+        }
+
+        return order;
+    }
+
+    static QOrmFilterExpression isNull(const QOrmPropertyMapping& mapping)
+    {
+        return QOrmFilterTerminalPredicate{mapping, QOrm::Comparison::Equal, QVariant{}};
+    }
+
+    // Selects the rows following the instance in the order, or preceding it if isBefore:
+    //   c1 > v1 OR (c1 = v1 AND c2 > v2) OR (c1 = v1 AND c2 = v2 AND id > vid)
+    // The leading c1 >= v1 lets the database seek to the instance with an index on c1. SQLite
+    // orders null values first, so where the rows are selected towards the beginning of the
+    // ascending order, a null value is past the instance as well: c < v OR c IS NULL.
+    static QOrmFilterExpression keysetExpression(const std::vector<QOrmOrder>& order,
+                                                 const QObject* instance,
+                                                 bool isBefore)
+    {
+        Q_ASSERT(!order.empty());
+
+        std::optional<QOrmFilterExpression> keyset;
+        std::optional<QOrmFilterExpression> equalPrefix;
+
+        for (const QOrmOrder& o : order)
+        {
+            QVariant value = QOrmPrivate::propertyValue(instance, o.mapping());
+
+            if (value.isNull() ||
+                (o.mapping().isReference() && value.value<QObject*>() == nullptr))
+            {
+                qFatal("QtOrm: Keyset pagination requires non-null values, but %s::%s is null",
+                       qPrintable(o.mapping().enclosingEntity().className()),
+                       qPrintable(o.mapping().classPropertyName()));
+            }
+
+            bool isForward = (o.direction() == Qt::AscendingOrder) != isBefore;
+            QOrmFilterExpression next = QOrmFilterTerminalPredicate{
+                o.mapping(),
+                isForward ? QOrm::Comparison::Greater : QOrm::Comparison::Less,
+                value};
+
+            if (!isForward && !o.mapping().isObjectId())
+                next = next || isNull(o.mapping());
+
+            if (equalPrefix.has_value())
+                next = *equalPrefix && next;
+
+            keyset = keyset.has_value() ? QOrmFilterExpression{*keyset || next} : next;
+
+            QOrmFilterExpression equal =
+                QOrmFilterTerminalPredicate{o.mapping(), QOrm::Comparison::Equal, value};
+            equalPrefix = equalPrefix.has_value() ? QOrmFilterExpression{*equalPrefix && equal}
+                                                  : equal;
+        }
+
+        if (order.size() == 1)
+            return *keyset;
+
+        const QOrmOrder& leading = order.front();
+        bool isForward = (leading.direction() == Qt::AscendingOrder) != isBefore;
+
+        QOrmFilterExpression seek = QOrmFilterTerminalPredicate{
+            leading.mapping(),
+            isForward ? QOrm::Comparison::GreaterOrEqual : QOrm::Comparison::LessOrEqual,
+            QOrmPrivate::propertyValue(instance, leading.mapping())};
+
+        if (!isForward && !leading.mapping().isObjectId())
+            seek = seek || isNull(leading.mapping());
+
+        return seek && *keyset;
+    }
+
+    static QOrmAggregate resolvedAggregate(const QOrmMetadata& projection,
+                                           const QOrmAggregate& aggregate)
+    {
+        if (aggregate.isResolved())
+            return aggregate;
+
+        const QOrmPropertyMapping* mapping =
+            projection.classPropertyMapping(aggregate.classProperty()->descriptor());
+
+        if (mapping == nullptr || mapping->isTransient())
+        {
+            qFatal("QtOrm: %s::%s cannot be aggregated",
+                   qPrintable(projection.className()),
+                   qPrintable(aggregate.classProperty()->descriptor()));
+        }
+
+        return QOrmAggregate{aggregate.function(), *mapping};
+    }
+
     QueryBuilderHelper::QueryBuilderHelper(QOrmSession* ormSession, const QOrmRelation& relation)
         : d{new QueryBuilderHelperPrivate{ormSession, relation}}
     {
@@ -158,29 +303,119 @@ namespace QOrmPrivate
         d->m_offset = offset;
     }
 
+    void QueryBuilderHelper::setKeyset(const QObject* instance, bool isBefore)
+    {
+        Q_ASSERT(instance != nullptr);
+
+        d->m_keysetInstance = instance;
+        d->m_isKeysetBefore = isBefore;
+    }
+
+    void QueryBuilderHelper::addColumn(const QOrmClassProperty& classProperty)
+    {
+        Q_ASSERT(d->m_projection.has_value());
+
+        const QOrmPropertyMapping* mapping =
+            d->m_projection->classPropertyMapping(classProperty.descriptor());
+
+        if (mapping == nullptr)
+        {
+            qFatal("QtOrm: %s has no property %s",
+                   qPrintable(d->m_projection->className()),
+                   qPrintable(classProperty.descriptor()));
+        }
+
+        // the object ID is always read to identify the entity instances
+        if (d->m_columns.empty() && d->m_projection->objectIdMapping() != nullptr &&
+            !mapping->isObjectId())
+        {
+            d->m_columns.push_back(*d->m_projection->objectIdMapping());
+        }
+
+        d->m_columns.push_back(*mapping);
+    }
+
+    void QueryBuilderHelper::addGroupBy(const QOrmClassProperty& classProperty)
+    {
+        Q_ASSERT(d->m_projection.has_value());
+
+        const QOrmPropertyMapping* mapping =
+            d->m_projection->classPropertyMapping(classProperty.descriptor());
+
+        if (mapping == nullptr || mapping->isTransient())
+        {
+            qFatal("QtOrm: %s::%s cannot be grouped by",
+                   qPrintable(d->m_projection->className()),
+                   qPrintable(classProperty.descriptor()));
+        }
+
+        d->m_groupBy.push_back(*mapping);
+    }
+
+    void QueryBuilderHelper::addHaving(const QOrmAggregate& aggregate,
+                                       QOrm::Comparison comparison,
+                                       const QVariant& value)
+    {
+        Q_ASSERT(d->m_projection.has_value());
+
+        d->m_having.emplace_back(resolvedAggregate(*d->m_projection, aggregate), comparison, value);
+    }
+
     QOrmQuery QueryBuilderHelper::build(QOrm::Operation operation, QOrm::QueryFlags flags) const
     {
         if (operation == QOrm::Operation::Merge ||  //
             operation == QOrm::Operation::Create || //
-            operation == QOrm::Operation::Update || //
+            operation == QOrm::Operation::Upsert || //
+            (operation == QOrm::Operation::Update && d->m_entityInstance != nullptr) || //
             (operation == QOrm::Operation::Delete && d->m_entityInstance != nullptr))
         {
             Q_ASSERT(d->m_entityInstance != nullptr);
 
             return QOrmQuery{operation, *d->m_relation.mapping(), d->m_entityInstance};
         }
-        else if (operation == QOrm::Operation::Read || operation == QOrm::Operation::Delete)
+        else if (operation == QOrm::Operation::Read || operation == QOrm::Operation::Update ||
+                 operation == QOrm::Operation::Delete)
         {
             FoldedFilters filters = foldFilters(d->m_relation, d->m_filters);
+
+            if (operation == QOrm::Operation::Read && filters.invokable.has_value())
+                checkInvokableFilter(*d, filters);
+
+            std::vector<QOrmOrder> order = d->m_order;
+
+            if (d->m_keysetInstance != nullptr)
+            {
+                order = keysetOrder(*d);
+                QOrmFilterExpression keyset =
+                    keysetExpression(order, d->m_keysetInstance, d->m_isKeysetBefore);
+
+                filters.expression = filters.expression.has_value()
+                                         ? QOrmFilter{*filters.expression->expression() && keyset}
+                                         : QOrmFilter{keyset};
+
+                // the rows right before the instance are read backwards; select() restores the
+                // order
+                if (d->m_isKeysetBefore)
+                {
+                    for (QOrmOrder& o : order)
+                    {
+                        o = QOrmOrder{o.mapping(),
+                                      o.direction() == Qt::AscendingOrder ? Qt::DescendingOrder
+                                                                          : Qt::AscendingOrder};
+                    }
+                }
+            }
+
             QOrmQuery query = QOrmQuery{operation,
                                         d->m_relation,
                                         d->m_projection,
                                         filters.expression,
                                         filters.invokable,
-                                        d->m_order,
+                                        order,
                                         flags};
             query.setLimit(d->m_limit);
             query.setOffset(d->m_offset);
+            query.setColumns(d->m_columns);
             return query;
         }
 
@@ -189,13 +424,103 @@ namespace QOrmPrivate
 
     QOrmQueryResult<QObject> QueryBuilderHelper::select(QOrm::QueryFlags flags) const
     {
-        return d->m_session->execute(build(QOrm::Operation::Read, flags));
+        QOrmQueryResult<QObject> result =
+            d->m_session->execute(build(QOrm::Operation::Read, flags));
+
+        if (d->m_keysetInstance == nullptr || !d->m_isKeysetBefore || result.hasError())
+            return result;
+
+        QVector<QObject*> instances = result.toVector();
+        std::reverse(std::begin(instances), std::end(instances));
+
+        return QOrmQueryResult<QObject>{instances, result.numRowsAffected()};
+    }
+
+    std::unique_ptr<QOrmAbstractCursor> QueryBuilderHelper::stream(QOrm::QueryFlags flags) const
+    {
+        if (d->m_keysetInstance != nullptr && d->m_isKeysetBefore)
+            qFatal("QtOrm: Queries with QOrmQueryBuilder::before() cannot be streamed");
+
+        return d->m_session->openCursor(build(QOrm::Operation::Read, flags));
     }
 
     QOrmQueryResult<QObject> QueryBuilderHelper::remove() const
     {
         return d->m_session->execute(build(QOrm::Operation::Delete, QOrm::QueryFlags::None));
     }
+
+    QOrmQueryResult<QObject> QueryBuilderHelper::update(
+        std::initializer_list<std::pair<QOrmClassProperty, QVariant>> assignments) const
+    {
+        Q_ASSERT(d->m_relation.type() == QOrm::RelationType::Mapping);
+        Q_ASSERT(d->m_entityInstance == nullptr);
+
+        const QOrmMetadata& entity = *d->m_relation.mapping();
+        std::vector<std::pair<QOrmPropertyMapping, QVariant>> mappedAssignments;
+
+        for (const auto& [classProperty, value] : assignments)
+        {
+            const QOrmPropertyMapping* mapping =
+                entity.classPropertyMapping(classProperty.descriptor());
+
+            if (mapping == nullptr || mapping->isTransient() || mapping->isObjectId())
+            {
+                qFatal("QtOrm: %s::%s cannot be assigned by an update",
+                       qPrintable(entity.className()),
+                       qPrintable(classProperty.descriptor()));
+            }
+
+            mappedAssignments.emplace_back(*mapping, value);
+        }
+
+        QOrmQuery query = build(QOrm::Operation::Update, QOrm::QueryFlags::None);
+        query.setAssignments(mappedAssignments);
+
+        return d->m_session->execute(query);
+    }
+
+    QVariant QueryBuilderHelper::aggregate(const QOrmAggregate& aggregate,
+                                           std::optional<int> limit) const
+    {
+        if (!d->m_groupBy.empty())
+            qFatal("QtOrm: Grouped queries must be read with QOrmQueryBuilder::aggregate()");
+
+        QOrmQuery query = build(QOrm::Operation::Read, QOrm::QueryFlags::None);
+        query.setAggregates({resolvedAggregate(*d->m_projection, aggregate)});
+
+        if (limit.has_value())
+            query.setLimit(qMin(d->m_limit.value_or(*limit), *limit));
+
+        QOrmQueryResult<QObject> result = d->m_session->execute(query);
+
+        if (result.hasError())
+            return QVariant{};
+
+        Q_ASSERT(result.values().size() == 1 && result.values().front().size() == 1);
+
+        return result.values().front().front();
+    }
+
+    QOrmQueryResult<QObject> QueryBuilderHelper::aggregate(
+        std::initializer_list<QOrmAggregate> aggregates) const
+    {
+        Q_ASSERT(aggregates.size() > 0);
+
+        if (!d->m_having.empty() && d->m_groupBy.empty())
+            qFatal("QtOrm: having() requires groupBy()");
+
+        std::vector<QOrmAggregate> resolvedAggregates;
+
+        for (const QOrmAggregate& aggregate : aggregates)
+            resolvedAggregates.push_back(resolvedAggregate(*d->m_projection, aggregate));
+
+        QOrmQuery query = build(QOrm::Operation::Read, QOrm::QueryFlags::None);
+        query.setAggregates(resolvedAggregates);
+        query.setGroupBy(d->m_groupBy);
+        query.setHaving(d->m_having);
+
+        return d->m_session->execute(query);
+    }
 } // namespace QOrmPrivate
 
 QT_END_NAMESPACE
@@ -21,17 +21,24 @@
 #ifndef QORMQUERYBUILDER_H
 #define QORMQUERYBUILDER_H
 
+#include <QtOrm/qormaggregate.h>
 #include <QtOrm/qormfilter.h>
 #include <QtOrm/qormfilterexpression.h>
 #include <QtOrm/qormglobal.h>
 #include <QtOrm/qormquery.h>
+#include <QtOrm/qormquerycursor.h>
 #include <QtOrm/qormqueryresult.h>
 
 #include <QtCore/qobject.h>
 #include <QtCore/qshareddata.h>
+#include <QtCore/qvariant.h>
 #include <QtCore/qvector.h>
 
+#include <initializer_list>
 #include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
 
 QT_BEGIN_NAMESPACE
 
@@ -62,6 +69,12 @@ namespace QOrmPrivate
         void addOrder(const QOrmClassProperty& classProperty, Qt::SortOrder direction);
         void setLimit(int limit);
         void setOffset(int offset);
+        void setKeyset(const QObject* instance, bool isBefore);
+        void addColumn(const QOrmClassProperty& classProperty);
+        void addGroupBy(const QOrmClassProperty& classProperty);
+        void addHaving(const QOrmAggregate& aggregate,
+                       QOrm::Comparison comparison,
+                       const QVariant& value);
 
         Q_REQUIRED_RESULT
         QOrmQuery build(QOrm::Operation operation, QOrm::QueryFlags flags) const;
@@ -69,7 +82,17 @@ namespace QOrmPrivate
         Q_REQUIRED_RESULT
         QOrmQueryResult<QObject> select(QOrm::QueryFlags flags) const;
 
+        Q_REQUIRED_RESULT
+        std::unique_ptr<QOrmAbstractCursor> stream(QOrm::QueryFlags flags) const;
+
         [[nodiscard]] QOrmQueryResult<QObject> remove() const;
+        [[nodiscard]] QOrmQueryResult<QObject> update(
+            std::initializer_list<std::pair<QOrmClassProperty, QVariant>> assignments) const;
+
+        [[nodiscard]] QVariant aggregate(const QOrmAggregate& aggregate,
+                                         std::optional<int> limit = std::nullopt) const;
+        [[nodiscard]] QOrmQueryResult<QObject> aggregate(
+            std::initializer_list<QOrmAggregate> aggregates) const;
 
     private:
         std::unique_ptr<QueryBuilderHelperPrivate> d;
@@ -142,14 +165,140 @@ public:
         return *this;
     }
 
+    // Keyset pagination: selects only the rows following the entity instance in the order given
+    // by order() and then by the object ID. Unlike offset(), the skipped rows are not scanned, and
+    // pages stay stable when rows are inserted before them. The ordered properties of the instance
+    // must not be null. The instance must stay alive until the query is executed.
+    QOrmQueryBuilder& after(const Projection* instance)
+    {
+        m_helper.setKeyset(instance, false);
+        return *this;
+    }
+
+    // Like after(), but selects the rows preceding the entity instance. With limit(), these are
+    // the rows right before the instance. The result keeps the order given by order(). Cannot be
+    // streamed.
+    QOrmQueryBuilder& before(const Projection* instance)
+    {
+        m_helper.setKeyset(instance, true);
+        return *this;
+    }
+
+    // Reads only the given properties and the object ID. The other properties of new entity
+    // instances are left unfetched and can be loaded with QOrmSession::load().
+    template<typename... ClassProperties>
+    QOrmQueryBuilder& columns(const QOrmClassProperty& classProperty,
+                              const ClassProperties&... classProperties)
+    {
+        static_assert((std::is_convertible_v<ClassProperties, QOrmClassProperty> && ...),
+                      "columns() requires properties declared with Q_ORM_CLASS_PROPERTY()");
+
+        m_helper.addColumn(classProperty);
+        (m_helper.addColumn(classProperties), ...);
+        return *this;
+    }
+
     Q_REQUIRED_RESULT
     QOrmQueryResult<Projection> select(QOrm::QueryFlags flags = QOrm::QueryFlags::None) const
     {
         return m_helper.select(flags);
     }
 
+    // Reads the result row by row instead of all at once. With
+    // QOrm::QueryFlags::EvictStreamedInstances, the entity instances read by the cursor for a chunk
+    // of rows, including those read for their references, are deleted once the cursor reads the
+    // next chunk or is destroyed: the caller may not keep pointers to them. Modified, pinned and
+    // pending instances stay cached. References of cached instances to deleted instances become
+    // unfetched.
+    Q_REQUIRED_RESULT
+    QOrmQueryCursor<Projection> stream(QOrm::QueryFlags flags = QOrm::QueryFlags::None) const
+    {
+        return QOrmQueryCursor<Projection>{m_helper.stream(flags)};
+    }
+
     [[nodiscard]] QOrmQueryResult<Projection> remove() { return m_helper.remove(); }
 
+    // Assigns values to the properties of all rows matching the filters with a single UPDATE
+    // statement. References are assigned entity instances or object IDs. Cached entity instances
+    // of the updated rows receive the new values; their modifications of other properties are
+    // kept. The one-to-many collections referring to them are not updated.
+    [[nodiscard]] QOrmQueryResult<Projection> update(
+        std::initializer_list<std::pair<QOrmClassProperty, QVariant>> assignments)
+    {
+        return m_helper.update(assignments);
+    }
+
+    // Aggregates of the rows matching the filters, computed by the database without reading entity
+    // instances. With limit() or offset(), only the rows of the selected page are aggregated. On
+    // error, the last error of the session is set, count() returns -1 and the other aggregates
+    // return an invalid QVariant. Aggregates of no rows other than count() are null. Invokable
+    // filters are unsupported.
+    [[nodiscard]] qint64 count() const
+    {
+        QVariant value = m_helper.aggregate(QOrmAggregate{QOrm::AggregateFunction::Count});
+        return value.isValid() ? value.toLongLong() : -1;
+    }
+
+    [[nodiscard]] bool exists() const
+    {
+        QVariant value = m_helper.aggregate(QOrmAggregate{QOrm::AggregateFunction::Count}, 1);
+        return value.toLongLong() > 0;
+    }
+
+    [[nodiscard]] QVariant sum(const QOrmClassProperty& classProperty) const
+    {
+        return m_helper.aggregate(QOrmAggregate{QOrm::AggregateFunction::Sum, classProperty});
+    }
+
+    [[nodiscard]] QVariant min(const QOrmClassProperty& classProperty) const
+    {
+        return m_helper.aggregate(QOrmAggregate{QOrm::AggregateFunction::Min, classProperty});
+    }
+
+    [[nodiscard]] QVariant max(const QOrmClassProperty& classProperty) const
+    {
+        return m_helper.aggregate(QOrmAggregate{QOrm::AggregateFunction::Max, classProperty});
+    }
+
+    [[nodiscard]] QVariant avg(const QOrmClassProperty& classProperty) const
+    {
+        return m_helper.aggregate(QOrmAggregate{QOrm::AggregateFunction::Avg, classProperty});
+    }
+
+    // Groups the rows for aggregate(). A reference is grouped by the object ID of the referenced
+    // entity.
+    template<typename... ClassProperties>
+    QOrmQueryBuilder& groupBy(const QOrmClassProperty& classProperty,
+                              const ClassProperties&... classProperties)
+    {
+        static_assert((std::is_convertible_v<ClassProperties, QOrmClassProperty> && ...),
+                      "groupBy() requires properties declared with Q_ORM_CLASS_PROPERTY()");
+
+        m_helper.addGroupBy(classProperty);
+        (m_helper.addGroupBy(classProperties), ...);
+        return *this;
+    }
+
+    // Keeps only the groups whose aggregate compares to the value; several conditions must all
+    // hold. Requires groupBy().
+    QOrmQueryBuilder& having(const QOrmAggregate& aggregate,
+                             QOrm::Comparison comparison,
+                             const QVariant& value)
+    {
+        m_helper.addHaving(aggregate, comparison, value);
+        return *this;
+    }
+
+    // Reads the aggregates without creating entity instances. The result has a row per group, or
+    // a single row without groupBy(). Each row of values() holds the grouped properties in the
+    // order of groupBy(), followed by the aggregates. With groups, order(), limit() and offset()
+    // apply to the groups and can only order by grouped properties.
+    [[nodiscard]] QOrmQueryResult<void> aggregate(
+        std::initializer_list<QOrmAggregate> aggregates) const
+    {
+        return m_helper.aggregate(aggregates);
+    }
+
     Q_REQUIRED_RESULT
     QOrmQuery build(QOrm::Operation operation, QOrm::QueryFlags flags = QOrm::QueryFlags::None) const { return m_helper.build(operation, flags); }
 
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2019-2022 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QORMQUERYCURSOR_H
+#define QORMQUERYCURSOR_H
+
+#include <QtOrm/qormabstractprovider.h>
+#include <QtOrm/qormerror.h>
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qobject.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+// Forward-only result of QOrmQueryBuilder::stream(). Entity instances are read from the database
+// while advancing, so that the result is never held in memory as a whole. The cursor must not
+// outlive the session it was opened in.
+template<typename T>
+class QOrmQueryCursor
+{
+public:
+    using Projection = T;
+    static_assert(std::is_convertible_v<Projection*, QObject*>,
+                  "Projection entity must be inherited from QObject");
+
+    explicit QOrmQueryCursor(std::unique_ptr<QOrmAbstractCursor> cursor)
+        : m_cursor{std::move(cursor)}
+    {
+        Q_ASSERT(m_cursor != nullptr);
+    }
+
+    QOrmQueryCursor(const QOrmQueryCursor&) = delete;
+    QOrmQueryCursor(QOrmQueryCursor&&) = default;
+
+    QOrmQueryCursor& operator=(const QOrmQueryCursor&) = delete;
+    QOrmQueryCursor& operator=(QOrmQueryCursor&&) = default;
+
+    // Advances to the next entity instance. Returns false at the end of the result or if an error
+    // occurred.
+    [[nodiscard]] bool next()
+    {
+        m_current = qobject_cast<Projection*>(m_cursor->next());
+        return m_current != nullptr;
+    }
+
+    [[nodiscard]] Projection* current() const { return m_current; }
+
+    [[nodiscard]] QOrmError error() const { return m_cursor->error(); }
+    [[nodiscard]] bool hasError() const { return error().type() != QOrm::ErrorType::None; }
+
+private:
+    std::unique_ptr<QOrmAbstractCursor> m_cursor;
+    Projection* m_current{nullptr};
+};
+
+QT_END_NAMESPACE
+
+#endif // QORMQUERYCURSOR_H
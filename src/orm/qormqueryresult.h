@@ -45,19 +45,25 @@ namespace QtOrmPrivate
         [[nodiscard]] int numRowsAffected() const { return m_numRowsAffected; }
         [[nodiscard]] bool hasError() const { return m_error.type() != QOrm::ErrorType::None; }
 
+        // The rows read by a query with aggregates
+        [[nodiscard]] const QVector<QVariantList>& values() const { return m_values; }
+
     protected:
         QOrmQueryResultBase(const QOrmError& error,
                             const QVariant& lastInsertedId,
-                            int numRowsAffected)
+                            int numRowsAffected,
+                            const QVector<QVariantList>& values = {})
             : m_error{error}
             , m_lastInsertedId{lastInsertedId}
             , m_numRowsAffected{numRowsAffected}
+            , m_values{values}
         {
         }
 
         QOrmError m_error;
         QVariant m_lastInsertedId;
         int m_numRowsAffected{0};
+        QVector<QVariantList> m_values;
     };
 } // namespace QtOrmPrivate
 
@@ -81,7 +87,8 @@ public:
     QOrmQueryResult(const QOrmQueryResult<U>& other)
         : QtOrmPrivate::QOrmQueryResultBase<T>{other.error(),
                                                other.lastInsertedId(),
-                                               other.numRowsAffected()}
+                                               other.numRowsAffected(),
+                                               other.values()}
         , m_result{convertVector<U, T>(other.toVector())}
     {
     }
@@ -114,6 +121,11 @@ public:
     {
     }
 
+    explicit QOrmQueryResult(const QVector<QVariantList>& values)
+        : QtOrmPrivate::QOrmQueryResultBase<T>{{}, {}, static_cast<int>(values.size()), values}
+    {
+    }
+
     QOrmQueryResult& operator=(const QOrmQueryResult&) = delete;
     QOrmQueryResult& operator=(QOrmQueryResult&&) = default;
 
@@ -235,7 +247,7 @@ class QOrmQueryResult<void> : public QtOrmPrivate::QOrmQueryResultBase<void>
 public:
     template<typename U>
     QOrmQueryResult(const QOrmQueryResult<U>& other)
-        : Base{other.error(), other.lastInsertedId(), other.numRowsAffected()}
+        : Base{other.error(), other.lastInsertedId(), other.numRowsAffected(), other.values()}
     {
     }
 };
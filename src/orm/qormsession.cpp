@@ -29,16 +29,30 @@
 #include "qormquery.h"
 #include "qormrelation.h"
 #include "qormsessionconfiguration.h"
+#include "qormsessionnotifier.h"
 #include "qormtransactiontoken.h"
 
 #include <QDebug>
 #include <QScopeGuard>
 
+#include <algorithm>
+#include <functional>
+#include <tuple>
+
 QT_BEGIN_NAMESPACE
 
 class QOrmSessionPrivate
 {
     using TrackedEntityInstance = std::pair<QObject*, QOrm::Operation>;
+    using PendingEntityInstance = std::pair<QObject*, const QMetaObject*>;
+
+    struct Change
+    {
+        const QMetaObject* entity;
+        QVariant objectId;
+        QOrm::Operation operation;
+        bool isCancelled{false};
+    };
 
     Q_DECLARE_PUBLIC(QOrmSession)
     QOrmSession* q_ptr{nullptr};
@@ -49,6 +63,14 @@ class QOrmSessionPrivate
     QSet<const QObject*> m_mergingInstances;
     int m_transactionCounter{0};
     std::vector<TrackedEntityInstance> m_trackedInstances;
+    QOrm::FlushMode m_flushMode{QOrm::FlushMode::Immediate};
+    // FlushMode::Deferred: instances registered by merge(), in order of registration
+    std::vector<PendingEntityInstance> m_pendingInstances;
+    QSet<const QObject*> m_pendingInstanceSet;
+    QOrmSessionNotifier m_notifier;
+    // writes not committed yet, and the latest write of every instance which was not removed
+    std::vector<Change> m_changes;
+    QHash<const QObject*, size_t> m_instanceChanges;
 
     explicit QOrmSessionPrivate(QOrmSessionConfiguration sessionConfiguration, QOrmSession* parent);
     ~QOrmSessionPrivate();
@@ -65,6 +87,18 @@ class QOrmSessionPrivate
 
     void commitTrackedInstances();
     void rollbackTrackedInstances();
+    void trimEntityInstanceCache();
+
+    void addPendingInstance(QObject* instance, const QMetaObject& qMetaObject);
+    bool removePendingInstance(QObject* instance);
+    bool insertEntityInstances(const QOrmMetadata& entity, const QVector<QObject*>& instances);
+    bool ensureObjectIdNotCached(const QOrmMetadata& entity, const QObject* instance);
+
+    void recordChange(const QOrmMetadata& entity,
+                      const QObject* instance,
+                      QOrm::Operation operation);
+    void publishChanges();
+    void discardChanges();
 
     void clearLastError();
     void setLastError(QOrmError lastError);
@@ -75,6 +109,8 @@ QOrmSessionPrivate::QOrmSessionPrivate(QOrmSessionConfiguration sessionConfigura
     : q_ptr{parent}
     , m_sessionConfiguration{std::move(sessionConfiguration)}
 {
+    m_entityInstanceCache.setMaxSize(m_sessionConfiguration.entityInstanceCacheSize());
+    m_entityInstanceCache.setChangeTracking(m_sessionConfiguration.changeTracking());
 }
 
 QOrmSessionPrivate::~QOrmSessionPrivate() = default;
@@ -124,6 +160,256 @@ void QOrmSessionPrivate::rollbackTrackedInstances()
     m_trackedInstances.clear();
 }
 
+// Instances are evicted only outside of transactions and merges, when no tracked instance or
+// instance being merged can refer to them.
+void QOrmSessionPrivate::trimEntityInstanceCache()
+{
+    if (m_transactionCounter == 0 && m_mergingInstances.isEmpty())
+        m_entityInstanceCache.trim();
+}
+
+void QOrmSessionPrivate::addPendingInstance(QObject* instance, const QMetaObject& qMetaObject)
+{
+    if (m_pendingInstanceSet.contains(instance))
+        return;
+
+    m_pendingInstanceSet.insert(instance);
+    m_pendingInstances.push_back(std::make_pair(instance, &qMetaObject));
+
+    // trim() must not evict an instance which is about to be flushed, even if it is unmodified
+    m_entityInstanceCache.pin(instance);
+}
+
+bool QOrmSessionPrivate::removePendingInstance(QObject* instance)
+{
+    if (!m_pendingInstanceSet.remove(instance))
+        return false;
+
+    m_entityInstanceCache.unpin(instance);
+
+    m_pendingInstances.erase(std::remove_if(std::begin(m_pendingInstances),
+                                            std::end(m_pendingInstances),
+                                            [instance](const PendingEntityInstance& pending) {
+                                                return pending.first == instance;
+                                            }),
+                             std::end(m_pendingInstances));
+
+    return true;
+}
+
+// Inserts new instances of one entity with multi-row INSERT statements. Instances with an assigned
+// object ID are upserted, so that the rows which already exist are updated. Referenced instances
+// must have been merged before.
+bool QOrmSessionPrivate::insertEntityInstances(const QOrmMetadata& entity,
+                                               const QVector<QObject*>& instances)
+{
+    QVector<QObject*> createdInstances;
+    QVector<QObject*> upsertedInstances;
+
+    for (QObject* entityInstance : instances)
+    {
+        if (QOrmPrivate::hasAssignedObjectId(entityInstance, entity))
+        {
+            if (!ensureObjectIdNotCached(entity, entityInstance))
+                return false;
+
+            upsertedInstances.push_back(entityInstance);
+        }
+        else
+            createdInstances.push_back(entityInstance);
+    }
+
+    if (!upsertedInstances.isEmpty())
+    {
+        QOrmQueryResult result = m_sessionConfiguration.provider()->execute(
+            QOrmQuery{QOrm::Operation::Upsert, entity, upsertedInstances}, m_entityInstanceCache);
+
+        setLastError(result.error());
+
+        if (m_lastError.type() != QOrm::ErrorType::None)
+            return false;
+    }
+
+    if (!createdInstances.isEmpty())
+    {
+        QOrmQueryResult result = m_sessionConfiguration.provider()->execute(
+            QOrmQuery{QOrm::Operation::Create, entity, createdInstances}, m_entityInstanceCache);
+
+        setLastError(result.error());
+
+        if (m_lastError.type() != QOrm::ErrorType::None)
+            return false;
+
+        const QOrmPropertyMapping* objectIdMapping = entity.objectIdMapping();
+
+        if (objectIdMapping != nullptr && objectIdMapping->isAutogenerated())
+        {
+            QVariantList insertedIds = result.lastInsertedId().toList();
+            Q_ASSERT(insertedIds.size() == createdInstances.size());
+
+            for (int i = 0; i < createdInstances.size(); ++i)
+            {
+                if (!QOrmPrivate::setPropertyValue(createdInstances[i],
+                                                   *objectIdMapping,
+                                                   insertedIds[i]))
+                {
+                    Q_ORM_UNEXPECTED_STATE;
+                }
+            }
+        }
+    }
+
+    for (QObject* entityInstance : upsertedInstances)
+        recordChange(entity, entityInstance, QOrm::Operation::Upsert);
+
+    for (QObject* entityInstance : createdInstances)
+        recordChange(entity, entityInstance, QOrm::Operation::Create);
+
+    for (QObject* entityInstance : instances)
+    {
+        m_entityInstanceCache.insert(entity, entityInstance);
+        m_entityInstanceCache.finalize(entity, entityInstance);
+        m_trackedInstances.push_back(std::make_pair(entityInstance, QOrm::Operation::Merge));
+    }
+
+    return true;
+}
+
+// An upserted instance must not replace another instance of the same row in the cache.
+bool QOrmSessionPrivate::ensureObjectIdNotCached(const QOrmMetadata& entity,
+                                                 const QObject* instance)
+{
+    if (m_entityInstanceCache.get(entity, QOrmPrivate::objectIdPropertyValue(instance, entity)) ==
+        nullptr)
+    {
+        return true;
+    }
+
+    setLastError({QOrm::ErrorType::UnsynchronizedEntity,
+                  QStringLiteral("Another instance with the same object ID is already cached")});
+
+    return false;
+}
+
+// Upserts are recorded as QOrm::Operation::Merge. A later write of the same instance is
+// coalesced with the recorded one: only the removal of an instance overrides the recorded write.
+// Updates and removals with a filter are recorded without an instance.
+void QOrmSessionPrivate::recordChange(const QOrmMetadata& entity,
+                                      const QObject* instance,
+                                      QOrm::Operation operation)
+{
+    auto it = m_instanceChanges.find(instance);
+
+    if (instance != nullptr && it != std::end(m_instanceChanges))
+    {
+        Change& change = m_changes[it.value()];
+
+        if (operation == QOrm::Operation::Delete)
+        {
+            if (change.operation == QOrm::Operation::Create)
+                change.isCancelled = true;
+            else
+                change.operation = QOrm::Operation::Delete;
+
+            // a removed instance may be deleted and its address reused
+            m_instanceChanges.erase(it);
+        }
+
+        return;
+    }
+
+    QVariant objectId = instance != nullptr && entity.objectIdMapping() != nullptr
+                            ? QOrmPrivate::objectIdPropertyValue(instance, entity)
+                            : QVariant{};
+
+    m_changes.push_back(Change{&entity.qMetaObject(),
+                               objectId,
+                               operation == QOrm::Operation::Upsert ? QOrm::Operation::Merge
+                                                                    : operation});
+
+    if (instance != nullptr && operation != QOrm::Operation::Delete)
+        m_instanceChanges.insert(instance, m_changes.size() - 1);
+}
+
+// Groups the recorded writes by entity and operation. The entities come in the order of their
+// first write.
+void QOrmSessionPrivate::publishChanges()
+{
+    std::vector<Change> changes;
+    std::swap(changes, m_changes);
+    m_instanceChanges.clear();
+
+    auto operationRank = [](QOrm::Operation operation) {
+        switch (operation)
+        {
+            case QOrm::Operation::Delete:
+                return 0;
+            case QOrm::Operation::Create:
+                return 1;
+            case QOrm::Operation::Merge:
+                return 2;
+            default:
+                return 3;
+        }
+    };
+
+    QHash<const QMetaObject*, int> entityRanks;
+    QHash<QPair<const QMetaObject*, int>, int> changeSetIndexes;
+    QVector<std::tuple<int, int, const QMetaObject*, QOrm::Operation, QVariantList>> changeSets;
+
+    for (const Change& change : changes)
+    {
+        if (change.isCancelled)
+            continue;
+
+        if (!entityRanks.contains(change.entity))
+            entityRanks.insert(change.entity, entityRanks.size());
+
+        auto key = qMakePair(change.entity, static_cast<int>(change.operation));
+        auto it = changeSetIndexes.find(key);
+
+        if (it == std::end(changeSetIndexes))
+        {
+            it = changeSetIndexes.insert(key, changeSets.size());
+            changeSets.push_back(std::make_tuple(entityRanks.value(change.entity),
+                                                 operationRank(change.operation),
+                                                 change.entity,
+                                                 change.operation,
+                                                 QVariantList{}));
+        }
+
+        if (change.objectId.isValid())
+            std::get<4>(changeSets[it.value()]).push_back(change.objectId);
+    }
+
+    if (changeSets.isEmpty())
+        return;
+
+    std::sort(std::begin(changeSets), std::end(changeSets), [](const auto& lhs, const auto& rhs) {
+        return std::make_pair(std::get<0>(lhs), std::get<1>(lhs)) <
+               std::make_pair(std::get<0>(rhs), std::get<1>(rhs));
+    });
+
+    QVector<QOrmChangeSet> result;
+    result.reserve(changeSets.size());
+
+    for (auto& [entityRank, operationRank, entity, operation, objectIds] : changeSets)
+    {
+        Q_UNUSED(entityRank)
+        Q_UNUSED(operationRank)
+
+        result.push_back(QOrmChangeSet{*entity, operation, std::move(objectIds)});
+    }
+
+    Q_EMIT m_notifier.changed(result);
+}
+
+void QOrmSessionPrivate::discardChanges()
+{
+    m_changes.clear();
+    m_instanceChanges.clear();
+}
+
 void QOrmSessionPrivate::clearLastError()
 {
     m_lastError = QOrmError{QOrm::ErrorType::None, {}};
@@ -143,6 +429,20 @@ QOrmSession::~QOrmSession()
 {
     Q_D(QOrmSession);
 
+    if (!d->m_pendingInstances.empty())
+    {
+        qCWarning(qtorm) << "Discarding" << d->m_pendingInstances.size()
+                         << "entity instances which were not flushed";
+
+        for (auto& [instance, qMetaObject] : d->m_pendingInstances)
+        {
+            Q_UNUSED(qMetaObject)
+
+            if (!d->m_entityInstanceCache.contains(instance))
+                delete instance;
+        }
+    }
+
     if (d->m_sessionConfiguration.provider()->isConnectedToBackend())
         d->m_sessionConfiguration.provider()->disconnectFromBackend();
 
@@ -160,9 +460,32 @@ QOrmQueryResult<QObject> QOrmSession::execute(const QOrmQuery& query)
         d->m_sessionConfiguration.provider()->execute(query, d->m_entityInstanceCache);
 
     d->setLastError(providerResult.error());
+    d->trimEntityInstanceCache();
+
+    if ((query.operation() == QOrm::Operation::Update ||
+         query.operation() == QOrm::Operation::Delete) &&
+        query.entityInstance() == nullptr && query.relation().mapping() != nullptr &&
+        d->m_lastError.type() == QOrm::ErrorType::None)
+    {
+        d->recordChange(*query.relation().mapping(), nullptr, query.operation());
+
+        if (d->m_transactionCounter == 0)
+            d->publishChanges();
+    }
+
     return providerResult;
 }
 
+std::unique_ptr<QOrmAbstractCursor> QOrmSession::openCursor(const QOrmQuery& query)
+{
+    Q_D(QOrmSession);
+
+    d->clearLastError();
+    d->ensureProviderConnected();
+
+    return d->m_sessionConfiguration.provider()->openCursor(query, d->m_entityInstanceCache);
+}
+
 QOrmQueryBuilder<QObject> QOrmSession::from(const QOrmQuery& query)
 {
     Q_ASSERT(query.operation() == QOrm::Operation::Read);
@@ -183,6 +506,13 @@ bool QOrmSession::doMerge(QObject* entityInstance, const QMetaObject& qMetaObjec
 
     Q_ASSERT(entityInstance != nullptr);
 
+    if (d->m_flushMode == QOrm::FlushMode::Deferred)
+    {
+        d->clearLastError();
+        d->addPendingInstance(entityInstance, qMetaObject);
+        return true;
+    }
+
     if (d->m_mergingInstances.contains(entityInstance))
         return true;
 
@@ -199,9 +529,14 @@ bool QOrmSession::doMerge(QObject* entityInstance, const QMetaObject& qMetaObjec
     d->clearLastError();
     d->ensureProviderConnected();
 
+    QOrmMetadata entity = d->m_metadataCache[qMetaObject];
+
+    // an instance with an assigned object ID may have been read by another session
     QOrm::Operation operation = d->m_entityInstanceCache.contains(entityInstance)
                                     ? QOrm::Operation::Update
-                                    : QOrm::Operation::Create;
+                                    : QOrmPrivate::hasAssignedObjectId(entityInstance, entity)
+                                          ? QOrm::Operation::Upsert
+                                          : QOrm::Operation::Create;
 
     if (operation == QOrm::Operation::Update &&
         !d->m_entityInstanceCache.isModified(entityInstance))
@@ -209,9 +544,11 @@ bool QOrmSession::doMerge(QObject* entityInstance, const QMetaObject& qMetaObjec
         return true;
     }
 
-    QOrmMetadata entity = d->m_metadataCache[qMetaObject];
+    if (operation == QOrm::Operation::Upsert && !d->ensureObjectIdNotCached(entity, entityInstance))
+        return false;
 
-    if (auto result = QOrmPrivate::crossReferenceError(entity, entityInstance))
+    if (auto result =
+            QOrmPrivate::crossReferenceError(entity, entityInstance, &d->m_entityInstanceCache))
     {
         qFatal("QtOrm: %s", result->toUtf8().data());
     }
@@ -241,15 +578,16 @@ bool QOrmSession::doMerge(QObject* entityInstance, const QMetaObject& qMetaObjec
 
     if (d->m_lastError.type() == QOrm::ErrorType::None)
     {
-        if (operation == QOrm::Operation::Create)
+        if (operation != QOrm::Operation::Update)
         {
             const QOrmPropertyMapping* objectIdMapping =
                 d->m_metadataCache[qMetaObject].objectIdMapping();
 
-            if (objectIdMapping != nullptr && objectIdMapping->isAutogenerated())
+            if (operation == QOrm::Operation::Create && objectIdMapping != nullptr &&
+                objectIdMapping->isAutogenerated())
             {
                 if (!QOrmPrivate::setPropertyValue(entityInstance,
-                                                   objectIdMapping->classPropertyName(),
+                                                   *objectIdMapping,
                                                    result.lastInsertedId()))
                 {
                     Q_ORM_UNEXPECTED_STATE;
@@ -262,17 +600,110 @@ bool QOrmSession::doMerge(QObject* entityInstance, const QMetaObject& qMetaObjec
         else
             d->m_entityInstanceCache.markUnmodified(entityInstance);
 
+        d->recordChange(entity, entityInstance, operation);
         token.commit();
     }
 
     return d->m_lastError.type() == QOrm::ErrorType::None;
 }
 
+bool QOrmSession::doMergeAll(const QVector<QObject*>& entityInstances,
+                             const QMetaObject& qMetaObject)
+{
+    Q_D(QOrmSession);
+
+    if (d->m_flushMode == QOrm::FlushMode::Deferred)
+    {
+        d->clearLastError();
+
+        for (QObject* entityInstance : entityInstances)
+        {
+            Q_ASSERT(entityInstance != nullptr);
+            d->addPendingInstance(entityInstance, qMetaObject);
+        }
+
+        return true;
+    }
+
+    auto token = declareTransaction(QOrm::TransactionPropagation::Require,
+                                    QOrm::TransactionAction::Rollback);
+
+    d->clearLastError();
+    d->ensureProviderConnected();
+
+    QOrmMetadata entity = d->m_metadataCache[qMetaObject];
+
+    // Update the instances known to the session, and merge modified referenced instances of the
+    // new ones before inserting them.
+    for (QObject* entityInstance : entityInstances)
+    {
+        Q_ASSERT(entityInstance != nullptr);
+
+        if (d->m_entityInstanceCache.contains(entityInstance))
+        {
+            if (!doMerge(entityInstance, qMetaObject))
+                return false;
+
+            continue;
+        }
+
+        if (auto result =
+            QOrmPrivate::crossReferenceError(entity, entityInstance, &d->m_entityInstanceCache))
+        {
+            qFatal("QtOrm: %s", result->toUtf8().data());
+        }
+
+        for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
+        {
+            if (!mapping.isReference() || mapping.isTransient())
+                continue;
+
+            QObject* referencedInstance =
+                QOrmPrivate::propertyValue(entityInstance, mapping).value<QObject*>();
+
+            if (!d->needsMerge(referencedInstance))
+                continue;
+
+            if (!doMerge(referencedInstance, *referencedInstance->metaObject()))
+                return false;
+        }
+    }
+
+    // Instances referenced by other instances of the range have been merged already.
+    QVector<QObject*> newInstances;
+    QSet<const QObject*> seenInstances;
+
+    for (QObject* entityInstance : entityInstances)
+    {
+        if (!d->m_entityInstanceCache.contains(entityInstance) &&
+            !d->m_mergingInstances.contains(entityInstance) &&
+            !seenInstances.contains(entityInstance))
+        {
+            seenInstances.insert(entityInstance);
+            newInstances.push_back(entityInstance);
+        }
+    }
+
+    if (!newInstances.isEmpty() && !d->insertEntityInstances(entity, newInstances))
+        return false;
+
+    token.commit();
+
+    return true;
+}
+
 bool QOrmSession::doRemove(QObject* entityInstance, const QMetaObject& qMetaObject)
 {
     Q_D(QOrmSession);
 
     d->clearLastError();
+
+    // an instance registered for a deferred merge which has not been written is only unregistered
+    if (d->removePendingInstance(entityInstance) &&
+        !d->m_entityInstanceCache.contains(entityInstance))
+    {
+        return true;
+    }
     d->ensureProviderConnected();
 
     QOrmQueryResult result =
@@ -286,11 +717,157 @@ bool QOrmSession::doRemove(QObject* entityInstance, const QMetaObject& qMetaObje
     if (d->m_lastError.type() == QOrm::ErrorType::None)
     {
         d->m_entityInstanceCache.take(entityInstance);
+        d->recordChange(d->m_metadataCache[qMetaObject], entityInstance, QOrm::Operation::Delete);
+
+        if (d->m_transactionCounter == 0)
+            d->publishChanges();
     }
 
     return d->m_lastError.type() == QOrm::ErrorType::None;
 }
 
+bool QOrmSession::doLoad(QObject* entityInstance,
+                         const QMetaObject& qMetaObject,
+                         const QString& propertyName)
+{
+    Q_D(QOrmSession);
+
+    Q_ASSERT(entityInstance != nullptr);
+
+    d->clearLastError();
+
+    QOrmMetadata entity = d->m_metadataCache[qMetaObject];
+    const QOrmPropertyMapping* mapping = entity.classPropertyMapping(propertyName);
+
+    if (mapping == nullptr || (mapping->isTransient() && !mapping->isReference()))
+    {
+        d->setLastError({QOrm::ErrorType::InvalidMapping,
+                         QString{"%1::%2 is not a mapped property"}.arg(entity.className(),
+                                                                       propertyName)});
+        return false;
+    }
+
+    if (!d->m_entityInstanceCache.contains(entityInstance))
+    {
+        d->setLastError({QOrm::ErrorType::UnsynchronizedEntity,
+                         QString{"%1 is not known to the session"}.arg(
+                             QOrmPrivate::entityInstanceRepresentation(entity, entityInstance))});
+        return false;
+    }
+
+    if (d->m_entityInstanceCache.isFetched(entityInstance, propertyName))
+        return true;
+
+    d->ensureProviderConnected();
+
+    QVariant key = d->m_entityInstanceCache.unfetchedKey(entityInstance, propertyName);
+
+    // The property was left out of a column selection: read its column again. The provider
+    // refills only the selected properties of the cached instance and keeps its changes.
+    if (!mapping->isReference() || (!mapping->isTransient() && !key.isValid()))
+    {
+        Q_ASSERT(entity.objectIdMapping() != nullptr);
+
+        QOrmQuery query{QOrm::Operation::Read,
+                        QOrmRelation{entity},
+                        entity,
+                        QOrmFilter{*entity.objectIdMapping() ==
+                                   QOrmPrivate::objectIdPropertyValue(entityInstance, entity)},
+                        {},
+                        {},
+                        QOrm::QueryFlags::OverwriteCachedInstances};
+        query.setColumns({*entity.objectIdMapping(), *mapping});
+
+        QOrmQueryResult<QObject> result =
+            d->m_sessionConfiguration.provider()->execute(query, d->m_entityInstanceCache);
+        d->setLastError(result.error());
+
+        if (d->m_lastError.type() != QOrm::ErrorType::None)
+            return false;
+
+        if (result.toVector().size() != 1)
+        {
+            d->setLastError({QOrm::ErrorType::UnsynchronizedEntity,
+                             QString{"%1 not found"}.arg(QOrmPrivate::entityInstanceRepresentation(
+                                 entity, entityInstance))});
+            return false;
+        }
+
+        return true;
+    }
+
+    const QOrmMetadata& referencedEntity = *mapping->referencedEntity();
+    QVariant propertyValue;
+
+    // one-to-many: all instances referring to this one
+    if (mapping->isTransient())
+    {
+        const QOrmPropertyMapping* backReference = QOrmPrivate::backReference(*mapping);
+        Q_ASSERT(backReference != nullptr);
+
+        QOrmQuery query{QOrm::Operation::Read,
+                        QOrmRelation{referencedEntity},
+                        referencedEntity,
+                        QOrmFilter{*backReference == entityInstance},
+                        {},
+                        {},
+                        QOrm::QueryFlags::None};
+
+        QOrmQueryResult<QObject> result =
+            d->m_sessionConfiguration.provider()->execute(query, d->m_entityInstanceCache);
+        d->setLastError(result.error());
+
+        if (d->m_lastError.type() != QOrm::ErrorType::None)
+            return false;
+
+        propertyValue = QOrmPrivate::referenceCollectionValue(*mapping, result.toVector());
+    }
+    // many-to-one: the instance with the stored foreign key
+    else if (!key.isNull())
+    {
+        QOrmQuery query{QOrm::Operation::Read,
+                        QOrmRelation{referencedEntity},
+                        referencedEntity,
+                        QOrmFilter{*referencedEntity.objectIdMapping() == key},
+                        {},
+                        {},
+                        QOrm::QueryFlags::None};
+
+        QOrmQueryResult<QObject> result =
+            d->m_sessionConfiguration.provider()->execute(query, d->m_entityInstanceCache);
+        d->setLastError(result.error());
+
+        if (d->m_lastError.type() != QOrm::ErrorType::None)
+            return false;
+
+        if (result.toVector().size() != 1)
+        {
+            d->setLastError({QOrm::ErrorType::UnsynchronizedEntity,
+                             QString{"Referenced instance of %1 with object ID %2 not found"}.arg(
+                                 referencedEntity.className(), key.toString())});
+            return false;
+        }
+
+        propertyValue = QVariant::fromValue(result.toVector().front());
+    }
+    else
+    {
+        propertyValue = QVariant::fromValue<QObject*>(nullptr);
+    }
+
+    bool wasModified = d->m_entityInstanceCache.isModified(entityInstance);
+
+    if (!QOrmPrivate::setPropertyValue(entityInstance, *mapping, propertyValue))
+        Q_ORM_UNEXPECTED_STATE;
+
+    d->m_entityInstanceCache.markFetched(entityInstance, propertyName);
+
+    if (!wasModified)
+        d->m_entityInstanceCache.markUnmodified(entityInstance);
+
+    return true;
+}
+
 QOrmTransactionToken QOrmSession::declareTransaction(QOrm::TransactionPropagation propagation,
                                                      QOrm::TransactionAction finalAction)
 {
@@ -342,12 +919,237 @@ QOrmMetadataCache* QOrmSession::metadataCache()
     return &d->m_metadataCache;
 }
 
+QOrmSessionNotifier* QOrmSession::notifier()
+{
+    Q_D(QOrmSession);
+
+    return &d->m_notifier;
+}
+
 QOrmEntityInstanceCache* QOrmSession::entityInstanceCache()
 {
     Q_D(QOrmSession);
     return &d->m_entityInstanceCache;
 }
 
+QOrm::FlushMode QOrmSession::flushMode() const
+{
+    Q_D(const QOrmSession);
+    return d->m_flushMode;
+}
+
+void QOrmSession::setFlushMode(QOrm::FlushMode flushMode)
+{
+    Q_D(QOrmSession);
+    d->m_flushMode = flushMode;
+}
+
+bool QOrmSession::flush()
+{
+    Q_D(QOrmSession);
+
+    using PendingEntityInstance = QOrmSessionPrivate::PendingEntityInstance;
+
+    d->clearLastError();
+
+    if (d->m_pendingInstances.empty())
+        return true;
+
+    std::vector<PendingEntityInstance> pendingInstances;
+    std::swap(pendingInstances, d->m_pendingInstances);
+    d->m_pendingInstanceSet.clear();
+
+    // the pins taken by addPendingInstance() are released once the instances are written or
+    // pending again
+    auto pinReleaser = qScopeGuard([d, &pendingInstances]() {
+        for (const auto& [instance, qMetaObject] : pendingInstances)
+        {
+            Q_UNUSED(qMetaObject)
+            d->m_entityInstanceCache.unpin(instance);
+        }
+    });
+
+    // the instances stay pending unless they have all been written
+    auto pendingRestorer = qScopeGuard([d, &pendingInstances]() {
+        for (const auto& [instance, qMetaObject] : pendingInstances)
+            d->addPendingInstance(instance, *qMetaObject);
+    });
+
+    // Collect the new and modified instances, including the referenced ones. The level of a new
+    // instance is one more than the highest level of the new instances it refers to, so that
+    // instances of a level can be inserted together once the lower levels have their IDs.
+    // Modified instances are updated after all insertions in any order: they are leaves, and the
+    // new instances they refer to are collected separately, so that only references between new
+    // instances can form a cycle.
+    QHash<const QObject*, int> levels;
+    QSet<const QObject*> visiting;
+    std::vector<PendingEntityInstance> newInstances;
+    std::vector<PendingEntityInstance> modifiedInstances;
+    std::vector<QObject*> referencedByModified;
+    bool hasCycle = false;
+
+    std::function<int(QObject*, const QMetaObject*)> collect =
+        [&](QObject* instance, const QMetaObject* qMetaObject) -> int {
+        auto knownLevel = levels.find(instance);
+
+        if (knownLevel != std::end(levels))
+            return *knownLevel;
+
+        if (visiting.contains(instance))
+        {
+            hasCycle = true;
+            return 0;
+        }
+
+        QOrmMetadata entity = d->m_metadataCache[*qMetaObject];
+
+        if (auto result =
+                QOrmPrivate::crossReferenceError(entity, instance, &d->m_entityInstanceCache))
+        {
+            qFatal("QtOrm: %s", result->toUtf8().data());
+        }
+
+        bool isNew = !d->m_entityInstanceCache.contains(instance);
+        int level = 0;
+
+        if (isNew)
+        {
+            visiting.insert(instance);
+        }
+        else
+        {
+            levels.insert(instance, level);
+            modifiedInstances.push_back(std::make_pair(instance, qMetaObject));
+        }
+
+        for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
+        {
+            if (!mapping.isReference() || mapping.isTransient())
+                continue;
+
+            QObject* referencedInstance =
+                QOrmPrivate::propertyValue(instance, mapping).value<QObject*>();
+
+            if (!d->needsMerge(referencedInstance))
+                continue;
+
+            if (!isNew)
+            {
+                referencedByModified.push_back(referencedInstance);
+                continue;
+            }
+
+            bool isReferenceNew = !d->m_entityInstanceCache.contains(referencedInstance);
+            int referencedLevel = collect(referencedInstance, referencedInstance->metaObject());
+
+            if (isReferenceNew)
+                level = std::max(level, referencedLevel + 1);
+        }
+
+        if (isNew)
+        {
+            visiting.remove(instance);
+            levels.insert(instance, level);
+            newInstances.push_back(std::make_pair(instance, qMetaObject));
+        }
+
+        return level;
+    };
+
+    for (const auto& [instance, qMetaObject] : pendingInstances)
+    {
+        if (d->needsMerge(instance))
+            std::ignore = collect(instance, qMetaObject);
+    }
+
+    // may grow while collecting
+    for (size_t i = 0; i < referencedByModified.size(); ++i)
+    {
+        QObject* instance = referencedByModified[i];
+        std::ignore = collect(instance, instance->metaObject());
+    }
+
+    if (hasCycle)
+    {
+        d->setLastError({QOrm::ErrorType::Other,
+                         "Unable to flush: new entity instances refer to each other"});
+        return false;
+    }
+
+    auto token = declareTransaction(QOrm::TransactionPropagation::Require,
+                                    QOrm::TransactionAction::Rollback);
+
+    d->ensureProviderConnected();
+
+    std::stable_sort(std::begin(newInstances),
+                     std::end(newInstances),
+                     [&levels](const PendingEntityInstance& lhs, const PendingEntityInstance& rhs) {
+                         return levels.value(lhs.first) < levels.value(rhs.first);
+                     });
+
+    // one batch per entity and level
+    for (auto begin = std::begin(newInstances); begin != std::end(newInstances);)
+    {
+        int level = levels.value(begin->first);
+        auto end = std::find_if(begin,
+                                std::end(newInstances),
+                                [&levels, level](const PendingEntityInstance& pending) {
+                                    return levels.value(pending.first) != level;
+                                });
+
+        QVector<const QMetaObject*> entities;
+        QHash<const QMetaObject*, QVector<QObject*>> batches;
+
+        for (auto it = begin; it != end; ++it)
+        {
+            if (!batches.contains(it->second))
+                entities.push_back(it->second);
+
+            batches[it->second].push_back(it->first);
+        }
+
+        for (const QMetaObject* qMetaObject : entities)
+        {
+            if (!d->insertEntityInstances(d->m_metadataCache[*qMetaObject], batches[qMetaObject]))
+                return false;
+        }
+
+        begin = end;
+    }
+
+    // updates of the same entity reuse their prepared statements
+    std::stable_sort(std::begin(modifiedInstances),
+                     std::end(modifiedInstances),
+                     [](const PendingEntityInstance& lhs, const PendingEntityInstance& rhs) {
+                         return std::less<const QMetaObject*>{}(lhs.second, rhs.second);
+                     });
+
+    for (const auto& [instance, qMetaObject] : modifiedInstances)
+    {
+        QOrmQueryResult result = d->m_sessionConfiguration.provider()->execute(
+            queryBuilderFor(*qMetaObject)
+                .instance(*qMetaObject, instance)
+                .build(QOrm::Operation::Update),
+            d->m_entityInstanceCache);
+
+        d->setLastError(result.error());
+
+        if (d->m_lastError.type() != QOrm::ErrorType::None)
+            return false;
+
+        d->m_entityInstanceCache.markUnmodified(instance);
+        d->recordChange(d->m_metadataCache[*qMetaObject], instance, QOrm::Operation::Update);
+        d->m_trackedInstances.push_back(std::make_pair(instance, QOrm::Operation::Merge));
+    }
+
+    if (!token.commit())
+        return false;
+
+    pendingRestorer.dismiss();
+
+    return true;
+}
+
 bool QOrmSession::beginTransaction()
 {
     Q_D(QOrmSession);
@@ -391,6 +1193,10 @@ bool QOrmSession::commitTransaction()
     }
     else if (d->m_transactionCounter == 1)
     {
+        // FlushMode::Deferred: the registered instances are written as part of the transaction
+        if (!d->m_pendingInstances.empty() && !flush())
+            return false;
+
         if (d->m_sessionConfiguration.isVerbose())
             qCDebug(qtorm) << "Committing transaction";
 
@@ -401,6 +1207,8 @@ bool QOrmSession::commitTransaction()
         {
             d->commitTrackedInstances();
             d->m_transactionCounter = 0;
+            d->trimEntityInstanceCache();
+            d->publishChanges();
         }
         else if (d->m_sessionConfiguration.isVerbose())
         {
@@ -436,6 +1244,7 @@ bool QOrmSession::rollbackTransaction()
         if (d->m_lastError.type() == QOrm::ErrorType::None)
         {
             d->rollbackTrackedInstances();
+            d->discardChanges();
             d->m_transactionCounter = 0;
         }
         else if (d->m_sessionConfiguration.isVerbose())
@@ -30,8 +30,11 @@
 #include <QtOrm/qormtransactiontoken.h>
 
 #include <QtCore/qobject.h>
+#include <QtCore/qvector.h>
 
+#include <iterator>
 #include <memory>
+#include <type_traits>
 
 QT_BEGIN_NAMESPACE
 
@@ -39,6 +42,7 @@ class QOrmAbstractProvider;
 class QOrmEntityInstanceCache;
 class QOrmError;
 class QOrmQuery;
+class QOrmSessionNotifier;
 class QOrmSessionPrivate;
 
 template<typename Projection>
@@ -59,6 +63,9 @@ public:
     Q_REQUIRED_RESULT
     QOrmQueryBuilder<QObject> from(const QOrmQuery& query);
 
+    Q_REQUIRED_RESULT
+    std::unique_ptr<QOrmAbstractCursor> openCursor(const QOrmQuery& query);
+
     template<typename T>
     bool merge(T* entityInstance)
     {
@@ -110,6 +117,30 @@ public:
         return true;
     }
 
+    // Merges a range of entity instances of the same entity. The instances not yet known to the
+    // session are inserted in batches using multi-row INSERT statements.
+    template<typename Range>
+    bool mergeAll(const Range& instances)
+    {
+        using T = std::remove_pointer_t<std::decay_t<decltype(*std::begin(instances))>>;
+
+        QVector<QObject*> entityInstances;
+
+        for (T* instance : instances)
+            entityInstances.push_back(instance);
+
+        return doMergeAll(entityInstances, T::staticMetaObject);
+    }
+
+    // Loads a reference property declared with FETCH LAZY, or a property which was left out by
+    // QOrmQueryBuilder::columns(). Loading an already loaded property does nothing. The instance
+    // is not marked as modified by loading.
+    template<typename T>
+    bool load(T* entityInstance, const QOrmClassProperty& property)
+    {
+        return doLoad(entityInstance, T::staticMetaObject, property.descriptor());
+    }
+
     template<typename T>
     std::unique_ptr<T> remove(T* entityInstance)
     {
@@ -145,6 +176,22 @@ public:
     Q_REQUIRED_RESULT
     QOrmEntityInstanceCache* entityInstanceCache();
 
+    // Emits the entity instances created, updated, and removed by the session after each commit.
+    // Removals and updates outside of a transaction are emitted right away.
+    Q_REQUIRED_RESULT
+    QOrmSessionNotifier* notifier();
+
+    // With FlushMode::Deferred, merge() and mergeAll() only register the entity instances. Changing
+    // the flush mode does not flush the registered instances.
+    Q_REQUIRED_RESULT
+    QOrm::FlushMode flushMode() const;
+    void setFlushMode(QOrm::FlushMode flushMode);
+
+    // Writes the entity instances registered with FlushMode::Deferred, together with the new or
+    // modified instances they refer to, in one transaction. New instances are inserted in batches
+    // per entity, ordered so that referenced instances are inserted first.
+    bool flush();
+
     bool beginTransaction();
     bool commitTransaction();
     bool rollbackTransaction();
@@ -152,7 +199,11 @@ public:
 
 private:
     bool doMerge(QObject* entityInstance, const QMetaObject& qMetaObject);
+    bool doMergeAll(const QVector<QObject*>& entityInstances, const QMetaObject& qMetaObject);
     bool doRemove(QObject* entityInstance, const QMetaObject& qMetaObject);
+    bool doLoad(QObject* entityInstance,
+                const QMetaObject& qMetaObject,
+                const QString& propertyName);
 
     QOrmQueryBuilder<QObject> queryBuilderFor(const QMetaObject& relationMetaObject);
 
@@ -38,16 +38,25 @@ class QOrmSessionConfigurationData : public QSharedData
 {
     friend class QOrmSessionConfiguration;
 
-    QOrmSessionConfigurationData(QOrmAbstractProvider* provider, bool isVerbose);
+    QOrmSessionConfigurationData(QOrmAbstractProvider* provider,
+                                 bool isVerbose,
+                                 int entityInstanceCacheSize,
+                                 QOrm::ChangeTracking changeTracking);
 
     std::unique_ptr<QOrmAbstractProvider> m_provider;
     bool m_isVerbose{false};
+    int m_entityInstanceCacheSize{0};
+    QOrm::ChangeTracking m_changeTracking{QOrm::ChangeTracking::NotifySignals};
 };
 
 QOrmSessionConfigurationData::QOrmSessionConfigurationData(QOrmAbstractProvider* provider,
-                                                           bool isVerbose)
+                                                           bool isVerbose,
+                                                           int entityInstanceCacheSize,
+                                                           QOrm::ChangeTracking changeTracking)
     : m_provider{provider}
     , m_isVerbose{isVerbose}
+    , m_entityInstanceCacheSize{entityInstanceCacheSize}
+    , m_changeTracking{changeTracking}
 {
     Q_ASSERT(provider != nullptr);
 }
@@ -60,6 +69,9 @@ static QOrmSqliteConfiguration _build_json_sqlite_configuration(const QJsonObjec
     sqlConfiguration.setVerbose(object["verbose"].toBool(false));
     sqlConfiguration.setConnectOptions(object["connectOptions"].toString());
 
+    if (object.contains("statementCacheSize"))
+        sqlConfiguration.setStatementCacheSize(object["statementCacheSize"].toInt());
+
     QString schemaModeStr = object["schemaMode"].toString("validate").toLower();
 
     static QHash<QString, QOrmSqliteConfiguration::SchemaMode> schemaModes = {
@@ -118,6 +130,11 @@ QOrmSessionConfiguration QOrmSessionConfiguration::fromFile(const QString& fileP
 
             std::unique_ptr<QOrmAbstractProvider> provider;
             bool isVerbose = rootObject["verbose"].toBool(false);
+            int entityInstanceCacheSize = rootObject["entityInstanceCacheSize"].toInt(0);
+            QOrm::ChangeTracking changeTracking =
+                rootObject["changeTracking"].toString().compare("snapshots") == 0
+                    ? QOrm::ChangeTracking::Snapshots
+                    : QOrm::ChangeTracking::NotifySignals;
 
             if (rootObject["provider"].toString().compare("sqlite") == 0)
             {
@@ -126,15 +143,20 @@ QOrmSessionConfiguration QOrmSessionConfiguration::fromFile(const QString& fileP
                 provider = std::make_unique<QOrmSqliteProvider>(sqlConfiguration);
             }
 
-            return QOrmSessionConfiguration{provider.release(), isVerbose};
+            return QOrmSessionConfiguration{
+                provider.release(), isVerbose, entityInstanceCacheSize, changeTracking};
         }
     }
 
     qFatal("qtorm: Unable to open session configuration file %s", qPrintable(filePath));
 }
 
-QOrmSessionConfiguration::QOrmSessionConfiguration(QOrmAbstractProvider* provider, bool isVerbose)
-    : d{new QOrmSessionConfigurationData{provider, isVerbose}}
+QOrmSessionConfiguration::QOrmSessionConfiguration(QOrmAbstractProvider* provider,
+                                                   bool isVerbose,
+                                                   int entityInstanceCacheSize,
+                                                   QOrm::ChangeTracking changeTracking)
+    : d{new QOrmSessionConfigurationData{
+          provider, isVerbose, entityInstanceCacheSize, changeTracking}}
 {
 }
 
@@ -159,4 +181,14 @@ bool QOrmSessionConfiguration::isVerbose() const
     return d->m_isVerbose;
 }
 
+int QOrmSessionConfiguration::entityInstanceCacheSize() const
+{
+    return d->m_entityInstanceCacheSize;
+}
+
+QOrm::ChangeTracking QOrmSessionConfiguration::changeTracking() const
+{
+    return d->m_changeTracking;
+}
+
 QT_END_NAMESPACE
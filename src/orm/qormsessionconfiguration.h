@@ -40,7 +40,11 @@ public:
     static QOrmSessionConfiguration fromFile(const QString& filePath);
 
 public:
-    QOrmSessionConfiguration(QOrmAbstractProvider* provider, bool isVerbose);
+    QOrmSessionConfiguration(QOrmAbstractProvider* provider,
+                             bool isVerbose,
+                             int entityInstanceCacheSize = 0,
+                             QOrm::ChangeTracking changeTracking =
+                                 QOrm::ChangeTracking::NotifySignals);
     QOrmSessionConfiguration(const QOrmSessionConfiguration&);
     QOrmSessionConfiguration(QOrmSessionConfiguration&&);
     ~QOrmSessionConfiguration();
@@ -54,6 +58,13 @@ public:
     Q_REQUIRED_RESULT
     bool isVerbose() const;
 
+    // Maximum number of entity instances kept by a session; 0 means unlimited.
+    Q_REQUIRED_RESULT
+    int entityInstanceCacheSize() const;
+
+    Q_REQUIRED_RESULT
+    QOrm::ChangeTracking changeTracking() const;
+
 private:
     QSharedDataPointer<QOrmSessionConfigurationData> d;
 };
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2019-2022 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "qormsessionnotifier.h"
+
+#include <QtCore/qdebug.h>
+
+QT_BEGIN_NAMESPACE
+
+QOrmChangeSet::QOrmChangeSet(const QMetaObject& entity,
+                             QOrm::Operation operation,
+                             QVariantList objectIds)
+    : m_entity{&entity}
+    , m_operation{operation}
+    , m_objectIds{std::move(objectIds)}
+{
+}
+
+const QMetaObject* QOrmChangeSet::entity() const
+{
+    return m_entity;
+}
+
+QOrm::Operation QOrmChangeSet::operation() const
+{
+    return m_operation;
+}
+
+QVariantList QOrmChangeSet::objectIds() const
+{
+    return m_objectIds;
+}
+
+QDebug operator<<(QDebug dbg, const QOrmChangeSet& changeSet)
+{
+    QDebugStateSaver saver{dbg};
+
+    dbg.nospace() << "QOrmChangeSet("
+                  << (changeSet.entity() != nullptr ? changeSet.entity()->className() : "")
+                  << ", " << changeSet.operation() << ", " << changeSet.objectIds() << ")";
+
+    return dbg;
+}
+
+QOrmSessionNotifier::QOrmSessionNotifier(QObject* parent)
+    : QObject{parent}
+{
+    qRegisterMetaType<QOrmChangeSet>();
+    qRegisterMetaType<QVector<QOrmChangeSet>>();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2019-2022 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QORMSESSIONNOTIFIER_H
+#define QORMSESSIONNOTIFIER_H
+
+#include <QtOrm/qormglobal.h>
+
+#include <QtCore/qmetatype.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QDebug;
+
+// The object IDs of the instances of one entity written with the same operation. Instances
+// inserted or updated by an upsert are reported with QOrm::Operation::Merge. The object IDs are
+// empty for entities without an object ID, and for updates and removals with a filter.
+class Q_ORM_EXPORT QOrmChangeSet
+{
+public:
+    QOrmChangeSet() = default;
+    QOrmChangeSet(const QMetaObject& entity, QOrm::Operation operation, QVariantList objectIds);
+
+    [[nodiscard]] const QMetaObject* entity() const;
+    [[nodiscard]] QOrm::Operation operation() const;
+    [[nodiscard]] QVariantList objectIds() const;
+
+private:
+    const QMetaObject* m_entity{nullptr};
+    QOrm::Operation m_operation{QOrm::Operation::Merge};
+    QVariantList m_objectIds;
+};
+
+extern Q_ORM_EXPORT QDebug operator<<(QDebug dbg, const QOrmChangeSet& changeSet);
+
+// Emits the changes written by a session once they are committed. Several writes of the same
+// instance within a transaction are coalesced: an instance created and updated is reported as
+// created, an instance created and removed is not reported at all.
+class Q_ORM_EXPORT QOrmSessionNotifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit QOrmSessionNotifier(QObject* parent = nullptr);
+
+Q_SIGNALS:
+    // Removals come first for every entity, followed by creates, merges, and updates.
+    void changed(const QVector<QOrmChangeSet>& changeSets);
+};
+
+QT_END_NAMESPACE
+
+Q_DECLARE_METATYPE(QOrmChangeSet)
+
+#endif // QORMSESSIONNOTIFIER_H
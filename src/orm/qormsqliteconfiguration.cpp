@@ -62,4 +62,16 @@ void QOrmSqliteConfiguration::setSchemaMode(SchemaMode schemaMode)
     m_schemaMode = schemaMode;
 }
 
+int QOrmSqliteConfiguration::statementCacheSize() const
+{
+    return m_statementCacheSize;
+}
+
+// Sets the maximum number of prepared statements kept by the provider for reuse. Setting the size
+// to 0 disables the cache and prepares each statement anew.
+void QOrmSqliteConfiguration::setStatementCacheSize(int statementCacheSize)
+{
+    m_statementCacheSize = statementCacheSize;
+}
+
 QT_END_NAMESPACE
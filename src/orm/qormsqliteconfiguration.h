@@ -55,11 +55,16 @@ public:
     SchemaMode schemaMode() const;
     void setSchemaMode(SchemaMode schemaMode);
 
+    Q_REQUIRED_RESULT
+    int statementCacheSize() const;
+    void setStatementCacheSize(int statementCacheSize);
+
 private:
     QString m_connectOptions;
     QString m_databaseName;
     bool m_verbose{false};
     SchemaMode m_schemaMode;
+    int m_statementCacheSize{64};
 };
 
 QT_END_NAMESPACE
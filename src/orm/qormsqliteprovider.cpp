@@ -38,6 +38,7 @@
 #include "qormsqlitestatementgenerator_p.h"
 
 #include <QtCore/qdebug.h>
+#include <QtCore/qhash.h>
 #include <QtCore/qmetaobject.h>
 #include <QtCore/qobject.h>
 #include <QtCore/qscopeguard.h>
@@ -48,16 +49,95 @@
 #include <QtSql/qsqlquery.h>
 #include <QtSql/qsqlrecord.h>
 
+#include <algorithm>
+#include <list>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <utility>
+
 QT_BEGIN_NAMESPACE
 
+namespace
+{
+    // Positions of the columns of the property mappings in the result of a query. They are
+    // resolved once per query, so that the values of a row are not searched by column name.
+    class ResultColumns
+    {
+    public:
+        ResultColumns(const QOrmMetadata& projection, const QSqlRecord& record)
+            : m_projection{projection}
+            , m_count{record.count()}
+        {
+            // keyed by the mappings of the stored projection, which shares them with the query
+            for (const QOrmPropertyMapping& mapping : m_projection.propertyMappings())
+            {
+                m_columns.insert(&mapping,
+                                 mapping.isTransient() ? -1
+                                                       : record.indexOf(mapping.tableFieldName()));
+            }
+        }
+
+        [[nodiscard]] int count() const { return m_count; }
+
+        [[nodiscard]] int column(const QOrmPropertyMapping& mapping) const
+        {
+            auto it = m_columns.constFind(&mapping);
+
+            if (it != std::cend(m_columns))
+                return *it;
+
+            // mappings are normally taken from the projection itself, otherwise look them up
+            const QOrmPropertyMapping* ownMapping =
+                m_projection.tableFieldMapping(mapping.tableFieldName());
+
+            return ownMapping == nullptr ? -1 : m_columns.value(ownMapping, -1);
+        }
+
+    private:
+        QOrmMetadata m_projection;
+        QHash<const QOrmPropertyMapping*, int> m_columns;
+        int m_count{0};
+    };
+
+    // The values of a row of a query result.
+    class ResultRow
+    {
+    public:
+        ResultRow() = default;
+
+        ResultRow(std::shared_ptr<const ResultColumns> columns, const QSqlQuery& sqlQuery)
+            : m_columns{std::move(columns)}
+        {
+            m_values.reserve(m_columns->count());
+
+            // NULL is an invalid QVariant, as the entity property is reset for it
+            for (int i = 0; i < m_columns->count(); ++i)
+                m_values.push_back(sqlQuery.isNull(i) ? QVariant{} : sqlQuery.value(i));
+        }
+
+        [[nodiscard]] QVariant value(const QOrmPropertyMapping& mapping) const
+        {
+            int column = m_columns->column(mapping);
+            return column < 0 ? QVariant{} : m_values[column];
+        }
+
+    private:
+        std::shared_ptr<const ResultColumns> m_columns;
+        QVector<QVariant> m_values;
+    };
+} // namespace
+
 class QOrmSqliteProviderPrivate
 {
     Q_DECLARE_PUBLIC(QOrmSqliteProvider)
+    friend class QOrmSqliteCursor;
 
     explicit QOrmSqliteProviderPrivate(const QOrmSqliteConfiguration& configuration,
                                        QOrmSqliteProvider* parent)
         : q_ptr{parent}
         , m_sqlConfiguration{configuration}
+        , m_statementGenerator{QOrmSqliteStatementGenerator::PositionalParameters}
     {
         detectSqliteCapabilities();
     }
@@ -70,6 +150,25 @@ class QOrmSqliteProviderPrivate
     QOrmSqliteStatementGenerator m_statementGenerator;
     QOrmSqliteProvider::SqliteCapabilities m_capabilities{QOrmSqliteProvider::NoCapabilities};
 
+    // Prepared statements in least recently used order: the most recently used statement is in
+    // front. The index provides the lookup by statement text.
+    std::list<std::pair<QString, QSqlQuery>> m_statementCache;
+    QHash<QString, std::list<std::pair<QString, QSqlQuery>>::iterator> m_statementCacheIndex;
+    qint64 m_statementCacheHits{0};
+    qint64 m_statementCacheMisses{0};
+    // SQLITE_MAX_VARIABLE_NUMBER defaults to 999 before SQLite 3.32.0
+    int m_maxVariableNumber{999};
+
+    enum class StatementCaching
+    {
+        Disabled,
+        Enabled
+    };
+
+    // Children of one-to-many references read in advance for a set of parent instances: class
+    // property name -> parent object ID -> children
+    using PrefetchedCollections = QHash<QString, QHash<QString, QVector<QObject*>>>;
+
     Q_REQUIRED_RESULT
     QString toSqlType(QMetaType::Type type);
     [[nodiscard]] bool canConvertFromSqliteToQProperty(QMetaType::Type fromSqlType,
@@ -79,18 +178,49 @@ class QOrmSqliteProviderPrivate
     QOrmError lastDatabaseError() const;
 
     Q_REQUIRED_RESULT
-    QSqlQuery prepareAndExecute(const QString& statement, const QVariantMap& parameters);
+    QSqlQuery prepare(const QString& statement, StatementCaching caching, bool& isPrepared);
+    Q_REQUIRED_RESULT
+    QSqlQuery prepareAndExecute(const QString& statement,
+                                const QVariantMap& parameters = {},
+                                StatementCaching caching = StatementCaching::Disabled);
+    void clearStatementCache();
 
+    Q_REQUIRED_RESULT
+    QObject* instantiateEntity(const QOrmMetadata& entityMetadata,
+                               const ResultRow& record,
+                               QOrmEntityInstanceCache& entityInstanceCache);
     Q_REQUIRED_RESULT
     QOrmPrivate::Expected<QObject*, QOrmError> makeEntityInstance(
         const QOrmMetadata& entityMetadata,
-        const QSqlRecord& record,
+        const ResultRow& record,
         QOrmEntityInstanceCache& entityInstanceCache);
+    [[nodiscard]] static bool isSelected(const QOrmPropertyMapping& mapping,
+                                         const QSet<QString>& selectedProperties);
+    QOrmError prefetchReferences(const QOrmMetadata& entityMetadata,
+                                 const QVector<ResultRow>& records,
+                                 QOrmEntityInstanceCache& entityInstanceCache,
+                                 const QFlags<QOrm::QueryFlags>& queryFlags,
+                                 const QSet<QString>& selectedProperties = {});
+    QOrmError prefetchCollections(const QOrmMetadata& entityMetadata,
+                                  const QVector<ResultRow>& records,
+                                  QOrmEntityInstanceCache& entityInstanceCache,
+                                  const QFlags<QOrm::QueryFlags>& queryFlags,
+                                  const QSet<QString>& selectedProperties,
+                                  PrefetchedCollections& prefetchedCollections);
     QOrmError fillEntityInstance(const QOrmMetadata& entityMetadata,
                                  QObject* entityInstance,
-                                 const QSqlRecord& record,
+                                 const ResultRow& record,
                                  QOrmEntityInstanceCache& entityInstanceCache,
-                                 const QFlags<QOrm::QueryFlags>& queryFlags);
+                                 const QFlags<QOrm::QueryFlags>& queryFlags,
+                                 const QSet<QString>& selectedProperties = {},
+                                 const PrefetchedCollections* prefetchedCollections = nullptr);
+    QOrmError hydrateEntityInstances(const QOrmMetadata& entityMetadata,
+                                     const QVector<QObject*>& entityInstances,
+                                     const QVector<ResultRow>& records,
+                                     QOrmEntityInstanceCache& entityInstanceCache,
+                                     const QFlags<QOrm::QueryFlags>& queryFlags,
+                                     const QSet<QString>& selectedProperties,
+                                     bool areNewInstances);
 
     QOrmError ensureSchemaSynchronized(const QOrmRelation& entityMetadata);
     QOrmError recreateSchema(const QOrmRelation& entityMetadata);
@@ -99,8 +229,27 @@ class QOrmSqliteProviderPrivate
     QOrmError appendSchema(const QOrmRelation& entityMetadata);
 
     QOrmQueryResult<QObject> read(const QOrmQuery& query,
-                                  QOrmEntityInstanceCache& entityInstanceCache);
-    QOrmQueryResult<QObject> merge(const QOrmQuery& query);
+                                  QOrmEntityInstanceCache& entityInstanceCache,
+                                  QVector<ResultRow>* resultRecords = nullptr);
+    QOrmQueryResult<QObject> readRecords(const QOrmQuery& query,
+                                         const QVector<ResultRow>& records,
+                                         QOrmEntityInstanceCache& entityInstanceCache);
+    QOrmQueryResult<QObject> readValues(const QOrmQuery& query);
+    QOrmQueryResult<QObject> merge(const QOrmQuery& query,
+                                   QOrmEntityInstanceCache& entityInstanceCache);
+    QOrmQueryResult<QObject> insertAll(const QOrmQuery& query);
+    QOrmQueryResult<QObject> upsertAll(const QOrmQuery& query);
+    QOrmQueryResult<QObject> updateAll(const QOrmQuery& query,
+                                       QOrmEntityInstanceCache& entityInstanceCache);
+    static void assignUpdatedValues(QObject* entityInstance,
+                                    const std::vector<std::pair<QOrmPropertyMapping, QVariant>>&
+                                        assignments,
+                                    QOrmEntityInstanceCache& entityInstanceCache);
+    static void moveToCollection(QObject* entityInstance,
+                                 const QOrmPropertyMapping& backReference,
+                                 QObject* previousOwner,
+                                 QObject* owner,
+                                 QOrmEntityInstanceCache& entityInstanceCache);
     QOrmQueryResult<QObject> remove(const QOrmQuery& query,
                                     QOrmEntityInstanceCache& entityInstanceCache);
 
@@ -145,15 +294,79 @@ QOrmError QOrmSqliteProviderPrivate::lastDatabaseError() const
     return QOrmError{QOrm::ErrorType::Provider, m_database.lastError().text()};
 }
 
-QSqlQuery QOrmSqliteProviderPrivate::prepareAndExecute(const QString& statement,
-                                                       const QVariantMap& parameters = {})
+// Returns a prepared query for the statement. If caching is enabled, the prepared query is looked
+// up in the statement cache first, and a newly prepared query is stored in the cache evicting the
+// least recently used one if needed.
+//
+// A cached query that is still active is in use by an enclosing read, e.g. when reading a chain of
+// self-references. It cannot be re-executed without resetting the enclosing read, so a separate
+// uncached query is prepared instead. The callers of prepareAndExecute() must therefore finish()
+// the cached queries they are done with.
+QSqlQuery QOrmSqliteProviderPrivate::prepare(const QString& statement,
+                                             StatementCaching caching,
+                                             bool& isPrepared)
 {
+    bool isCacheEnabled =
+        caching == StatementCaching::Enabled && m_sqlConfiguration.statementCacheSize() > 0;
+
+    if (isCacheEnabled)
+    {
+        auto it = m_statementCacheIndex.find(statement);
+
+        if (it != m_statementCacheIndex.end())
+        {
+            if (!it.value()->second.isActive())
+            {
+                ++m_statementCacheHits;
+                m_statementCache.splice(m_statementCache.begin(), m_statementCache, it.value());
+                isPrepared = true;
+                return m_statementCache.front().second;
+            }
+
+            isCacheEnabled = false;
+        }
+
+        ++m_statementCacheMisses;
+    }
+
+    // results are only ever iterated once: SQLite does not need to buffer the rows
     QSqlQuery query{m_database};
+    query.setForwardOnly(true);
+    isPrepared = query.prepare(statement);
+
+    if (!isPrepared || !isCacheEnabled)
+        return query;
+
+    m_statementCache.emplace_front(statement, query);
+    m_statementCacheIndex.insert(statement, m_statementCache.begin());
+
+    while (m_statementCache.size() >
+           static_cast<size_t>(m_sqlConfiguration.statementCacheSize()))
+    {
+        m_statementCacheIndex.remove(m_statementCache.back().first);
+        m_statementCache.pop_back();
+    }
+
+    return query;
+}
 
+void QOrmSqliteProviderPrivate::clearStatementCache()
+{
+    m_statementCacheIndex.clear();
+    m_statementCache.clear();
+}
+
+QSqlQuery QOrmSqliteProviderPrivate::prepareAndExecute(const QString& statement,
+                                                       const QVariantMap& parameters,
+                                                       StatementCaching caching)
+{
     if (m_sqlConfiguration.verbose())
         qCDebug(qtorm).noquote() << "Executing:" << statement;
 
-    if (!query.prepare(statement))
+    bool isPrepared = false;
+    QSqlQuery query = prepare(statement, caching, isPrepared);
+
+    if (!isPrepared)
         return query;
 
     if (!parameters.isEmpty())
@@ -161,8 +374,20 @@ QSqlQuery QOrmSqliteProviderPrivate::prepareAndExecute(const QString& statement,
         if (m_sqlConfiguration.verbose())
             qCDebug(qtorm) << "Bound parameters:" << parameters;
 
-        for (auto it = parameters.begin(); it != parameters.end(); ++it)
-            query.bindValue(it.key(), it.value());
+        if (m_statementGenerator.options().testFlag(
+                QOrmSqliteStatementGenerator::PositionalParameters))
+        {
+            // The keys of positional parameters are ordered by position
+            int position = 0;
+
+            for (const QVariant& value : parameters)
+                query.bindValue(position++, value);
+        }
+        else
+        {
+            for (auto it = parameters.begin(); it != parameters.end(); ++it)
+                query.bindValue(it.key(), it.value());
+        }
     }
 
     query.exec();
@@ -170,10 +395,9 @@ QSqlQuery QOrmSqliteProviderPrivate::prepareAndExecute(const QString& statement,
     return query;
 }
 
-QOrmPrivate::Expected<QObject*, QOrmError> QOrmSqliteProviderPrivate::makeEntityInstance(
-    const QOrmMetadata& entityMetadata,
-    const QSqlRecord& record,
-    QOrmEntityInstanceCache& entityInstanceCache)
+QObject* QOrmSqliteProviderPrivate::instantiateEntity(const QOrmMetadata& entityMetadata,
+                                                     const ResultRow& record,
+                                                     QOrmEntityInstanceCache& entityInstanceCache)
 {
     QObject* entityInstance = entityMetadata.qMetaObject().newInstance();
     Q_ASSERT(entityInstance != nullptr);
@@ -181,15 +405,24 @@ QOrmPrivate::Expected<QObject*, QOrmError> QOrmSqliteProviderPrivate::makeEntity
     // assign object ID and put into cache to be able to resolve cyclic references
     Q_ASSERT(entityMetadata.objectIdMapping() != nullptr);
     if (!QOrmPrivate::setPropertyValue(entityInstance,
-                                       entityMetadata.objectIdMapping()->classPropertyName(),
-                                       record.value(
-                                           entityMetadata.objectIdMapping()->tableFieldName())))
+                                       *entityMetadata.objectIdMapping(),
+                                       record.value(*entityMetadata.objectIdMapping())))
     {
         Q_ORM_UNEXPECTED_STATE;
     }
 
     entityInstanceCache.insert(entityMetadata, entityInstance);
 
+    return entityInstance;
+}
+
+QOrmPrivate::Expected<QObject*, QOrmError> QOrmSqliteProviderPrivate::makeEntityInstance(
+    const QOrmMetadata& entityMetadata,
+    const ResultRow& record,
+    QOrmEntityInstanceCache& entityInstanceCache)
+{
+    QObject* entityInstance = instantiateEntity(entityMetadata, record, entityInstanceCache);
+
     // fill the rest of the properties
     QOrmError fillError = fillEntityInstance(
         entityMetadata, entityInstance, record, entityInstanceCache, QOrm::QueryFlags::None);
@@ -202,17 +435,299 @@ QOrmPrivate::Expected<QObject*, QOrmError> QOrmSqliteProviderPrivate::makeEntity
     return entityInstance;
 }
 
+// Without an explicit column selection, all properties but the lazy references are read.
+bool QOrmSqliteProviderPrivate::isSelected(const QOrmPropertyMapping& mapping,
+                                           const QSet<QString>& selectedProperties)
+{
+    return selectedProperties.isEmpty() ? !mapping.isLazy()
+                                        : selectedProperties.contains(mapping.classPropertyName());
+}
+
+// Reads the many-to-one references of the records which are not in the entity instance cache yet.
+// The referenced instances are read with one query per reference property instead of one query
+// per record, so that fillEntityInstance() finds them in the cache afterwards.
+QOrmError QOrmSqliteProviderPrivate::prefetchReferences(
+    const QOrmMetadata& entityMetadata,
+    const QVector<ResultRow>& records,
+    QOrmEntityInstanceCache& entityInstanceCache,
+    const QFlags<QOrm::QueryFlags>& queryFlags,
+    const QSet<QString>& selectedProperties)
+{
+    for (const QOrmPropertyMapping& mapping : entityMetadata.propertyMappings())
+    {
+        if (!mapping.isReference() || mapping.isTransient() ||
+            !isSelected(mapping, selectedProperties))
+            continue;
+
+        const QOrmMetadata& referencedEntity = *mapping.referencedEntity();
+        Q_ASSERT(referencedEntity.objectIdMapping() != nullptr);
+
+        QVariantList referencedObjectIds;
+        QSet<QString> seenObjectIds;
+
+        for (const ResultRow& record : records)
+        {
+            QVariant referencedObjectId = record.value(mapping);
+
+            if (referencedObjectId.isNull() ||
+                entityInstanceCache.get(referencedEntity, referencedObjectId) != nullptr)
+            {
+                continue;
+            }
+
+            QString key = referencedObjectId.toString();
+
+            if (!seenObjectIds.contains(key))
+            {
+                seenObjectIds.insert(key);
+                referencedObjectIds.push_back(referencedObjectId);
+            }
+        }
+
+        if (referencedObjectIds.isEmpty())
+            continue;
+
+        QOrmRelation referencedRelation{referencedEntity};
+
+        QOrmError syncError = ensureSchemaSynchronized(referencedRelation);
+        if (syncError != QOrm::ErrorType::None)
+            return syncError;
+
+        // A JSON list is bound as a single parameter; otherwise, every object ID is a separate
+        // parameter and the list must be split to stay within the SQLite limits.
+        int chunkSize =
+            m_statementGenerator.options().testFlag(
+                QOrmSqliteStatementGenerator::WithJsonListParameters)
+                ? referencedObjectIds.size()
+                : m_maxVariableNumber;
+
+        for (int offset = 0; offset < referencedObjectIds.size(); offset += chunkSize)
+        {
+            QOrmFilter filter{QOrmFilterTerminalPredicate{*referencedEntity.objectIdMapping(),
+                                                          QOrm::Comparison::InList,
+                                                          referencedObjectIds.mid(offset,
+                                                                                  chunkSize)}};
+
+            QOrmQuery query{QOrm::Operation::Read,
+                            referencedRelation,
+                            referencedEntity,
+                            filter,
+                            {},
+                            {},
+                            queryFlags};
+
+            QOrmQueryResult<QObject> result = read(query, entityInstanceCache);
+
+            if (result.error().type() != QOrm::ErrorType::None)
+                return result.error();
+        }
+    }
+
+    return QOrmError{QOrm::ErrorType::None, {}};
+}
+
+// Reads the children of the one-to-many references of the records with one query per reference
+// property and groups them by the object ID of the parent.
+QOrmError QOrmSqliteProviderPrivate::prefetchCollections(
+    const QOrmMetadata& entityMetadata,
+    const QVector<ResultRow>& records,
+    QOrmEntityInstanceCache& entityInstanceCache,
+    const QFlags<QOrm::QueryFlags>& queryFlags,
+    const QSet<QString>& selectedProperties,
+    PrefetchedCollections& prefetchedCollections)
+{
+    Q_ASSERT(entityMetadata.objectIdMapping() != nullptr);
+
+    if (records.isEmpty())
+        return QOrmError{QOrm::ErrorType::None, {}};
+
+    QVariantList objectIds;
+    QSet<QString> seenObjectIds;
+
+    for (const ResultRow& record : records)
+    {
+        QVariant objectId = record.value(*entityMetadata.objectIdMapping());
+        QString key = objectId.toString();
+
+        if (!seenObjectIds.contains(key))
+        {
+            seenObjectIds.insert(key);
+            objectIds.push_back(objectId);
+        }
+    }
+
+    for (const QOrmPropertyMapping& mapping : entityMetadata.propertyMappings())
+    {
+        if (!mapping.isReference() || !mapping.isTransient() ||
+            !isSelected(mapping, selectedProperties))
+            continue;
+
+        const QOrmMetadata& referencedEntity = *mapping.referencedEntity();
+        const QOrmPropertyMapping* backReference = QOrmPrivate::backReference(mapping);
+        Q_ASSERT(backReference != nullptr);
+        Q_ASSERT(referencedEntity.objectIdMapping() != nullptr);
+
+        QOrmRelation referencedRelation{referencedEntity};
+
+        QOrmError syncError = ensureSchemaSynchronized(referencedRelation);
+        if (syncError != QOrm::ErrorType::None)
+            return syncError;
+
+        // parents without children get an empty collection
+        QHash<QString, QVector<QObject*>>& collections =
+            prefetchedCollections[mapping.classPropertyName()];
+
+        int chunkSize =
+            m_statementGenerator.options().testFlag(
+                QOrmSqliteStatementGenerator::WithJsonListParameters)
+                ? objectIds.size()
+                : m_maxVariableNumber;
+
+        for (int offset = 0; offset < objectIds.size(); offset += chunkSize)
+        {
+            QOrmFilter filter{QOrmFilterTerminalPredicate{*backReference,
+                                                          QOrm::Comparison::InList,
+                                                          objectIds.mid(offset, chunkSize)}};
+
+            // keep the children in the order they were stored
+            QOrmQuery query{QOrm::Operation::Read,
+                            referencedRelation,
+                            referencedEntity,
+                            filter,
+                            {},
+                            {QOrmOrder{*referencedEntity.objectIdMapping(), Qt::AscendingOrder}},
+                            queryFlags};
+
+            QVector<ResultRow> childRecords;
+            QOrmQueryResult<QObject> result = read(query, entityInstanceCache, &childRecords);
+
+            if (result.error().type() != QOrm::ErrorType::None)
+                return result.error();
+
+            const QVector<QObject*>& children = result.toVector();
+            Q_ASSERT(children.size() == childRecords.size());
+
+            for (int i = 0; i < children.size(); ++i)
+            {
+                collections[childRecords[i].value(*backReference).toString()]
+                    .push_back(children[i]);
+            }
+        }
+    }
+
+    return QOrmError{QOrm::ErrorType::None, {}};
+}
+
+// Fills the entity instances from their records. References and collections are read in advance
+// for all instances, so that each property costs one query per call instead of one per instance.
+QOrmError QOrmSqliteProviderPrivate::hydrateEntityInstances(
+    const QOrmMetadata& entityMetadata,
+    const QVector<QObject*>& entityInstances,
+    const QVector<ResultRow>& records,
+    QOrmEntityInstanceCache& entityInstanceCache,
+    const QFlags<QOrm::QueryFlags>& queryFlags,
+    const QSet<QString>& selectedProperties,
+    bool areNewInstances)
+{
+    Q_ASSERT(entityInstances.size() == records.size());
+
+    if (entityInstances.isEmpty())
+        return QOrmError{QOrm::ErrorType::None, {}};
+
+    QOrmError error = prefetchReferences(
+        entityMetadata, records, entityInstanceCache, queryFlags, selectedProperties);
+
+    if (error != QOrm::ErrorType::None)
+        return error;
+
+    PrefetchedCollections prefetchedCollections;
+    error = prefetchCollections(entityMetadata,
+                                records,
+                                entityInstanceCache,
+                                queryFlags,
+                                selectedProperties,
+                                prefetchedCollections);
+
+    if (error != QOrm::ErrorType::None)
+        return error;
+
+    for (int i = 0; i < entityInstances.size(); ++i)
+    {
+        bool wasModified = !areNewInstances && entityInstanceCache.isModified(entityInstances[i]);
+
+        error = fillEntityInstance(entityMetadata,
+                                   entityInstances[i],
+                                   records[i],
+                                   entityInstanceCache,
+                                   queryFlags,
+                                   selectedProperties,
+                                   &prefetchedCollections);
+
+        if (error != QOrm::ErrorType::None)
+            return error;
+
+        if (areNewInstances)
+        {
+            // properties which were not selected are read on demand by QOrmSession::load()
+            for (const QOrmPropertyMapping& mapping : entityMetadata.propertyMappings())
+            {
+                if (selectedProperties.isEmpty() || isSelected(mapping, selectedProperties) ||
+                    (mapping.isTransient() && !mapping.isReference()))
+                {
+                    continue;
+                }
+
+                QVariant key = mapping.isReference() && mapping.isTransient()
+                                   ? records[i].value(*entityMetadata.objectIdMapping())
+                                   : QVariant{};
+
+                entityInstanceCache.markUnfetched(
+                    entityInstances[i], mapping.classPropertyName(), key);
+            }
+
+            entityInstanceCache.finalize(entityMetadata, entityInstances[i]);
+        }
+        else
+        {
+            for (const QString& propertyName : selectedProperties)
+                entityInstanceCache.markFetched(entityInstances[i], propertyName);
+
+            // a partial refill keeps the changes of the properties which were not read
+            if (selectedProperties.isEmpty() || !wasModified)
+                entityInstanceCache.markUnmodified(entityInstances[i]);
+        }
+    }
+
+    return QOrmError{QOrm::ErrorType::None, {}};
+}
+
 QOrmError QOrmSqliteProviderPrivate::fillEntityInstance(
     const QOrmMetadata& entityMetadata,
     QObject* entityInstance,
-    const QSqlRecord& record,
+    const ResultRow& record,
     QOrmEntityInstanceCache& entityInstanceCache,
-    const QFlags<QOrm::QueryFlags>& queryFlags)
+    const QFlags<QOrm::QueryFlags>& queryFlags,
+    const QSet<QString>& selectedProperties,
+    const PrefetchedCollections* prefetchedCollections)
 {
     for (const QOrmPropertyMapping& mapping : entityMetadata.propertyMappings())
     {
+        // properties missing from an explicit column selection are not in the record
+        if (!selectedProperties.isEmpty() && !isSelected(mapping, selectedProperties))
+        {
+            continue;
+        }
+        // lazy references are loaded on demand: remember what is needed to load them
+        else if (mapping.isReference() && !isSelected(mapping, selectedProperties))
+        {
+            QVariant key = mapping.isTransient()
+                               ? record.value(*entityMetadata.objectIdMapping())
+                               : record.value(mapping);
+
+            entityInstanceCache.markUnfetched(entityInstance, mapping.classPropertyName(), key);
+        }
         // if this property is a reference, retrieve referenced entity instances and assign
-        if (mapping.isReference())
+        else if (mapping.isReference())
         {
             QOrmRelation referencedRelation{*mapping.referencedEntity()};
 
@@ -227,49 +742,48 @@ QOrmError QOrmSqliteProviderPrivate::fillEntityInstance(
                 Q_ASSERT(backReference != nullptr);
                 Q_ASSERT(entityMetadata.objectIdMapping() != nullptr);
 
-                // read all entity instances referring to the current record
-                //                QVariant objectId =
-                //                    record.value(entityMetadata.objectIdMapping()->tableFieldName());
+                QOrmQueryResult<QObject> result{QVector<QObject*>{}, 0};
+
+                // take the prefetched entity instances referring to the current record, if any
+                if (prefetchedCollections != nullptr &&
+                    prefetchedCollections->contains(mapping.classPropertyName()))
+                {
+                    QVector<QObject*> children =
+                        prefetchedCollections->value(mapping.classPropertyName())
+                            .value(record.value(*entityMetadata.objectIdMapping())
+                                       .toString());
 
-                QOrmFilter filter{*backReference == entityInstance};
+                    result = QOrmQueryResult<QObject>{children, static_cast<int>(children.size())};
+                }
+                // read all entity instances referring to the current record
+                else
+                {
+                    QOrmFilter filter{*backReference == entityInstance};
 
-                QOrmQuery query{QOrm::Operation::Read,
-                                referencedRelation,
-                                *mapping.referencedEntity(),
-                                filter,
-                                {},
-                                {},
-                                queryFlags};
+                    QOrmQuery query{QOrm::Operation::Read,
+                                    referencedRelation,
+                                    *mapping.referencedEntity(),
+                                    filter,
+                                    {},
+                                    {},
+                                    queryFlags};
 
-                QOrmQueryResult<QObject> result = read(query, entityInstanceCache);
+                    result = read(query, entityInstanceCache);
 
-                // error during read: return this error and do not continue
-                if (result.error().type() != QOrm::ErrorType::None)
-                {
-                    return result.error();
+                    // error during read: return this error and do not continue
+                    if (result.error().type() != QOrm::ErrorType::None)
+                    {
+                        return result.error();
+                    }
                 }
 
                 // dispatch according to declared property type
-                QVariant propertyValue;
-
-                if (mapping.dataTypeName().startsWith("QList<"))
-                {
-                    propertyValue = QVariant::fromValue(result.toList());
-                }
-                else if (mapping.dataTypeName().startsWith("QVector<"))
-                {
-                    propertyValue = QVariant::fromValue(result.toVector());
-                }
-                else if (mapping.dataTypeName().startsWith("QSet<"))
-                {
-                    propertyValue = QVariant::fromValue(result.toSet());
-                }
-                else
-                    Q_ORM_UNEXPECTED_STATE;
+                QVariant propertyValue =
+                    QOrmPrivate::referenceCollectionValue(mapping, result.toVector());
 
                 Q_ASSERT(propertyValue.isValid() && !propertyValue.isNull());
                 if (!QOrmPrivate::setPropertyValue(entityInstance,
-                                                   mapping.classPropertyName(),
+                                                   mapping,
                                                    propertyValue))
                 {
                     Q_ORM_UNEXPECTED_STATE;
@@ -281,7 +795,7 @@ QOrmError QOrmSqliteProviderPrivate::fillEntityInstance(
                 Q_ASSERT(mapping.referencedEntity() != nullptr);
 
                 // try to retrieve the referenced instance from the cache.
-                QVariant referencedObjectId = record.value(mapping.tableFieldName());
+                QVariant referencedObjectId = record.value(mapping);
 
                 if (referencedObjectId.isNull())
                     continue;
@@ -300,7 +814,7 @@ QOrmError QOrmSqliteProviderPrivate::fillEntityInstance(
                     }
 
                     if (!QOrmPrivate::setPropertyValue(entityInstance,
-                                                       mapping.classPropertyName(),
+                                                       mapping,
                                                        QVariant::fromValue(
                                                            referencedEntityInstance)))
                     {
@@ -345,7 +859,7 @@ QOrmError QOrmSqliteProviderPrivate::fillEntityInstance(
                     }
 
                     if (!QOrmPrivate::setPropertyValue(entityInstance,
-                                                       mapping.classPropertyName(),
+                                                       mapping,
                                                        QVariant::fromValue(
                                                            result.toVector().front())))
                     {
@@ -357,11 +871,10 @@ QOrmError QOrmSqliteProviderPrivate::fillEntityInstance(
         // just a value: set the property value
         else if (!mapping.isTransient())
         {
-            bool isNull = record.isNull(mapping.tableFieldName());
-            QVariant propertyValue = isNull ? QVariant{} : record.value(mapping.tableFieldName());
+            QVariant propertyValue = record.value(mapping);
 
             if (!QOrmPrivate::setPropertyValue(entityInstance,
-                                               mapping.classPropertyName(),
+                                               mapping,
                                                propertyValue))
             {
                 qFatal("Unable to setPropertyValue() for %s <-> %s",
@@ -437,6 +950,10 @@ QOrmError QOrmSqliteProviderPrivate::ensureSchemaSynchronized(const QOrmRelation
                     break;
             }
 
+            // Prepared statements referring to a modified table must be prepared anew.
+            if (effectiveSchemaMode != QOrmSqliteConfiguration::SchemaMode::Bypass)
+                clearStatementCache();
+
             if (error.type() == QOrm::ErrorType::None)
             {
                 m_schemaSyncCache.insert(relation.mapping()->className());
@@ -791,13 +1308,54 @@ QOrmError QOrmSqliteProviderPrivate::appendSchema(const QOrmRelation& relation)
 
 QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::read(
     const QOrmQuery& query,
-    QOrmEntityInstanceCache& entityInstanceCache)
+    QOrmEntityInstanceCache& entityInstanceCache,
+    QVector<ResultRow>* resultRecords)
 {
     Q_ASSERT(query.projection().has_value());
 
+    if (!query.aggregates().empty())
+        return readValues(query);
+
+    auto [statement, boundParameters] = m_statementGenerator.generate(query);
+
+    QSqlQuery sqlQuery =
+        prepareAndExecute(statement, boundParameters, StatementCaching::Enabled);
+    auto finishQuery = qScopeGuard([&sqlQuery] { sqlQuery.finish(); });
+
+    if (sqlQuery.lastError().type() != QSqlError::NoError)
+    {
+        return QOrmQueryResult<QObject>{QOrmError{QOrm::ErrorType::Provider,
+                                                  sqlQuery.lastError().text()},
+                                        sqlQuery.numRowsAffected()};
+    }
+
+    // Read all rows before instantiating any entity: the references of the whole result set
+    // are then loaded in batches instead of with a query per row.
+    auto columns = std::make_shared<const ResultColumns>(*query.projection(), sqlQuery.record());
+    QVector<ResultRow> records;
+
+    while (sqlQuery.next())
+        records.push_back(ResultRow{columns, sqlQuery});
+
+    sqlQuery.finish();
+
+    if (resultRecords != nullptr)
+        *resultRecords = records;
+
+    return readRecords(query, records, entityInstanceCache);
+}
+
+// Reads the values of a query with aggregates. No entity instances are created.
+QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::readValues(const QOrmQuery& query)
+{
+    if (query.invokableFilter().has_value())
+        qFatal("qtorm: Invokable filter is unsupported for aggregate queries.");
+
     auto [statement, boundParameters] = m_statementGenerator.generate(query);
 
-    QSqlQuery sqlQuery = prepareAndExecute(statement, boundParameters);
+    QSqlQuery sqlQuery =
+        prepareAndExecute(statement, boundParameters, StatementCaching::Enabled);
+    auto finishQuery = qScopeGuard([&sqlQuery] { sqlQuery.finish(); });
 
     if (sqlQuery.lastError().type() != QSqlError::NoError)
     {
@@ -806,27 +1364,66 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::read(
                                         sqlQuery.numRowsAffected()};
     }
 
+    QVector<QVariantList> values;
+    int columnCount = sqlQuery.record().count();
+
+    while (sqlQuery.next())
+    {
+        QVariantList row;
+        row.reserve(columnCount);
+
+        for (int i = 0; i < columnCount; ++i)
+            row.push_back(sqlQuery.value(i));
+
+        values.push_back(row);
+    }
+
+    return QOrmQueryResult<QObject>{values};
+}
+
+// Makes the entity instances of the records read by the query, or takes them from the cache.
+QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::readRecords(
+    const QOrmQuery& query,
+    const QVector<ResultRow>& records,
+    QOrmEntityInstanceCache& entityInstanceCache)
+{
     QVector<QObject*> resultSet;
+    resultSet.reserve(records.size());
 
     const QOrmPropertyMapping* objectIdMapping = query.projection()->objectIdMapping();
 
+    // Everything the query reads is recorded, so that the instances read only for the rows which
+    // the invokable filter rejects can be evicted again, including those read for references.
+    bool isFiltered = query.invokableFilter().has_value();
+
+    if (isFiltered)
+        entityInstanceCache.beginRecordingInsertions();
+
+    auto recordingFinisher = qScopeGuard([isFiltered, &entityInstanceCache]() {
+        if (isFiltered)
+            std::ignore = entityInstanceCache.endRecordingInsertions();
+    });
+
+    QSet<QString> selectedProperties;
+
+    for (const QOrmPropertyMapping& mapping : query.columns())
+        selectedProperties.insert(mapping.classPropertyName());
+
     // If there is an object ID, compare the cached entities with the ones read from the
     // backend. If there is an inconsistency, it will be reported.
     // All read entities are replaced with their cached versions if found.
     if (objectIdMapping != nullptr)
     {
-        while (sqlQuery.next())
+        // If inconsistent, return an error before anything is instantiated. Already cached
+        // instances remain in the cache
+        if (!query.flags().testFlag(QOrm::QueryFlags::OverwriteCachedInstances))
         {
-            QVariant objectId = sqlQuery.value(objectIdMapping->tableFieldName());
+            for (const ResultRow& record : records)
+            {
+                QObject* cachedInstance = entityInstanceCache.get(
+                    *query.projection(), record.value(*objectIdMapping));
 
-            QObject* cachedInstance = entityInstanceCache.get(*query.projection(), objectId);
-
-            // cached instance: check if consistent
-            if (cachedInstance != nullptr)
-            {
-                // If inconsistent, return an error. Already cached instances remain in the cache
-                if (entityInstanceCache.isModified(cachedInstance) &&
-                    !query.flags().testFlag(QOrm::QueryFlags::OverwriteCachedInstances))
+                if (cachedInstance != nullptr && entityInstanceCache.isModified(cachedInstance))
                 {
                     QString errorString;
                     QDebug dbg{&errorString};
@@ -838,48 +1435,124 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::read(
                     return QOrmQueryResult<QObject>{
                         QOrmError{QOrm::ErrorType::UnsynchronizedEntity, errorString}};
                 }
-                else if (query.flags().testFlag(QOrm::QueryFlags::OverwriteCachedInstances))
+            }
+        }
+
+        // New instances are put into the cache before any of them is filled to be able to
+        // resolve cyclic references. Cached instances are refilled only if overwriting;
+        // otherwise only their unfetched properties which were read are filled, grouped by the
+        // set of these properties.
+        QVector<QObject*> newInstances;
+        QVector<ResultRow> newRecords;
+        QVector<QObject*> cachedInstances;
+        QVector<ResultRow> cachedRecords;
+        std::map<QStringList, std::pair<QVector<QObject*>, QVector<ResultRow>>> refills;
+
+        for (const ResultRow& record : records)
+        {
+            QVariant objectId = record.value(*objectIdMapping);
+
+            QObject* cachedInstance = entityInstanceCache.get(*query.projection(), objectId);
+
+            if (cachedInstance != nullptr)
+            {
+                if (query.flags().testFlag(QOrm::QueryFlags::OverwriteCachedInstances))
+                {
+                    cachedInstances.push_back(cachedInstance);
+                    cachedRecords.push_back(record);
+                }
+                else
                 {
-                    QOrmError error = fillEntityInstance(*query.projection(),
-                                                         cachedInstance,
-                                                         sqlQuery.record(),
-                                                         entityInstanceCache,
-                                                         query.flags());
+                    QStringList refilledProperties;
 
-                    if (error != QOrm::ErrorType::None)
+                    for (const QString& propertyName :
+                         entityInstanceCache.unfetchedProperties(cachedInstance))
                     {
-                        return QOrmQueryResult<QObject>{error};
+                        const QOrmPropertyMapping* mapping =
+                            query.projection()->classPropertyMapping(propertyName);
+
+                        if (mapping != nullptr && isSelected(*mapping, selectedProperties))
+                            refilledProperties.push_back(propertyName);
                     }
 
-                    entityInstanceCache.markUnmodified(cachedInstance);
+                    if (!refilledProperties.isEmpty())
+                    {
+                        refilledProperties.sort();
+
+                        auto& [instances, instanceRecords] = refills[refilledProperties];
+                        instances.push_back(cachedInstance);
+                        instanceRecords.push_back(record);
+                    }
                 }
 
                 resultSet.push_back(cachedInstance);
             }
-            // new instance: it will be cached in makeEntityInstance
             else
             {
-                QOrmPrivate::Expected<QObject*, QOrmError> entityInstance =
-                    makeEntityInstance(*query.projection(), sqlQuery.record(), entityInstanceCache);
+                QObject* entityInstance =
+                    instantiateEntity(*query.projection(), record, entityInstanceCache);
 
-                if (entityInstance)
-                {
-                    resultSet.push_back(entityInstance.value());
-                }
-                else
-                {
-                    return QOrmQueryResult<QObject>{entityInstance.error()};
-                }
+                newInstances.push_back(entityInstance);
+                newRecords.push_back(record);
+
+                resultSet.push_back(entityInstance);
             }
         }
+
+        QOrmError error = hydrateEntityInstances(*query.projection(),
+                                                 cachedInstances,
+                                                 cachedRecords,
+                                                 entityInstanceCache,
+                                                 query.flags(),
+                                                 selectedProperties,
+                                                 false);
+
+        if (error != QOrm::ErrorType::None)
+            return QOrmQueryResult<QObject>{error};
+
+        for (const auto& [refilledProperties, refill] : refills)
+        {
+            QSet<QString> refilledPropertySet;
+
+            for (const QString& propertyName : refilledProperties)
+                refilledPropertySet.insert(propertyName);
+
+            error = hydrateEntityInstances(*query.projection(),
+                                           refill.first,
+                                           refill.second,
+                                           entityInstanceCache,
+                                           query.flags(),
+                                           refilledPropertySet,
+                                           false);
+
+            if (error != QOrm::ErrorType::None)
+                return QOrmQueryResult<QObject>{error};
+        }
+
+        error = hydrateEntityInstances(*query.projection(),
+                                       newInstances,
+                                       newRecords,
+                                       entityInstanceCache,
+                                       QOrm::QueryFlags::None,
+                                       selectedProperties,
+                                       true);
+
+        if (error != QOrm::ErrorType::None)
+            return QOrmQueryResult<QObject>{error};
     }
     // No object ID in this projection: cannot cache, just return the results
     else
     {
-        while (sqlQuery.next())
+        QOrmError prefetchError =
+            prefetchReferences(*query.projection(), records, entityInstanceCache, query.flags());
+
+        if (prefetchError != QOrm::ErrorType::None)
+            return QOrmQueryResult<QObject>{prefetchError};
+
+        for (const ResultRow& record : records)
         {
             QOrmPrivate::Expected<QObject*, QOrmError> entityInstance =
-                makeEntityInstance(*query.projection(), sqlQuery.record(), entityInstanceCache);
+                makeEntityInstance(*query.projection(), record, entityInstanceCache);
 
             if (entityInstance)
             {
@@ -897,19 +1570,41 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::read(
 
     if (query.invokableFilter().has_value())
     {
-        auto it = std::remove_if(std::begin(resultSet),
-                                 std::end(resultSet),
-                                 [&query](const QObject* value)
-                                 { return !(*query.invokableFilter()->invokable())(value); });
+        auto it = std::stable_partition(std::begin(resultSet),
+                                        std::end(resultSet),
+                                        [&query](const QObject* value)
+                                        { return (*query.invokableFilter()->invokable())(value); });
+
+        // Rejected instances which were instantiated by this query are not kept: the consumer
+        // never sees them. Neither are the instances read only for their references and
+        // collections. Instances which were already cached stay in the cache.
+        recordingFinisher.dismiss();
+        QVector<QObject*> recorded = entityInstanceCache.endRecordingInsertions();
+
+        // without object ID, the rejected instances are not cached
+        if (objectIdMapping == nullptr)
+            qDeleteAll(it, std::end(resultSet));
+
         resultSet.erase(it, std::end(resultSet));
+
+        entityInstanceCache.evictUnreachable(recorded, *query.projection(), resultSet);
     }
 
     return QOrmQueryResult<QObject>{resultSet, static_cast<int>(resultSet.size())};
 }
 
-QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::merge(const QOrmQuery& query)
+QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::merge(
+    const QOrmQuery& query,
+    QOrmEntityInstanceCache& entityInstanceCache)
 {
     Q_ASSERT(query.relation().type() == QOrm::RelationType::Mapping);
+
+    if (query.operation() == QOrm::Operation::Create && !query.entityInstances().isEmpty())
+        return insertAll(query);
+
+    if (query.operation() == QOrm::Operation::Update && query.entityInstance() == nullptr)
+        return updateAll(query, entityInstanceCache);
+
     Q_ASSERT(query.entityInstance() != nullptr);
 
     if (query.invokableFilter().has_value())
@@ -917,9 +1612,55 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::merge(const QOrmQuery& query
         qFatal("qtorm: Invokable filter is unsupported for merge operation.");
     }
 
-    auto [statement, boundParameters] = m_statementGenerator.generate(query);
+    QString statement;
+    QVariantMap boundParameters;
+
+    // unfetched lazy references must not be overwritten with their default values
+    QSet<QString> skippedProperties =
+        entityInstanceCache.unfetchedProperties(query.entityInstance());
+
+    // only the columns of modified properties are written
+    if (query.operation() == QOrm::Operation::Update)
+    {
+        const QSet<QString> modifiedProperties =
+            entityInstanceCache.modifiedProperties(query.entityInstance());
+        QSet<QString> unmodifiedColumns;
+        bool hasModifiedColumn = false;
+
+        for (const QOrmPropertyMapping& mapping : query.relation().mapping()->propertyMappings())
+        {
+            if (mapping.isTransient() || mapping.isObjectId() ||
+                skippedProperties.contains(mapping.classPropertyName()))
+            {
+                continue;
+            }
+
+            if (modifiedProperties.contains(mapping.classPropertyName()))
+                hasModifiedColumn = true;
+            else
+                unmodifiedColumns.insert(mapping.classPropertyName());
+        }
+
+        // e.g. only a one-to-many collection was assigned: the whole row is written
+        if (hasModifiedColumn)
+            skippedProperties.unite(unmodifiedColumns);
+    }
+
+    if (query.operation() == QOrm::Operation::Update && !skippedProperties.isEmpty())
+    {
+        statement = m_statementGenerator.generateUpdateStatement(*query.relation().mapping(),
+                                                                 query.entityInstance(),
+                                                                 boundParameters,
+                                                                 skippedProperties);
+    }
+    else
+    {
+        std::tie(statement, boundParameters) = m_statementGenerator.generate(query);
+    }
 
-    QSqlQuery sqlQuery = prepareAndExecute(statement, boundParameters);
+    QSqlQuery sqlQuery =
+        prepareAndExecute(statement, boundParameters, StatementCaching::Enabled);
+    auto finishQuery = qScopeGuard([&sqlQuery] { sqlQuery.finish(); });
 
     if (sqlQuery.lastError().type() != QSqlError::NoError)
     {
@@ -937,6 +1678,396 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::merge(const QOrmQuery& query
     return QOrmQueryResult<QObject>{sqlQuery.lastInsertId(), sqlQuery.numRowsAffected()};
 }
 
+// Inserts the entity instances using multi-row INSERT statements. Each statement binds at most
+// m_maxVariableNumber parameters. The autogenerated object IDs are returned as a QVariantList in
+// the order of the entity instances.
+//
+// Without the RETURNING clause, the IDs generated by a multi-row INSERT cannot be retrieved, and
+// the instances of entities with autogenerated object IDs are inserted one by one.
+//
+// SQLite does not specify the order of the rows returned by RETURNING. The IDs are matched to the
+// instances relying on SQLite assigning the largest rowid plus one to every new row: the rows of
+// one statement get consecutive IDs in the order of the VALUES list. This does not hold once the
+// largest possible rowid is in use; IDs which are not consecutive are reported as an error instead
+// of being assigned to the wrong instances.
+QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::insertAll(const QOrmQuery& query)
+{
+    const QOrmMetadata& entity = *query.relation().mapping();
+    const QVector<QObject*>& instances = query.entityInstances();
+
+    bool withAutogeneratedId =
+        entity.objectIdMapping() != nullptr && entity.objectIdMapping()->isAutogenerated();
+    bool withReturning =
+        m_statementGenerator.options().testFlag(QOrmSqliteStatementGenerator::WithReturningClause);
+
+    int columnCount = 0;
+    for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
+    {
+        if (!mapping.isAutogenerated() && !mapping.isTransient())
+            ++columnCount;
+    }
+
+    int rowsPerStatement = withAutogeneratedId && !withReturning
+                               ? 1
+                               : qMax(1, m_maxVariableNumber / qMax(1, columnCount));
+
+    QVariantList insertedIds;
+    int numRowsAffected = 0;
+
+    for (int first = 0; first < instances.size(); first += rowsPerStatement)
+    {
+        QVector<QObject*> rows = instances.mid(first, rowsPerStatement);
+        QVariantMap boundParameters;
+        QString statement =
+            m_statementGenerator.generateInsertStatement(entity, rows, boundParameters);
+
+        QSqlQuery sqlQuery =
+            prepareAndExecute(statement, boundParameters, StatementCaching::Enabled);
+        auto finishQuery = qScopeGuard([&sqlQuery] { sqlQuery.finish(); });
+
+        if (sqlQuery.lastError().type() != QSqlError::NoError)
+        {
+            return QOrmQueryResult<QObject>{{QOrm::ErrorType::Provider,
+                                             sqlQuery.lastError().text()},
+                                            numRowsAffected};
+        }
+
+        int rowsAffected = sqlQuery.numRowsAffected();
+
+        if (withAutogeneratedId && withReturning)
+        {
+            std::vector<qlonglong> ids;
+
+            while (sqlQuery.next())
+                ids.push_back(sqlQuery.value(0).toLongLong());
+
+            std::sort(ids.begin(), ids.end());
+
+            if (!ids.empty() && ids.back() - ids.front() + 1 != static_cast<qlonglong>(ids.size()))
+            {
+                return QOrmQueryResult<QObject>{
+                    {QOrm::ErrorType::Provider,
+                     QStringLiteral("Rows inserted by a multi-row INSERT got non-consecutive IDs")},
+                    numRowsAffected};
+            }
+
+            for (qlonglong id : ids)
+                insertedIds.push_back(id);
+
+            rowsAffected = static_cast<int>(ids.size());
+        }
+        else if (withAutogeneratedId)
+        {
+            insertedIds.push_back(sqlQuery.lastInsertId());
+        }
+
+        if (rowsAffected != rows.size())
+        {
+            return QOrmQueryResult<QObject>{{QOrm::ErrorType::UnsynchronizedEntity,
+                                             "Unexpected number of rows affected"},
+                                            numRowsAffected + rowsAffected};
+        }
+
+        numRowsAffected += rowsAffected;
+    }
+
+    return QOrmQueryResult<QObject>{QVariant{insertedIds}, numRowsAffected};
+}
+
+// Inserts or updates the entity instances by their object IDs using multi-row INSERT ... ON
+// CONFLICT DO UPDATE statements, chunked like insertAll(). Before SQLite 3.24.0, each instance is
+// updated first, and the instances without an existing row are inserted.
+QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::upsertAll(const QOrmQuery& query)
+{
+    const QOrmMetadata& entity = *query.relation().mapping();
+    QVector<QObject*> instances = query.entityInstances();
+
+    if (instances.isEmpty())
+        instances.push_back(const_cast<QObject*>(query.entityInstance()));
+
+    int numRowsAffected = 0;
+
+    if (!m_statementGenerator.options().testFlag(QOrmSqliteStatementGenerator::WithUpsertClause))
+    {
+        QVector<QObject*> newInstances;
+
+        for (QObject* instance : instances)
+        {
+            QVariantMap boundParameters;
+            QString statement =
+                m_statementGenerator.generateUpdateStatement(entity, instance, boundParameters);
+
+            QSqlQuery sqlQuery =
+                prepareAndExecute(statement, boundParameters, StatementCaching::Enabled);
+            auto finishQuery = qScopeGuard([&sqlQuery] { sqlQuery.finish(); });
+
+            if (sqlQuery.lastError().type() != QSqlError::NoError)
+            {
+                return QOrmQueryResult<QObject>{{QOrm::ErrorType::Provider,
+                                                 sqlQuery.lastError().text()},
+                                                numRowsAffected};
+            }
+
+            if (sqlQuery.numRowsAffected() == 0)
+                newInstances.push_back(instance);
+            else
+                numRowsAffected += sqlQuery.numRowsAffected();
+        }
+
+        instances = newInstances;
+    }
+
+    int columnCount = 0;
+    for (const QOrmPropertyMapping& mapping : entity.propertyMappings())
+    {
+        if (!mapping.isTransient())
+            ++columnCount;
+    }
+
+    int rowsPerStatement = qMax(1, m_maxVariableNumber / qMax(1, columnCount));
+
+    for (int first = 0; first < instances.size(); first += rowsPerStatement)
+    {
+        QVector<QObject*> rows = instances.mid(first, rowsPerStatement);
+        QVariantMap boundParameters;
+        QString statement =
+            m_statementGenerator.generateUpsertStatement(entity, rows, boundParameters);
+
+        QSqlQuery sqlQuery =
+            prepareAndExecute(statement, boundParameters, StatementCaching::Enabled);
+        auto finishQuery = qScopeGuard([&sqlQuery] { sqlQuery.finish(); });
+
+        if (sqlQuery.lastError().type() != QSqlError::NoError)
+        {
+            return QOrmQueryResult<QObject>{{QOrm::ErrorType::Provider,
+                                             sqlQuery.lastError().text()},
+                                            numRowsAffected};
+        }
+
+        // an existing row of an entity without other columns is left untouched
+        if (sqlQuery.numRowsAffected() != rows.size() && columnCount > 1)
+        {
+            return QOrmQueryResult<QObject>{{QOrm::ErrorType::UnsynchronizedEntity,
+                                             "Unexpected number of rows affected"},
+                                            numRowsAffected + sqlQuery.numRowsAffected()};
+        }
+
+        numRowsAffected += sqlQuery.numRowsAffected();
+    }
+
+    return QOrmQueryResult<QObject>{QVariant{}, numRowsAffected};
+}
+
+// Set-based update. The cached entity instances of the updated rows are assigned the new values.
+// Their IDs are returned by the RETURNING clause, or read before the update without it.
+QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::updateAll(
+    const QOrmQuery& query,
+    QOrmEntityInstanceCache& entityInstanceCache)
+{
+    if (query.invokableFilter().has_value())
+    {
+        qFatal("qtorm: Invokable filter is unsupported for update operation.");
+    }
+
+    Q_Q(QOrmSqliteProvider);
+
+    const QOrmMetadata& entity = *query.relation().mapping();
+    bool withReturning =
+        m_statementGenerator.options().testFlag(QOrmSqliteStatementGenerator::WithReturningClause);
+    QVariantList updatedIds;
+
+    // without RETURNING, no other connection may change the rows between reading their IDs and
+    // updating them
+    bool readsIds = !withReturning && entity.objectIdMapping() != nullptr;
+
+    if (readsIds)
+    {
+        QOrmError error = q->beginTransaction();
+
+        if (error.type() != QOrm::ErrorType::None)
+            return QOrmQueryResult<QObject>{error};
+    }
+
+    auto rollback = qScopeGuard([q, readsIds] {
+        if (readsIds)
+            q->rollbackTransaction();
+    });
+
+    if (readsIds)
+    {
+        QOrmQuery idQuery{QOrm::Operation::Read,
+                          query.relation(),
+                          entity,
+                          query.expressionFilter(),
+                          {},
+                          {},
+                          QOrm::QueryFlags::None};
+        idQuery.setColumns({*entity.objectIdMapping()});
+
+        auto [statement, boundParameters] = m_statementGenerator.generate(idQuery);
+        QSqlQuery sqlQuery =
+            prepareAndExecute(statement, boundParameters, StatementCaching::Enabled);
+        auto finishQuery = qScopeGuard([&sqlQuery] { sqlQuery.finish(); });
+
+        if (sqlQuery.lastError().type() != QSqlError::NoError)
+        {
+            return QOrmQueryResult<QObject>{
+                QOrmError{QOrm::ErrorType::Provider, sqlQuery.lastError().text()}};
+        }
+
+        while (sqlQuery.next())
+            updatedIds.push_back(sqlQuery.value(0));
+    }
+
+    auto [statement, boundParameters] = m_statementGenerator.generate(query);
+
+    QSqlQuery sqlQuery =
+        prepareAndExecute(statement, boundParameters, StatementCaching::Enabled);
+    auto finishQuery = qScopeGuard([&sqlQuery] { sqlQuery.finish(); });
+
+    if (sqlQuery.lastError().type() != QSqlError::NoError)
+    {
+        return QOrmQueryResult<QObject>{{QOrm::ErrorType::Provider, sqlQuery.lastError().text()},
+                                        sqlQuery.numRowsAffected()};
+    }
+
+    if (withReturning)
+    {
+        while (sqlQuery.next())
+            updatedIds.push_back(sqlQuery.value(0));
+    }
+
+    rollback.dismiss();
+
+    if (readsIds)
+    {
+        QOrmError error = q->commitTransaction();
+
+        if (error.type() != QOrm::ErrorType::None)
+            return QOrmQueryResult<QObject>{error};
+    }
+
+    for (const QVariant& objectId : updatedIds)
+    {
+        if (QObject* entityInstance = entityInstanceCache.get(entity, objectId))
+            assignUpdatedValues(entityInstance, query.assignments(), entityInstanceCache);
+    }
+
+    return QOrmQueryResult<QObject>{QVector<QObject*>{}, sqlQuery.numRowsAffected()};
+}
+
+// The assigned properties of a cached instance are synchronized with the database; its other
+// modifications are kept.
+void QOrmSqliteProviderPrivate::assignUpdatedValues(
+    QObject* entityInstance,
+    const std::vector<std::pair<QOrmPropertyMapping, QVariant>>& assignments,
+    QOrmEntityInstanceCache& entityInstanceCache)
+{
+    bool wasModified = entityInstanceCache.isModified(entityInstance);
+
+    for (const auto& [mapping, value] : assignments)
+    {
+        QVariant propertyValue = value;
+        QVariant unfetchedKey;
+        const QOrmPropertyMapping* backReference = nullptr;
+        QObject* previousOwner = nullptr;
+
+        if (mapping.isReference())
+        {
+            QVariant previousKey =
+                entityInstanceCache.unfetchedKey(entityInstance, mapping.classPropertyName());
+
+            backReference = QOrmPrivate::backReference(mapping);
+            previousOwner =
+                previousKey.isValid()
+                    ? entityInstanceCache.get(*mapping.referencedEntity(), previousKey)
+                    : QOrmPrivate::propertyValue(entityInstance, mapping).value<QObject*>();
+
+            QObject* referencedInstance = value.value<QObject*>();
+
+            // an object ID: the referenced instance is loaded on demand if it is not cached
+            if (referencedInstance == nullptr && !value.isNull() && !value.canConvert<QObject*>())
+            {
+                referencedInstance = entityInstanceCache.get(*mapping.referencedEntity(), value);
+
+                if (referencedInstance == nullptr)
+                    unfetchedKey = value;
+            }
+
+            propertyValue = QVariant::fromValue(referencedInstance);
+        }
+
+        if (!QOrmPrivate::setPropertyValue(entityInstance, mapping, propertyValue))
+        {
+            qFatal("Unable to setPropertyValue() for %s <-> %s",
+                   qPrintable(mapping.classPropertyName()),
+                   qPrintable(mapping.tableFieldName()));
+        }
+
+        entityInstanceCache.markFetched(entityInstance, mapping.classPropertyName());
+
+        if (unfetchedKey.isValid())
+        {
+            entityInstanceCache.markUnfetched(
+                entityInstance, mapping.classPropertyName(), unfetchedKey);
+        }
+
+        if (backReference != nullptr && backReference->isTransient())
+        {
+            moveToCollection(entityInstance,
+                             *backReference,
+                             previousOwner,
+                             propertyValue.value<QObject*>(),
+                             entityInstanceCache);
+        }
+    }
+
+    if (!wasModified)
+        entityInstanceCache.markUnmodified(entityInstance);
+}
+
+// Moves an instance whose many-to-one reference was updated in the database from the one-to-many
+// collection of its previous owner to the one of its new owner. Unfetched collections are left
+// alone: they are read completely when loaded.
+void QOrmSqliteProviderPrivate::moveToCollection(QObject* entityInstance,
+                                                 const QOrmPropertyMapping& backReference,
+                                                 QObject* previousOwner,
+                                                 QObject* owner,
+                                                 QOrmEntityInstanceCache& entityInstanceCache)
+{
+    if (previousOwner == owner)
+        return;
+
+    auto update = [&](QObject* collectionOwner, bool contains) {
+        if (collectionOwner == nullptr || !entityInstanceCache.contains(collectionOwner) ||
+            !entityInstanceCache.isFetched(collectionOwner, backReference.classPropertyName()))
+        {
+            return;
+        }
+
+        QVector<QObject*> members = QOrmPrivate::propertyValue(collectionOwner, backReference)
+                                        .value<QVector<QObject*>>();
+        members.removeAll(entityInstance);
+
+        if (contains)
+            members.push_back(entityInstance);
+
+        if (!QOrmPrivate::setPropertyValue(
+                collectionOwner,
+                backReference,
+                QOrmPrivate::referenceCollectionValue(backReference, members)))
+        {
+            Q_ORM_UNEXPECTED_STATE;
+        }
+
+        // the collection reflects the database: it is not a change of the owner
+        entityInstanceCache.markFetched(collectionOwner, backReference.classPropertyName());
+    };
+
+    update(previousOwner, false);
+    update(owner, true);
+}
+
 QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::remove(
     const QOrmQuery& query,
     QOrmEntityInstanceCache& entityInstanceCache)
@@ -948,7 +2079,9 @@ QOrmQueryResult<QObject> QOrmSqliteProviderPrivate::remove(
 
     auto [statement, boundParameters] = m_statementGenerator.generate(query);
 
-    QSqlQuery sqlQuery = prepareAndExecute(statement, boundParameters);
+    QSqlQuery sqlQuery =
+        prepareAndExecute(statement, boundParameters, StatementCaching::Enabled);
+    auto finishQuery = qScopeGuard([&sqlQuery] { sqlQuery.finish(); });
 
     if (sqlQuery.lastError().type() != QSqlError::NoError)
     {
@@ -1056,6 +2189,17 @@ void QOrmSqliteProviderPrivate::detectSqliteCapabilities()
                                            parts.size() > 1 ? parts[1].toInt() : 0,
                                            parts.size() > 2 ? parts[2].toInt() : 0);
 
+            if (version >= std::make_tuple(3, 24, 0))
+            {
+                m_capabilities.setFlag(QOrmSqliteProvider::SupportsUpsertClause);
+
+                m_statementGenerator.setOptions(m_statementGenerator.options() |
+                                                QOrmSqliteStatementGenerator::WithUpsertClause);
+            }
+
+            if (version >= std::make_tuple(3, 32, 0))
+                m_maxVariableNumber = 32766;
+
             if (version >= std::make_tuple(3, 35, 0))
             {
                 m_capabilities.setFlag(QOrmSqliteProvider::SupportsReturningClause);
@@ -1071,6 +2215,16 @@ void QOrmSqliteProviderPrivate::detectSqliteCapabilities()
         }
     }
 
+    // JSON functions are built in since SQLite 3.38.0 but may be available in earlier versions
+    // when compiled with the JSON1 extension.
+    if (query.exec("SELECT json_valid('[]')"))
+    {
+        m_capabilities.setFlag(QOrmSqliteProvider::SupportsJsonFunctions);
+
+        m_statementGenerator.setOptions(m_statementGenerator.options() |
+                                        QOrmSqliteStatementGenerator::WithJsonListParameters);
+    }
+
     inMemoryDatabase.close();
 }
 
@@ -1109,6 +2263,7 @@ QOrmError QOrmSqliteProvider::disconnectFromBackend()
 {
     Q_D(QOrmSqliteProvider);
 
+    d->clearStatementCache();
     d->m_database.close();
 
     return QOrmError{QOrm::ErrorType::None, {}};
@@ -1184,6 +2339,144 @@ QOrmError QOrmSqliteProvider::rollbackTransaction()
     return QOrmError{QOrm::ErrorType::None, {}};
 }
 
+// Reads the rows of a query in chunks as the consumer advances. Each chunk is hydrated like a
+// complete result, so that the references of its rows are still read in batches.
+class QOrmSqliteCursor : public QOrmAbstractCursor
+{
+public:
+    QOrmSqliteCursor(QOrmSqliteProviderPrivate* provider,
+                     const QOrmQuery& query,
+                     QOrmEntityInstanceCache& entityInstanceCache);
+    ~QOrmSqliteCursor() override;
+
+    QObject* next() override;
+    QOrmError error() const override { return m_error; }
+
+private:
+    void readChunk();
+    void evictOwnInstances();
+
+    static constexpr int ChunkSize = 256;
+
+    QOrmSqliteProviderPrivate* m_provider{nullptr};
+    QOrmQuery m_query;
+    QOrmEntityInstanceCache& m_entityInstanceCache;
+    QSqlQuery m_sqlQuery;
+    std::shared_ptr<const ResultColumns> m_columns;
+    QOrmError m_error{QOrm::ErrorType::None, {}};
+    QVector<QObject*> m_chunk;
+    int m_position{0};
+    // entity instances created by this cursor for the current chunk, including those read for
+    // references; only these are evicted, once the cursor moves past the chunk
+    QVector<QObject*> m_ownInstances;
+};
+
+QOrmSqliteCursor::QOrmSqliteCursor(QOrmSqliteProviderPrivate* provider,
+                                   const QOrmQuery& query,
+                                   QOrmEntityInstanceCache& entityInstanceCache)
+    : m_provider{provider}
+    , m_query{query}
+    , m_entityInstanceCache{entityInstanceCache}
+{
+    Q_ASSERT(query.operation() == QOrm::Operation::Read);
+    Q_ASSERT(query.projection().has_value());
+
+    m_error = m_provider->ensureSchemaSynchronized(query.relation());
+
+    if (m_error != QOrm::ErrorType::None)
+        return;
+
+    auto [statement, boundParameters] = m_provider->m_statementGenerator.generate(query);
+
+    // the statement stays active until the cursor is exhausted: it cannot be shared
+    m_sqlQuery = m_provider->prepareAndExecute(
+        statement, boundParameters, QOrmSqliteProviderPrivate::StatementCaching::Disabled);
+
+    if (m_sqlQuery.lastError().type() != QSqlError::NoError)
+    {
+        m_error = QOrmError{QOrm::ErrorType::Provider, m_sqlQuery.lastError().text()};
+        return;
+    }
+
+    m_columns = std::make_shared<const ResultColumns>(*query.projection(), m_sqlQuery.record());
+}
+
+QOrmSqliteCursor::~QOrmSqliteCursor()
+{
+    m_sqlQuery.finish();
+    evictOwnInstances();
+}
+
+QObject* QOrmSqliteCursor::next()
+{
+    while (m_position >= m_chunk.size())
+    {
+        if (m_error != QOrm::ErrorType::None || !m_sqlQuery.isActive())
+            return nullptr;
+
+        readChunk();
+    }
+
+    return m_chunk[m_position++];
+}
+
+void QOrmSqliteCursor::readChunk()
+{
+    // the instances read for the references of the previous chunk are no longer needed
+    evictOwnInstances();
+
+    m_chunk.clear();
+    m_position = 0;
+
+    QVector<ResultRow> records;
+    records.reserve(ChunkSize);
+
+    while (records.size() < ChunkSize && m_sqlQuery.next())
+        records.push_back(ResultRow{m_columns, m_sqlQuery});
+
+    if (records.size() < ChunkSize)
+    {
+        if (m_sqlQuery.lastError().type() != QSqlError::NoError)
+            m_error = QOrmError{QOrm::ErrorType::Provider, m_sqlQuery.lastError().text()};
+
+        m_sqlQuery.finish();
+    }
+
+    if (records.isEmpty() || m_error != QOrm::ErrorType::None)
+        return;
+
+    bool evictStreamed = m_query.flags().testFlag(QOrm::QueryFlags::EvictStreamedInstances);
+
+    // instances without object ID are not cached, so they cannot be told apart from the instances
+    // cached before
+    Q_ASSERT(!evictStreamed || m_query.projection()->objectIdMapping() != nullptr);
+
+    if (evictStreamed)
+        m_entityInstanceCache.beginRecordingInsertions();
+
+    QOrmQueryResult<QObject> result =
+        m_provider->readRecords(m_query, records, m_entityInstanceCache);
+
+    if (evictStreamed)
+        m_ownInstances = m_entityInstanceCache.endRecordingInsertions();
+
+    if (result.hasError())
+    {
+        m_error = result.error();
+        m_sqlQuery.finish();
+        return;
+    }
+
+    m_chunk = result.toVector();
+}
+
+// Instances which the caller still uses, i.e. modified, pinned or pending ones, stay cached. Other
+// cached instances may still reference the evicted ones: these references become unfetched.
+void QOrmSqliteCursor::evictOwnInstances()
+{
+    m_entityInstanceCache.evictUnused(std::exchange(m_ownInstances, {}));
+}
+
 QOrmQueryResult<QObject> QOrmSqliteProvider::execute(const QOrmQuery& query,
                                                      QOrmEntityInstanceCache& entityInstanceCache)
 {
@@ -1203,11 +2496,14 @@ QOrmQueryResult<QObject> QOrmSqliteProvider::execute(const QOrmQuery& query,
 
         case QOrm::Operation::Create:
         case QOrm::Operation::Update:
-            return d->merge(query);
+            return d->merge(query, entityInstanceCache);
 
         case QOrm::Operation::Delete:
             return d->remove(query, entityInstanceCache);
 
+        case QOrm::Operation::Upsert:
+            return d->upsertAll(query);
+
         case QOrm::Operation::Merge:
             Q_ORM_UNEXPECTED_STATE;
     }
@@ -1215,6 +2511,18 @@ QOrmQueryResult<QObject> QOrmSqliteProvider::execute(const QOrmQuery& query,
     Q_ORM_UNEXPECTED_STATE;
 }
 
+std::unique_ptr<QOrmAbstractCursor> QOrmSqliteProvider::openCursor(
+    const QOrmQuery& query,
+    QOrmEntityInstanceCache& entityInstanceCache)
+{
+    Q_D(QOrmSqliteProvider);
+
+    if (query.operation() != QOrm::Operation::Read)
+        return QOrmAbstractProvider::openCursor(query, entityInstanceCache);
+
+    return std::make_unique<QOrmSqliteCursor>(d, query, entityInstanceCache);
+}
+
 int QOrmSqliteProvider::capabilities() const
 {
     Q_D(const QOrmSqliteProvider);
@@ -1235,4 +2543,18 @@ QSqlDatabase QOrmSqliteProvider::database() const
     return d->m_database;
 }
 
+qint64 QOrmSqliteProvider::statementCacheHits() const
+{
+    Q_D(const QOrmSqliteProvider);
+
+    return d->m_statementCacheHits;
+}
+
+qint64 QOrmSqliteProvider::statementCacheMisses() const
+{
+    Q_D(const QOrmSqliteProvider);
+
+    return d->m_statementCacheMisses;
+}
+
 QT_END_NAMESPACE
@@ -39,7 +39,9 @@ public:
     enum SqliteCapability
     {
         NoCapabilities = 0,
-        SupportsReturningClause = 1
+        SupportsReturningClause = 1,
+        SupportsJsonFunctions = 2,
+        SupportsUpsertClause = 4
     };
     Q_DECLARE_FLAGS(SqliteCapabilities, SqliteCapability)
 
@@ -56,12 +58,20 @@ public:
 
     QOrmQueryResult<QObject> execute(const QOrmQuery& query,
                                      QOrmEntityInstanceCache& entityInstanceCache) override;
+    [[nodiscard]] std::unique_ptr<QOrmAbstractCursor> openCursor(
+        const QOrmQuery& query,
+        QOrmEntityInstanceCache& entityInstanceCache) override;
 
     [[nodiscard]] int capabilities() const override;
 
     QOrmSqliteConfiguration configuration() const;
     QSqlDatabase database() const;
 
+    // Lookups of cacheable statements. Schema statements and statements with a varying shape are
+    // never cached and not counted.
+    [[nodiscard]] qint64 statementCacheHits() const;
+    [[nodiscard]] qint64 statementCacheMisses() const;
+
 private:
     Q_DECLARE_PRIVATE(QOrmSqliteProvider)
     QOrmSqliteProviderPrivate* d_ptr{nullptr};
@@ -19,6 +19,7 @@
  */
 
 #include "qormsqlitestatementgenerator_p.h"
+#include "qormaggregate.h"
 #include "qormfilter.h"
 #include "qormfilterexpression.h"
 #include "qormglobal_p.h"
@@ -28,23 +29,14 @@
 #include "qormquery.h"
 #include "qormrelation.h"
 
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
 #include <QtCore/qstringbuilder.h>
 
-QT_BEGIN_NAMESPACE
-
-[[nodiscard]] static QString insertParameter(QVariantMap& boundParameters,
-                                             QString name,
-                                             QVariant value)
-{
-    QString key = ':' % name;
-
-    for (int i = 0; boundParameters.contains(key); ++i)
-        key = ':' % name % QString::number(i);
-
-    boundParameters.insert(key, value);
+#include <algorithm>
+#include <tuple>
 
-    return key;
-}
+QT_BEGIN_NAMESPACE
 
 [[nodiscard]] static QVariant propertyValueForQuery(const QObject* entityInstance,
                                                     const QOrmPropertyMapping& propertyMapping)
@@ -57,7 +49,7 @@ QT_BEGIN_NAMESPACE
         Q_ASSERT(referencedEntity->objectIdMapping() != nullptr);
 
         const QObject* referencedInstance =
-            QOrmPrivate::propertyValue(entityInstance, propertyMapping.classPropertyName())
+            QOrmPrivate::propertyValue(entityInstance, propertyMapping)
                 .value<QObject*>();
 
         return referencedInstance == nullptr
@@ -66,7 +58,7 @@ QT_BEGIN_NAMESPACE
     }
     else
     {
-        return QOrmPrivate::propertyValue(entityInstance, propertyMapping.classPropertyName());
+        return QOrmPrivate::propertyValue(entityInstance, propertyMapping);
     }
 }
 
@@ -79,6 +71,38 @@ QOrmSqliteStatementGenerator::QOrmSqliteStatementGenerator(Options options)
 {
 }
 
+void QOrmSqliteStatementGenerator::setOptions(Options options)
+{
+    m_options = options;
+
+    m_insertStatements.clear();
+    m_updateStatements.clear();
+    m_deleteStatements.clear();
+}
+
+QString QOrmSqliteStatementGenerator::insertParameter(QVariantMap& boundParameters,
+                                                      const QString& name,
+                                                      const QVariant& value)
+{
+    if (m_options.testFlag(PositionalParameters))
+    {
+        // SQLite allows at most 32766 parameters per statement: five digits keep the keys in
+        // positional order.
+        boundParameters.insert(QString::number(boundParameters.size()).rightJustified(5, '0'),
+                               value);
+        return QStringLiteral("?");
+    }
+
+    QString key = ':' % name;
+
+    for (int i = 0; boundParameters.contains(key); ++i)
+        key = ':' % name % QString::number(i);
+
+    boundParameters.insert(key, value);
+
+    return key;
+}
+
 std::pair<QString, QVariantMap> QOrmSqliteStatementGenerator::generate(const QOrmQuery& query)
 {
     QVariantMap boundParameters;
@@ -92,11 +116,42 @@ QString QOrmSqliteStatementGenerator::generate(const QOrmQuery& query, QVariantM
     switch (query.operation())
     {
         case QOrm::Operation::Create:
+            if (!query.entityInstances().isEmpty())
+            {
+                return generateInsertStatement(*query.relation().mapping(),
+                                               query.entityInstances(),
+                                               boundParameters);
+            }
+
             return generateInsertStatement(*query.relation().mapping(),
                                            query.entityInstance(),
                                            boundParameters);
 
+        case QOrm::Operation::Upsert:
+            Q_ASSERT(query.relation().type() == QOrm::RelationType::Mapping);
+
+            if (!query.entityInstances().isEmpty())
+            {
+                return generateUpsertStatement(*query.relation().mapping(),
+                                               query.entityInstances(),
+                                               boundParameters);
+            }
+
+            return generateUpsertStatement(*query.relation().mapping(),
+                                           {const_cast<QObject*>(query.entityInstance())},
+                                           boundParameters);
+
         case QOrm::Operation::Update:
+            Q_ASSERT(query.relation().type() == QOrm::RelationType::Mapping);
+
+            if (query.entityInstance() == nullptr)
+            {
+                return generateUpdateStatement(*query.relation().mapping(),
+                                               query.assignments(),
+                                               query.expressionFilter(),
+                                               boundParameters);
+            }
+
             return generateUpdateStatement(*query.relation().mapping(),
                                            query.entityInstance(),
                                            boundParameters);
@@ -134,6 +189,9 @@ QString QOrmSqliteStatementGenerator::generateInsertStatement(const QOrmMetadata
     QStringList fieldsList;
     QStringList valuesList;
 
+    auto cachedStatement = m_insertStatements.constFind(relation.className());
+    bool isCached = cachedStatement != m_insertStatements.constEnd();
+
     for (const QOrmPropertyMapping& propertyMapping : relation.propertyMappings())
     {
         if (propertyMapping.isAutogenerated() || propertyMapping.isTransient())
@@ -144,16 +202,138 @@ QString QOrmSqliteStatementGenerator::generateInsertStatement(const QOrmMetadata
         QString valueStr =
             insertParameter(boundParameters, propertyMapping.tableFieldName(), propertyValue);
 
-        fieldsList.push_back(escapeIdentifier(propertyMapping.tableFieldName()));
-        valuesList.push_back(valueStr);
+        if (!isCached)
+        {
+            fieldsList.push_back(escapeIdentifier(propertyMapping.tableFieldName()));
+            valuesList.push_back(valueStr);
+        }
     }
 
+    if (isCached)
+        return cachedStatement.value();
+
     QString fieldsStr = fieldsList.join(',');
     QString valuesStr = valuesList.join(',');
 
     QString statement = QStringLiteral("INSERT INTO %1(%2) VALUES(%3)")
                             .arg(escapeIdentifier(relation.tableName()), fieldsStr, valuesStr);
 
+    if (m_options.testFlag(PositionalParameters))
+        m_insertStatements.insert(relation.className(), statement);
+
+    return statement;
+}
+
+// Generates a multi-row INSERT statement. If the entity has an autogenerated object ID and the
+// RETURNING clause is enabled, the generated IDs are returned.
+QString QOrmSqliteStatementGenerator::generateInsertStatement(const QOrmMetadata& relation,
+                                                              const QVector<QObject*>& instances,
+                                                              QVariantMap& boundParameters)
+{
+    Q_ASSERT(!instances.isEmpty());
+
+    QStringList fieldsList;
+
+    for (const QOrmPropertyMapping& propertyMapping : relation.propertyMappings())
+    {
+        if (propertyMapping.isAutogenerated() || propertyMapping.isTransient())
+            continue;
+
+        fieldsList.push_back(escapeIdentifier(propertyMapping.tableFieldName()));
+    }
+
+    QStringList rowsList;
+
+    for (const QObject* entityInstance : instances)
+    {
+        QStringList valuesList;
+
+        for (const QOrmPropertyMapping& propertyMapping : relation.propertyMappings())
+        {
+            if (propertyMapping.isAutogenerated() || propertyMapping.isTransient())
+                continue;
+
+            QVariant propertyValue = propertyValueForQuery(entityInstance, propertyMapping);
+
+            valuesList.push_back(
+                insertParameter(boundParameters, propertyMapping.tableFieldName(), propertyValue));
+        }
+
+        rowsList.push_back(QStringLiteral("(%1)").arg(valuesList.join(',')));
+    }
+
+    QString statement = QStringLiteral("INSERT INTO %1(%2) VALUES%3")
+                            .arg(escapeIdentifier(relation.tableName()),
+                                 fieldsList.join(','),
+                                 rowsList.join(','));
+
+    if (m_options.testFlag(WithReturningClause) && relation.objectIdMapping() != nullptr &&
+        relation.objectIdMapping()->isAutogenerated())
+    {
+        statement += ' ' % generateReturningIdClause(relation);
+    }
+
+    return statement;
+}
+
+QString QOrmSqliteStatementGenerator::generateUpsertStatement(const QOrmMetadata& relation,
+                                                              const QVector<QObject*>& instances,
+                                                              QVariantMap& boundParameters)
+{
+    Q_ASSERT(!instances.isEmpty());
+    Q_ASSERT(relation.objectIdMapping() != nullptr);
+
+    QStringList fieldsList;
+    QStringList assignmentsList;
+
+    for (const QOrmPropertyMapping& propertyMapping : relation.propertyMappings())
+    {
+        if (propertyMapping.isTransient())
+            continue;
+
+        QString field = escapeIdentifier(propertyMapping.tableFieldName());
+        fieldsList.push_back(field);
+
+        if (!propertyMapping.isObjectId())
+            assignmentsList.push_back(QStringLiteral("%1 = excluded.%1").arg(field));
+    }
+
+    QStringList rowsList;
+
+    for (const QObject* entityInstance : instances)
+    {
+        QStringList valuesList;
+
+        for (const QOrmPropertyMapping& propertyMapping : relation.propertyMappings())
+        {
+            if (propertyMapping.isTransient())
+                continue;
+
+            QVariant propertyValue = propertyValueForQuery(entityInstance, propertyMapping);
+
+            valuesList.push_back(
+                insertParameter(boundParameters, propertyMapping.tableFieldName(), propertyValue));
+        }
+
+        rowsList.push_back(QStringLiteral("(%1)").arg(valuesList.join(',')));
+    }
+
+    QString statement = QStringLiteral("INSERT INTO %1(%2) VALUES%3")
+                            .arg(escapeIdentifier(relation.tableName()),
+                                 fieldsList.join(','),
+                                 rowsList.join(','));
+
+    if (m_options.testFlag(WithUpsertClause))
+    {
+        statement += QStringLiteral(" ON CONFLICT(%1) DO ")
+                         .arg(escapeIdentifier(relation.objectIdMapping()->tableFieldName()));
+
+        // an entity consisting only of its object ID has nothing to update
+        statement += assignmentsList.isEmpty()
+                         ? QStringLiteral("NOTHING")
+                         : QStringLiteral("UPDATE SET %1").arg(assignmentsList.join(','));
+    }
+
     return statement;
 }
 
@@ -177,35 +357,118 @@ QString QOrmSqliteStatementGenerator::generateInsertIntoStatement(
         .arg(destinationTableName, columnList.join(','), sourceTableName);
 }
 
-QString QOrmSqliteStatementGenerator::generateUpdateStatement(const QOrmMetadata& relation,
-                                                              const QObject* entityInstance,
-                                                              QVariantMap& boundParameters)
+QString QOrmSqliteStatementGenerator::generateUpdateStatement(
+    const QOrmMetadata& relation,
+    const QObject* entityInstance,
+    QVariantMap& boundParameters,
+    const QSet<QString>& skippedProperties)
 {
     if (relation.objectIdMapping() == nullptr)
         qFatal("QtOrm: Unable to update entity without object ID property");
 
     QStringList setList;
 
+    QString statementKey = relation.className();
+
+    if (!skippedProperties.isEmpty())
+    {
+        QStringList skipped = skippedProperties.values();
+        std::sort(std::begin(skipped), std::end(skipped));
+        statementKey += QLatin1Char(':') + skipped.join(QLatin1Char(','));
+    }
+
+    auto cachedStatement = m_updateStatements.constFind(statementKey);
+    bool isCached = cachedStatement != m_updateStatements.constEnd();
+
     for (const QOrmPropertyMapping& propertyMapping : relation.propertyMappings())
     {
-        if (propertyMapping.isTransient() || propertyMapping.isObjectId())
+        if (propertyMapping.isTransient() || propertyMapping.isObjectId() ||
+            skippedProperties.contains(propertyMapping.classPropertyName()))
+        {
             continue;
+        }
 
         QVariant propertyValue = propertyValueForQuery(entityInstance, propertyMapping);
 
         QString parameterName =
             insertParameter(boundParameters, propertyMapping.tableFieldName(), propertyValue);
-        setList.push_back(QString{"%1 = %2"}.arg(propertyMapping.tableFieldName(), parameterName));
+
+        if (!isCached)
+        {
+            setList.push_back(
+                QString{"%1 = %2"}.arg(propertyMapping.tableFieldName(), parameterName));
+        }
     }
 
     QVariant objectId = QOrmPrivate::objectIdPropertyValue(entityInstance, relation);
 
+    if (isCached && !objectId.isNull())
+    {
+        std::ignore =
+            insertParameter(boundParameters, relation.objectIdMapping()->tableFieldName(), objectId);
+        return cachedStatement.value();
+    }
+
     QString whereClause =
         generateWhereClause(QOrmFilter{*relation.objectIdMapping() == objectId}, boundParameters);
 
     QStringList parts = {"UPDATE", relation.tableName(), "SET", setList.join(','), whereClause};
+    QString statement = parts.join(QChar(' '));
+
+    if (m_options.testFlag(PositionalParameters) && !objectId.isNull())
+        m_updateStatements.insert(statementKey, statement);
+
+    return statement;
+}
+
+QString QOrmSqliteStatementGenerator::generateUpdateStatement(
+    const QOrmMetadata& relation,
+    const std::vector<std::pair<QOrmPropertyMapping, QVariant>>& assignments,
+    const std::optional<QOrmFilter>& filter,
+    QVariantMap& boundParameters)
+{
+    Q_ASSERT(!assignments.empty());
 
-    return parts.join(QChar(' '));
+    QStringList setList;
+
+    for (const auto& [propertyMapping, value] : assignments)
+    {
+        QVariant columnValue = value;
+
+        // references are assigned entity instances or object IDs
+        if (propertyMapping.isReference())
+        {
+            const QOrmMetadata* referencedEntity = propertyMapping.referencedEntity();
+            Q_ASSERT(referencedEntity != nullptr);
+
+            if (const QObject* referencedInstance = value.value<QObject*>())
+            {
+                columnValue =
+                    QOrmPrivate::objectIdPropertyValue(referencedInstance, *referencedEntity);
+            }
+            else if (value.isNull() || value.canConvert<QObject*>())
+            {
+                columnValue = QVariant::fromValue(nullptr);
+            }
+        }
+
+        QString parameterName =
+            insertParameter(boundParameters, propertyMapping.tableFieldName(), columnValue);
+        setList.push_back(
+            QString{"%1 = %2"}.arg(escapeIdentifier(propertyMapping.tableFieldName()),
+                                   parameterName));
+    }
+
+    QStringList parts = {
+        "UPDATE", escapeIdentifier(relation.tableName()), "SET", setList.join(',')};
+
+    if (filter.has_value())
+        parts.push_back(generateWhereClause(*filter, boundParameters));
+
+    if (m_options.testFlag(WithReturningClause) && relation.objectIdMapping() != nullptr)
+        parts.push_back(generateReturningIdClause(relation));
+
+    return parts.join(QChar{' '});
 }
 
 QString QOrmSqliteStatementGenerator::generateSelectStatement(const QOrmQuery& query,
@@ -213,7 +476,26 @@ QString QOrmSqliteStatementGenerator::generateSelectStatement(const QOrmQuery& q
 {
     Q_ASSERT(query.operation() == QOrm::Operation::Read);
 
-    QStringList parts = {"SELECT *", generateFromClause(query.relation(), boundParameters)};
+    if (!query.aggregates().empty())
+        return generateAggregateSelectStatement(query, boundParameters);
+
+    QString columnsStr = QStringLiteral("*");
+
+    if (!query.columns().empty())
+    {
+        QStringList columns;
+
+        for (const QOrmPropertyMapping& mapping : query.columns())
+        {
+            if (!mapping.isTransient())
+                columns.push_back(escapeIdentifier(mapping.tableFieldName()));
+        }
+
+        columnsStr = columns.join(',');
+    }
+
+    QStringList parts = {"SELECT " + columnsStr,
+                         generateFromClause(query.relation(), boundParameters)};
 
     if (query.expressionFilter().has_value())
         parts += generateWhereClause(*query.expressionFilter(), boundParameters);
@@ -225,6 +507,63 @@ QString QOrmSqliteStatementGenerator::generateSelectStatement(const QOrmQuery& q
     return parts.join(QChar{' '});
 }
 
+QString QOrmSqliteStatementGenerator::generateAggregateSelectStatement(
+    const QOrmQuery& query,
+    QVariantMap& boundParameters)
+{
+    Q_ASSERT(query.operation() == QOrm::Operation::Read);
+    Q_ASSERT(!query.aggregates().empty());
+    Q_ASSERT(query.having().empty() || !query.groupBy().empty());
+
+    QStringList groupColumns;
+
+    for (const QOrmPropertyMapping& mapping : query.groupBy())
+        groupColumns.push_back(escapeIdentifier(mapping.tableFieldName()));
+
+    QStringList columns = groupColumns;
+
+    for (const QOrmAggregate& aggregate : query.aggregates())
+        columns.push_back(generateAggregateExpression(aggregate));
+
+    QStringList parts = {"SELECT " + columns.join(',')};
+
+    // without groups, a page of rows is aggregated; with groups, the groups are paged
+    if (groupColumns.isEmpty() && (query.limit().has_value() || query.offset().has_value()))
+    {
+        QStringList subqueryParts = {"SELECT *",
+                                     generateFromClause(query.relation(), boundParameters)};
+
+        if (query.expressionFilter().has_value())
+            subqueryParts += generateWhereClause(*query.expressionFilter(), boundParameters);
+
+        subqueryParts += generateOrderClause(query.order());
+        subqueryParts +=
+            generateLimitOffsetClause(query.limit(), query.offset(), boundParameters);
+
+        parts += QStringLiteral("FROM (%1)").arg(subqueryParts.join(QChar{' '}));
+    }
+    else
+    {
+        parts += generateFromClause(query.relation(), boundParameters);
+
+        if (query.expressionFilter().has_value())
+            parts += generateWhereClause(*query.expressionFilter(), boundParameters);
+
+        if (!groupColumns.isEmpty())
+        {
+            parts += "GROUP BY " + groupColumns.join(',');
+
+            if (!query.having().empty())
+                parts += generateHavingClause(query.having(), boundParameters);
+
+            parts += generateOrderClause(query.order());
+            parts += generateLimitOffsetClause(query.limit(), query.offset(), boundParameters);
+        }
+    }
+
+    return parts.join(QChar{' '});
+}
+
 QString QOrmSqliteStatementGenerator::generateDeleteStatement(const QOrmMetadata& relation,
                                                               const QOrmFilter& filter,
                                                               QVariantMap& boundParameters)
@@ -249,9 +588,30 @@ QString QOrmSqliteStatementGenerator::generateDeleteStatement(const QOrmMetadata
 
     QVariant objectId = QOrmPrivate::objectIdPropertyValue(instance, relation);
 
-    return generateDeleteStatement(relation,
-                                   QOrmFilter{*relation.objectIdMapping() == objectId},
-                                   boundParameters);
+    if (objectId.isNull())
+    {
+        return generateDeleteStatement(relation,
+                                       QOrmFilter{*relation.objectIdMapping() == objectId},
+                                       boundParameters);
+    }
+
+    auto cachedStatement = m_deleteStatements.constFind(relation.className());
+
+    if (cachedStatement != m_deleteStatements.constEnd())
+    {
+        std::ignore =
+            insertParameter(boundParameters, relation.objectIdMapping()->tableFieldName(), objectId);
+        return cachedStatement.value();
+    }
+
+    QString statement = generateDeleteStatement(relation,
+                                                QOrmFilter{*relation.objectIdMapping() == objectId},
+                                                boundParameters);
+
+    if (m_options.testFlag(PositionalParameters))
+        m_deleteStatements.insert(relation.className(), statement);
+
+    return statement;
 }
 
 QString QOrmSqliteStatementGenerator::generateFromClause(const QOrmRelation& relation,
@@ -313,6 +673,69 @@ QString QOrmSqliteStatementGenerator::generateReturningIdClause(const QOrmMetada
         .arg(escapeIdentifier(relation.objectIdMapping()->classPropertyName()));
 }
 
+QString QOrmSqliteStatementGenerator::generateAggregateExpression(const QOrmAggregate& aggregate)
+{
+    Q_ASSERT(aggregate.isResolved());
+
+    QString argument = aggregate.mapping() != nullptr
+                           ? escapeIdentifier(aggregate.mapping()->tableFieldName())
+                           : QStringLiteral("*");
+
+    switch (aggregate.function())
+    {
+        case QOrm::AggregateFunction::Count:
+            return QStringLiteral("COUNT(%1)").arg(argument);
+
+        case QOrm::AggregateFunction::Sum:
+            return QStringLiteral("SUM(%1)").arg(argument);
+
+        case QOrm::AggregateFunction::Min:
+            return QStringLiteral("MIN(%1)").arg(argument);
+
+        case QOrm::AggregateFunction::Max:
+            return QStringLiteral("MAX(%1)").arg(argument);
+
+        case QOrm::AggregateFunction::Avg:
+            return QStringLiteral("AVG(%1)").arg(argument);
+    }
+
+    Q_ORM_UNEXPECTED_STATE;
+}
+
+QString QOrmSqliteStatementGenerator::generateHavingClause(
+    const std::vector<std::tuple<QOrmAggregate, QOrm::Comparison, QVariant>>& having,
+    QVariantMap& boundParameters)
+{
+    static const QHash<QOrm::Comparison, QString> comparisonOps = {
+        {QOrm::Comparison::Less, "<"},
+        {QOrm::Comparison::Equal, "="},
+        {QOrm::Comparison::Greater, ">"},
+        {QOrm::Comparison::NotEqual, "<>"},
+        {QOrm::Comparison::LessOrEqual, "<="},
+        {QOrm::Comparison::GreaterOrEqual, ">="}};
+
+    QStringList conditions;
+
+    for (const auto& [aggregate, comparison, value] : having)
+    {
+        if (!comparisonOps.contains(comparison) || value.isNull())
+        {
+            qCCritical(qtorm) << aggregate << "is compared to" << value << "using operator"
+                              << comparison
+                              << ". Only non-null values can be compared to aggregates.";
+            qFatal("qtorm: Unexpected query.");
+        }
+
+        conditions.push_back(QString{"%1 %2 %3"}.arg(generateAggregateExpression(aggregate),
+                                                      comparisonOps[comparison],
+                                                      insertParameter(boundParameters,
+                                                                      QStringLiteral("having"),
+                                                                      value)));
+    }
+
+    return QStringLiteral("HAVING ") % conditions.join(QStringLiteral(" AND "));
+}
+
 QString QOrmSqliteStatementGenerator::generateCondition(const QOrmFilterExpression& expression,
                                                         QVariantMap& boundParameters)
 {
@@ -383,6 +806,9 @@ QString QOrmSqliteStatementGenerator::generateCondition(
         value = predicate.value();
     }
 
+    QString column = generateFilterColumn(predicate, boundParameters);
+    QString parameterName = predicate.propertyMapping()->tableFieldName();
+
     if (value.isNull())
     {
         static const QHash<QOrm::Comparison, QString> comparisonOps = {
@@ -396,9 +822,7 @@ QString QOrmSqliteStatementGenerator::generateCondition(
             qFatal("qtorm: Unexpected query.");
         }
 
-        statement =
-            QString{"%1 %2"}.arg(escapeIdentifier(predicate.propertyMapping()->tableFieldName()),
-                                 comparisonOps[predicate.comparison()]);
+        statement = QString{"%1 %2"}.arg(column, comparisonOps[predicate.comparison()]);
     }
     else
     {
@@ -412,12 +836,31 @@ QString QOrmSqliteStatementGenerator::generateCondition(
             {QOrm::Comparison::InList, "IN"},
             {QOrm::Comparison::NotInList, "NOT IN"},
             {QOrm::Comparison::Contains, "LIKE"},
-            {QOrm::Comparison::NotContains, "NOT LIKE"}};
+            {QOrm::Comparison::NotContains, "NOT LIKE"},
+            {QOrm::Comparison::Between, "BETWEEN"},
+            {QOrm::Comparison::NotBetween, "NOT BETWEEN"},
+            {QOrm::Comparison::StartsWith, "GLOB"},
+            {QOrm::Comparison::EqualIgnoringCase, "="}};
 
         Q_ASSERT(comparisonOps.contains(predicate.comparison()));
 
-        if (predicate.comparison() == QOrm::Comparison::InList ||
-            predicate.comparison() == QOrm::Comparison::NotInList)
+        if ((predicate.comparison() == QOrm::Comparison::InList ||
+             predicate.comparison() == QOrm::Comparison::NotInList) &&
+            m_options.testFlag(WithJsonListParameters))
+        {
+            QByteArray json = QJsonDocument{QJsonArray::fromVariantList(value.toList())}.toJson(
+                QJsonDocument::Compact);
+
+            QString parameterKey =
+                insertParameter(boundParameters, parameterName, QString::fromUtf8(json));
+
+            statement = QString{"%1 %2 (SELECT value FROM json_each(%3))"}.arg(
+                column,
+                comparisonOps[predicate.comparison()],
+                parameterKey);
+        }
+        else if (predicate.comparison() == QOrm::Comparison::InList ||
+                 predicate.comparison() == QOrm::Comparison::NotInList)
         {
             QStringList parameterKeys;
 
@@ -425,47 +868,132 @@ QString QOrmSqliteStatementGenerator::generateCondition(
 
             for (int i = 0; i < list.size(); ++i)
             {
-                QString parameterKey =
-                    QString{"%1_%2"}.arg(predicate.propertyMapping()->tableFieldName()).arg(i);
+                QString parameterKey = QString{"%1_%2"}.arg(parameterName).arg(i);
                 parameterKey = insertParameter(boundParameters, parameterKey, list.at(i));
                 parameterKeys.push_back(parameterKey);
             }
 
-            statement =
-                QString{"%1 %2 (%3)"}.arg(escapeIdentifier(
-                                              predicate.propertyMapping()->tableFieldName()),
-                                          comparisonOps[predicate.comparison()],
-                                          parameterKeys.join(", "));
+            statement = QString{"%1 %2 (%3)"}.arg(column,
+                                                  comparisonOps[predicate.comparison()],
+                                                  parameterKeys.join(", "));
         }
         else if (predicate.comparison() == QOrm::Comparison::Contains ||
                  predicate.comparison() == QOrm::Comparison::NotContains)
         {
             QString pattern = '%' % value.toString() % '%';
 
-            QString parameterKey = insertParameter(boundParameters,
-                                                   predicate.propertyMapping()->tableFieldName(),
-                                                   pattern);
-            statement = QString{"%1 %2 %3"}.arg(escapeIdentifier(
-                                                    predicate.propertyMapping()->tableFieldName()),
+            QString parameterKey = insertParameter(boundParameters, parameterName, pattern);
+            statement = QString{"%1 %2 %3"}.arg(column,
+                                                comparisonOps[predicate.comparison()],
+                                                parameterKey);
+        }
+        else if (predicate.comparison() == QOrm::Comparison::Between ||
+                 predicate.comparison() == QOrm::Comparison::NotBetween)
+        {
+            QVariantList bounds = value.toList();
+
+            if (bounds.size() != 2)
+            {
+                qCCritical(qtorm) << predicate.propertyMapping()->tableFieldName()
+                                  << "is compared using operator" << predicate.comparison()
+                                  << "to" << value
+                                  << ". A lower and an upper bound are expected.";
+                qFatal("qtorm: Unexpected query.");
+            }
+
+            QString lowerKey = insertParameter(boundParameters, parameterName, bounds.at(0));
+            QString upperKey = insertParameter(boundParameters, parameterName, bounds.at(1));
+
+            statement = QString{"%1 %2 %3 AND %4"}.arg(column,
+                                                       comparisonOps[predicate.comparison()],
+                                                       lowerKey,
+                                                       upperKey);
+        }
+        else if (predicate.comparison() == QOrm::Comparison::StartsWith)
+        {
+            // GLOB is case-sensitive and can use an index of the column, unlike LIKE. The
+            // wildcards of the prefix are matched literally.
+            QString pattern;
+
+            for (QChar c : value.toString())
+            {
+                if (c == '*' || c == '?' || c == '[')
+                    pattern.append('[').append(c).append(']');
+                else
+                    pattern.append(c);
+            }
+
+            pattern.append('*');
+
+            QString parameterKey = insertParameter(boundParameters, parameterName, pattern);
+            statement = QString{"%1 %2 %3"}.arg(column,
                                                 comparisonOps[predicate.comparison()],
                                                 parameterKey);
         }
         else
         {
-            QString parameterKey = insertParameter(boundParameters,
-                                                   predicate.propertyMapping()->tableFieldName(),
-                                                   value);
+            QString parameterKey = insertParameter(boundParameters, parameterName, value);
 
-            statement = QString{"%1 %2 %3"}.arg(escapeIdentifier(
-                                                    predicate.propertyMapping()->tableFieldName()),
+            statement = QString{"%1 %2 %3"}.arg(column,
                                                 comparisonOps[predicate.comparison()],
                                                 parameterKey);
+
+            if (predicate.comparison() == QOrm::Comparison::EqualIgnoringCase)
+                statement += QStringLiteral(" COLLATE NOCASE");
         }
     }
 
     return statement;
 }
 
+QString QOrmSqliteStatementGenerator::generateFilterColumn(
+    const QOrmFilterTerminalPredicate& predicate,
+    QVariantMap& boundParameters)
+{
+    QString column = escapeIdentifier(predicate.propertyMapping()->tableFieldName());
+
+    if (!predicate.arithmeticOperator().has_value())
+        return column;
+
+    QString op;
+
+    switch (*predicate.arithmeticOperator())
+    {
+        case QOrm::ArithmeticOperator::Add:
+            op = "+";
+            break;
+        case QOrm::ArithmeticOperator::Subtract:
+            op = "-";
+            break;
+        case QOrm::ArithmeticOperator::Multiply:
+            op = "*";
+            break;
+        case QOrm::ArithmeticOperator::Divide:
+            op = "/";
+            break;
+    }
+
+    Q_ASSERT(!op.isEmpty());
+
+    const QOrmFilterArithmeticTerm::Operand* operand = predicate.arithmeticOperand();
+    Q_ASSERT(!std::holds_alternative<QOrmClassProperty>(*operand));
+
+    QString operandExpr;
+
+    if (const auto* mapping = std::get_if<QOrmPropertyMapping>(operand))
+    {
+        operandExpr = escapeIdentifier(mapping->tableFieldName());
+    }
+    else
+    {
+        operandExpr = insertParameter(boundParameters,
+                                      predicate.propertyMapping()->tableFieldName(),
+                                      std::get<QVariant>(*operand));
+    }
+
+    return QString{"(%1 %2 %3)"}.arg(column, op, operandExpr);
+}
+
 QString QOrmSqliteStatementGenerator::generateCondition(const QOrmFilterBinaryPredicate& predicate,
                                                         QVariantMap& boundParameters)
 {
@@ -583,10 +1111,12 @@ QString QOrmSqliteStatementGenerator::generateLimitOffsetClause(std::optional<in
 {
     QStringList parts;
 
-    if (offset.has_value())
+    // Positional statements always have both placeholders to keep the statement text independent
+    // of whether only one of the values is given.
+    if (offset.has_value() || (limit.has_value() && m_options.testFlag(PositionalParameters)))
     {
         QString limitKey = insertParameter(boundParameters, "limit", limit.value_or(-1));
-        QString offsetKey = insertParameter(boundParameters, "offset", offset.value());
+        QString offsetKey = insertParameter(boundParameters, "offset", offset.value_or(0));
         return QString{"LIMIT %1 OFFSET %2"}.arg(limitKey, offsetKey);
     }
 
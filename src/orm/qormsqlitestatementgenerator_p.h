@@ -24,16 +24,21 @@
 
 #include <QtOrm/qormglobal.h>
 
+#include <QtCore/qhash.h>
+#include <QtCore/qset.h>
 #include <QtCore/qshareddata.h>
 #include <QtCore/qstring.h>
 #include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
 
 #include <optional>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 QT_BEGIN_NAMESPACE
 
+class QOrmAggregate;
 class QOrmFilter;
 class QOrmFilterBinaryPredicate;
 class QOrmFilterExpression;
@@ -48,10 +53,22 @@ class QOrmRelation;
 class Q_ORM_EXPORT QOrmSqliteStatementGenerator
 {
 public:
+    // With PositionalParameters, the generated statements contain '?' placeholders and depend only
+    // on the shape of the query, not on the bound values. The bound parameters are keyed by their
+    // zero-padded position, so that boundParameters.values() is the ordered parameter vector.
+    //
+    // With WithJsonListParameters, IN lists are bound as a single JSON array parameter expanded
+    // by json_each() instead of a placeholder per list element.
+    //
+    // Without WithUpsertClause, the upsert statement is a plain INSERT including the object IDs,
+    // and the rows which already exist must have been updated beforehand.
     enum Option
     {
         NoOptions = 0x00,
-        WithReturningClause = 0x01
+        WithReturningClause = 0x01,
+        PositionalParameters = 0x02,
+        WithJsonListParameters = 0x04,
+        WithUpsertClause = 0x08
     };
     Q_DECLARE_FLAGS(Options, Option);
 
@@ -66,18 +83,44 @@ public:
                                                   const QObject* instance,
                                                   QVariantMap& boundParameters);
 
+    [[nodiscard]] QString generateInsertStatement(const QOrmMetadata& relation,
+                                                  const QVector<QObject*>& instances,
+                                                  QVariantMap& boundParameters);
+
+    // Multi-row INSERT including the object IDs. The rows which already exist are updated by
+    // ON CONFLICT DO UPDATE.
+    [[nodiscard]] QString generateUpsertStatement(const QOrmMetadata& relation,
+                                                  const QVector<QObject*>& instances,
+                                                  QVariantMap& boundParameters);
+
     [[nodiscard]] QString generateInsertIntoStatement(const QString& destinationTableName,
                                                       const QStringList& destionationColumns,
                                                       const QString& sourceTableName,
                                                       const QStringList& sourceColumns);
 
+    // Properties in skippedProperties are not written, e.g. unfetched lazy references or
+    // unmodified properties.
     [[nodiscard]] QString generateUpdateStatement(const QOrmMetadata& relation,
                                                   const QObject* instance,
-                                                  QVariantMap& boundParameters);
+                                                  QVariantMap& boundParameters,
+                                                  const QSet<QString>& skippedProperties = {});
+
+    // Set-based update of the rows matching the filter; all rows without filter.
+    [[nodiscard]] QString generateUpdateStatement(
+        const QOrmMetadata& relation,
+        const std::vector<std::pair<QOrmPropertyMapping, QVariant>>& assignments,
+        const std::optional<QOrmFilter>& filter,
+        QVariantMap& boundParameters);
 
     [[nodiscard]] QString generateSelectStatement(const QOrmQuery& query,
                                                   QVariantMap& boundParameters);
 
+    // Aggregates are computed over all rows matching the filter, or over the rows of the selected
+    // page if a limit or an offset is set. With groups, a row is read per group, led by the
+    // grouped columns, and the limit and offset apply to the groups.
+    [[nodiscard]] QString generateAggregateSelectStatement(const QOrmQuery& query,
+                                                           QVariantMap& boundParameters);
+
     [[nodiscard]] QString generateDeleteStatement(const QOrmMetadata& relation,
                                                   const QOrmFilter& filter,
                                                   QVariantMap& boundParameters);
@@ -96,6 +139,12 @@ public:
 
     [[nodiscard]] QString generateReturningIdClause(const QOrmMetadata& relation);
 
+    [[nodiscard]] QString generateAggregateExpression(const QOrmAggregate& aggregate);
+
+    [[nodiscard]] QString generateHavingClause(
+        const std::vector<std::tuple<QOrmAggregate, QOrm::Comparison, QVariant>>& having,
+        QVariantMap& boundParameters);
+
     [[nodiscard]] QString generateCondition(const QOrmFilterExpression& expression,
                                             QVariantMap& boundParameters);
     [[nodiscard]] QString generateCondition(const QOrmFilterTerminalPredicate& predicate,
@@ -104,6 +153,9 @@ public:
                                             QVariantMap& boundParameters);
     [[nodiscard]] QString generateCondition(const QOrmFilterUnaryPredicate& predicate,
                                             QVariantMap& boundParameters);
+    // The filtered column, or the arithmetic term of the column if the predicate has one.
+    [[nodiscard]] QString generateFilterColumn(const QOrmFilterTerminalPredicate& predicate,
+                                               QVariantMap& boundParameters);
 
     [[nodiscard]] QString generateCreateTableStatement(
         const QOrmMetadata& entity,
@@ -126,13 +178,26 @@ public:
 
     [[nodiscard]] QString escapeIdentifier(const QString& identifier);
 
-    void setOptions(Options options) { m_options = options; }
+    void setOptions(Options options);
     [[nodiscard]] Options options() const { return m_options; }
 
 private:
+    [[nodiscard]] QString insertParameter(QVariantMap& boundParameters,
+                                          const QString& name,
+                                          const QVariant& value);
+
     Options m_options{NoOptions};
+
+    // Statements that depend only on the entity when generated with PositionalParameters, by
+    // entity class name. Update statements skipping properties are keyed by the class name and
+    // the sorted skipped property names.
+    QHash<QString, QString> m_insertStatements;
+    QHash<QString, QString> m_updateStatements;
+    QHash<QString, QString> m_deleteStatements;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(QOrmSqliteStatementGenerator::Options)
+
 QT_END_NAMESPACE
 
 #endif
@@ -28,6 +28,8 @@
 
 // add necessary includes here
 
+Q_DECLARE_METATYPE(QOrm::ChangeTracking)
+
 class EntityInstanceCache : public QObject
 {
     Q_OBJECT
@@ -40,7 +42,10 @@ private slots:
     void init();
 
     void testWithObjectId();
+    void testModificationTracked_data();
     void testModificationTracked();
+    void testAssignedUnfetchedPropertyIsFetched_data();
+    void testAssignedUnfetchedPropertyIsFetched();
 };
 
 EntityInstanceCache::EntityInstanceCache()
@@ -88,6 +93,10 @@ void EntityInstanceCache::testWithObjectId()
     QCOMPARE(instanceCache.get(metadataCache.get<Town>(), 1), hagenberg.get());
     QCOMPARE(instanceCache.get(metadataCache.get<Town>(), 2), nullptr);
 
+    // object IDs read from the database are 64-bit integers
+    QCOMPARE(instanceCache.get(metadataCache.get<Town>(), QVariant::fromValue(qlonglong{1})),
+             hagenberg.get());
+
     QCOMPARE(instanceCache.take(upperAustria.get()), upperAustria.get());
     QCOMPARE(instanceCache.get(metadataCache.get<Province>(), 1), nullptr);
     QVERIFY(!instanceCache.contains(upperAustria.get()));
@@ -97,10 +106,21 @@ void EntityInstanceCache::testWithObjectId()
     QVERIFY(!instanceCache.contains(hagenberg.get()));
 }
 
+void EntityInstanceCache::testModificationTracked_data()
+{
+    QTest::addColumn<QOrm::ChangeTracking>("changeTracking");
+
+    QTest::newRow("notify signals") << QOrm::ChangeTracking::NotifySignals;
+    QTest::newRow("snapshots") << QOrm::ChangeTracking::Snapshots;
+}
+
 void EntityInstanceCache::testModificationTracked()
 {
+    QFETCH(QOrm::ChangeTracking, changeTracking);
+
     QOrmMetadataCache metadataCache;
     QOrmEntityInstanceCache instanceCache;
+    instanceCache.setChangeTracking(changeTracking);
 
     Province* upperAustria = new Province(1, QString::fromUtf8("Oberösterreich"));
     instanceCache.insert(metadataCache.get<Province>(), upperAustria);
@@ -113,6 +133,47 @@ void EntityInstanceCache::testModificationTracked()
 
     instanceCache.markUnmodified(upperAustria);
     QVERIFY(!instanceCache.isModified(upperAustria));
+
+    Town* linz = new Town(1, QString::fromUtf8("Linz"), nullptr);
+    instanceCache.insert(metadataCache.get<Town>(), linz);
+    instanceCache.finalize(metadataCache.get<Town>(), linz);
+
+    QVERIFY(!instanceCache.isModified(linz));
+
+    linz->setProvince(upperAustria);
+    QVERIFY(instanceCache.isModified(linz));
+
+    instanceCache.markUnmodified(linz);
+    QVERIFY(!instanceCache.isModified(linz));
+}
+
+void EntityInstanceCache::testAssignedUnfetchedPropertyIsFetched_data()
+{
+    testModificationTracked_data();
+}
+
+void EntityInstanceCache::testAssignedUnfetchedPropertyIsFetched()
+{
+    QFETCH(QOrm::ChangeTracking, changeTracking);
+
+    QOrmMetadataCache metadataCache;
+    QOrmEntityInstanceCache instanceCache;
+    instanceCache.setChangeTracking(changeTracking);
+
+    Province* upperAustria = new Province(1, QString::fromUtf8("Oberösterreich"));
+    instanceCache.insert(metadataCache.get<Province>(), upperAustria);
+    instanceCache.finalize(metadataCache.get<Province>(), upperAustria);
+
+    Town* linz = new Town(1, QString::fromUtf8("Linz"), nullptr);
+    instanceCache.insert(metadataCache.get<Town>(), linz);
+    instanceCache.markUnfetched(linz, "province", 1);
+    instanceCache.finalize(metadataCache.get<Town>(), linz);
+
+    QVERIFY(!instanceCache.isFetched(linz, "province"));
+
+    linz->setProvince(upperAustria);
+    QVERIFY(instanceCache.isFetched(linz, "province"));
+    QVERIFY(instanceCache.unfetchedProperties(linz).isEmpty());
 }
 
 QTEST_APPLESS_MAIN(EntityInstanceCache)
@@ -21,9 +21,13 @@
 
 #include <QtTest>
 
+#include <QOrmEntityInstanceCache>
 #include <QOrmEntityListModel>
 #include <QOrmSession>
 #include <QOrmSessionConfiguration>
+#include <QOrmSqliteConfiguration>
+#include <QOrmSqliteProvider>
+#include <QSqlQuery>
 
 #include "domain/province.h"
 #include "domain/town.h"
@@ -36,6 +40,12 @@ private slots:
     void initTestCase();
 
     void testQVectorTInData();
+    void testFetchMoreReadsPages();
+    void testFetchMoreReadsNullValues();
+    void testFetchMoreRereadsChangedRows();
+    void testChangesUpdateRowsInPlace();
+    void testUpdateCountsUnfetchedRows();
+    void testRowsAreNotEvicted();
 };
 
 void EntityListModelTest::initTestCase()
@@ -101,6 +111,279 @@ void EntityListModelTest::testQVectorTInData()
     QVERIFY(hagenberg != nullptr);
     QCOMPARE(hagenberg->id(), 1);
     QCOMPARE(hagenberg->name(), QString::fromUtf8("Hagenberg"));
+
+    QVERIFY(!provinces.data(provinces.index(0), Qt::DisplayRole).isValid());
+    QVERIFY(!provinces.data(provinces.index(0), Qt::UserRole + 3).isValid());
+}
+
+void EntityListModelTest::testFetchMoreReadsPages()
+{
+    QOrmSession session;
+
+    for (int i = 1; i <= 10; ++i)
+        QVERIFY(session.merge(new Province(QString{"Province %1"}.arg(11 - i, 2, 10, QChar{'0'}))));
+
+    QOrmEntityListModel<Province> provinces{session};
+    provinces.setPageSize(4);
+    provinces.setOrder({QString{"name"}});
+
+    QCOMPARE(provinces.totalCount(), 10);
+    QCOMPARE(provinces.rowCount(), 4);
+    QVERIFY(provinces.canFetchMore(QModelIndex{}));
+    QCOMPARE(provinces.data(provinces.index(0), Qt::UserRole + 1).toString(),
+             QString{"Province 01"});
+
+    QSignalSpy rowsInserted{&provinces, &QAbstractItemModel::rowsInserted};
+
+    provinces.fetchMore(QModelIndex{});
+    QCOMPARE(provinces.rowCount(), 8);
+    QCOMPARE(rowsInserted.count(), 1);
+    QCOMPARE(rowsInserted.at(0).at(1).toInt(), 4);
+    QCOMPARE(rowsInserted.at(0).at(2).toInt(), 7);
+
+    provinces.fetchMore(QModelIndex{});
+    QCOMPARE(provinces.rowCount(), 10);
+    QVERIFY(!provinces.canFetchMore(QModelIndex{}));
+
+    for (int i = 0; i < provinces.rowCount(); ++i)
+    {
+        QCOMPARE(provinces.data(provinces.index(i), Qt::UserRole + 1).toString(),
+                 QString{"Province %1"}.arg(i + 1, 2, 10, QChar{'0'}));
+    }
+
+    provinces.setFilter({{"name", "Province 03"}});
+    QCOMPARE(provinces.totalCount(), 1);
+    QCOMPARE(provinces.rowCount(), 1);
+    QVERIFY(!provinces.canFetchMore(QModelIndex{}));
+}
+
+void EntityListModelTest::testFetchMoreReadsNullValues()
+{
+    QOrmSession session;
+
+    for (const char* name : {"A", "B", "C", "D", "E", "F"})
+        QVERIFY(session.merge(new Province(QString{name})));
+
+    QSqlQuery query{
+        static_cast<QOrmSqliteProvider*>(session.configuration().provider())->database()};
+    QVERIFY(query.exec("UPDATE Province SET name = NULL WHERE id > 4"));
+
+    // null values are ordered last in the descending order
+    QOrmEntityListModel<Province> provinces{session};
+    provinces.setPageSize(2);
+    provinces.setOrder({QVariantMap{{"name", QVariant::fromValue(Qt::DescendingOrder)}}});
+
+    while (provinces.canFetchMore(QModelIndex{}))
+        provinces.fetchMore(QModelIndex{});
+
+    QCOMPARE(provinces.totalCount(), 6);
+    QCOMPARE(provinces.rowCount(), 6);
+
+    QVector<int> ids;
+
+    for (int i = 0; i < provinces.rowCount(); ++i)
+        ids.push_back(provinces.data(provinces.index(i), Qt::UserRole).toInt());
+
+    QCOMPARE(ids, (QVector<int>{4, 3, 2, 1, 5, 6}));
+}
+
+void EntityListModelTest::testFetchMoreRereadsChangedRows()
+{
+    QOrmSession session;
+
+    for (const char* name : {"B", "C", "D", "E"})
+        QVERIFY(session.merge(new Province(QString{name})));
+
+    QOrmEntityListModel<Province> provinces{session};
+    provinces.setPageSize(2);
+    provinces.setOrder({QString{"name"}});
+    QCOMPARE(provinces.rowCount(), 2);
+
+    // the rows not fetched yet now precede the fetched ones
+    QSqlQuery query{
+        static_cast<QOrmSqliteProvider*>(session.configuration().provider())->database()};
+    QVERIFY(query.exec("UPDATE Province SET name = 'A' WHERE id > 2"));
+
+    QSignalSpy modelReset{&provinces, &QAbstractItemModel::modelReset};
+
+    provinces.fetchMore(QModelIndex{});
+    QCOMPARE(modelReset.count(), 1);
+    QCOMPARE(provinces.totalCount(), 4);
+
+    while (provinces.canFetchMore(QModelIndex{}))
+        provinces.fetchMore(QModelIndex{});
+
+    QCOMPARE(provinces.rowCount(), 4);
+    QCOMPARE(provinces.data(provinces.index(0), Qt::UserRole).toInt(), 3);
+    QCOMPARE(provinces.data(provinces.index(1), Qt::UserRole).toInt(), 4);
+}
+
+void EntityListModelTest::testChangesUpdateRowsInPlace()
+{
+    QOrmSession session;
+
+    Province* b = new Province(QString{"B"});
+    QVERIFY(session.merge(b, new Province(QString{"D"}), new Province(QString{"F"})));
+
+    QOrmEntityListModel<Province> provinces{session};
+    provinces.setOrder({QString{"name"}});
+
+    auto names = [&provinces]() {
+        QStringList result;
+        for (int i = 0; i < provinces.rowCount(); ++i)
+            result.push_back(provinces.data(provinces.index(i), Qt::UserRole + 1).toString());
+        return result;
+    };
+
+    QSignalSpy modelReset{&provinces, &QAbstractItemModel::modelReset};
+    QSignalSpy rowsInserted{&provinces, &QAbstractItemModel::rowsInserted};
+    QSignalSpy rowsRemoved{&provinces, &QAbstractItemModel::rowsRemoved};
+    QSignalSpy rowsMoved{&provinces, &QAbstractItemModel::rowsMoved};
+
+    QVERIFY(provinces.create({{"name", "C"}}) != nullptr);
+    QCOMPARE(names(), (QStringList{"B", "C", "D", "F"}));
+    QCOMPARE(provinces.totalCount(), 4);
+    QCOMPARE(rowsInserted.count(), 1);
+    QCOMPARE(rowsInserted.at(0).at(1).toInt(), 1);
+
+    QVERIFY(provinces.removeAt(2));
+    QCOMPARE(names(), (QStringList{"B", "C", "F"}));
+    QCOMPARE(provinces.totalCount(), 3);
+    QCOMPARE(rowsRemoved.count(), 1);
+    QCOMPARE(rowsRemoved.at(0).at(1).toInt(), 2);
+    QVERIFY(!provinces.removeAt(3));
+
+    // the session cache hands the same instance to the model
+    QCOMPARE(provinces.indexOf(b), 0);
+    b->setName(QString{"G"});
+    QVERIFY(provinces.update(b));
+    QCOMPARE(names(), (QStringList{"C", "F", "G"}));
+    QCOMPARE(rowsMoved.count(), 1);
+    QCOMPARE(provinces.indexOf(b), 2);
+    QVERIFY(provinces.at(2) == b);
+
+    QCOMPARE(modelReset.count(), 0);
+
+    // a filtered model does not show instances that do not match the filter
+    provinces.setFilter({{"name", "C"}});
+    QCOMPARE(names(), (QStringList{"C"}));
+
+    auto* a = qobject_cast<Province*>(provinces.create({{"name", "A"}}));
+    QVERIFY(a != nullptr);
+    QCOMPARE(names(), (QStringList{"C"}));
+    QCOMPARE(provinces.totalCount(), 1);
+
+    // an updated instance enters and leaves the filter
+    a->setName(QString{"C"});
+    QVERIFY(provinces.update(a));
+    QCOMPARE(names(), (QStringList{"C", "C"}));
+    QCOMPARE(provinces.totalCount(), 2);
+    QCOMPARE(provinces.indexOf(a), 1);
+
+    a->setName(QString{"A"});
+    QVERIFY(provinces.update(a));
+    QCOMPARE(names(), (QStringList{"C"}));
+    QCOMPARE(provinces.totalCount(), 1);
+    QCOMPARE(provinces.indexOf(a), -1);
+}
+
+void EntityListModelTest::testUpdateCountsUnfetchedRows()
+{
+    QOrmSession session;
+
+    for (int i = 0; i < 5; ++i)
+        QVERIFY(session.merge(new Province(QString{"P"})));
+
+    QVERIFY(session.merge(new Province(QString{"Q"})));
+
+    QOrmEntityListModel<Province> provinces{session};
+    provinces.setPageSize(2);
+    provinces.setOrder({QString{"name"}});
+    provinces.setFilter({{"name", "P"}});
+
+    QCOMPARE(provinces.totalCount(), 5);
+    QCOMPARE(provinces.rowCount(), 2);
+
+    Province* unfetched =
+        session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) == 4).select().first();
+    QVERIFY(unfetched != nullptr);
+    QCOMPARE(provinces.indexOf(unfetched), -1);
+
+    // an unfetched row stops matching the filter
+    unfetched->setName(QString{"Q"});
+    QVERIFY(provinces.update(unfetched));
+    QCOMPARE(provinces.totalCount(), 4);
+    QCOMPARE(provinces.rowCount(), 2);
+
+    // an instance starts matching the filter past the fetched rows
+    unfetched->setName(QString{"P"});
+    QVERIFY(provinces.update(unfetched));
+    QCOMPARE(provinces.totalCount(), 5);
+    QCOMPARE(provinces.rowCount(), 2);
+
+    while (provinces.canFetchMore(QModelIndex{}))
+        provinces.fetchMore(QModelIndex{});
+
+    QCOMPARE(provinces.rowCount(), 5);
+    QCOMPARE(provinces.indexOf(unfetched), 3);
+
+    // an instance starts matching the filter once all rows are fetched
+    Province* q =
+        session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) == 6).select().first();
+    QVERIFY(q != nullptr);
+    q->setName(QString{"P"});
+    QVERIFY(provinces.update(q));
+    QCOMPARE(provinces.totalCount(), 6);
+    QCOMPARE(provinces.rowCount(), 6);
+    QCOMPARE(provinces.indexOf(q), 5);
+}
+
+void EntityListModelTest::testRowsAreNotEvicted()
+{
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setVerbose(false);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName(":memory:");
+    QOrmSessionConfiguration sessionConfiguration{
+        new QOrmSqliteProvider{sqliteConfiguration}, true, 10};
+    QOrmSession session{sessionConfiguration};
+
+    for (int i = 1; i <= 20; ++i)
+        QVERIFY(session.merge(new Province(QString{"Province %1"}.arg(i, 2, 10, QChar{'0'}))));
+
+    QOrmEntityInstanceCache* cache = session.entityInstanceCache();
+    QVector<QPointer<QObject>> rows;
+    auto readFirst = [&session]() {
+        return session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) == 1).select().first();
+    };
+
+    {
+        QOrmEntityListModel<Province> provinces{session};
+        QCOMPARE(provinces.rowCount(), 20);
+
+        for (int i = 0; i < provinces.rowCount(); ++i)
+            rows.push_back(provinces.at(i));
+
+        // reading trims the cache, but the rows shown by the model stay cached
+        qint64 evictions = cache->evictions();
+        QVERIFY(readFirst() != nullptr);
+        QCOMPARE(cache->evictions(), evictions);
+
+        for (int i = 0; i < rows.size(); ++i)
+        {
+            QVERIFY(!rows[i].isNull());
+            QCOMPARE(provinces.data(provinces.index(i), Qt::UserRole + 1).toString(),
+                     QString{"Province %1"}.arg(i + 1, 2, 10, QChar{'0'}));
+        }
+    }
+
+    // without the model, they are evicted again
+    qint64 evictions = cache->evictions();
+    QVERIFY(readFirst() != nullptr);
+    QVERIFY(cache->evictions() > evictions);
+    QVERIFY(std::any_of(std::cbegin(rows), std::cend(rows), [](const QPointer<QObject>& row) {
+        return row.isNull();
+    }));
 }
 
 QTEST_GUILESS_MAIN(EntityListModelTest)
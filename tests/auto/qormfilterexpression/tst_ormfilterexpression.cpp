@@ -37,6 +37,8 @@ private slots:
     void testTerminalPredicateGenerationLongRef();
     void testTerminalPredicateGenerationEntity();
     void testTerminalPredicateContainers();
+    void testTerminalPredicateRangesAndPatterns();
+    void testTerminalPredicateArithmetic();
     void testUnaryPredicateGeneration();
     void testBinaryPredicateGeneration();
     void testNestedPredicateGeneration();
@@ -315,6 +317,57 @@ void QOrmFilterExpressionTest::testTerminalPredicateContainers()
     }
 }
 
+void QOrmFilterExpressionTest::testTerminalPredicateRangesAndPatterns()
+{
+    {
+        QOrmFilterExpression expr = Q_ORM_CLASS_PROPERTY(id).between(1, 5);
+        QVERIFY(expr.terminalPredicate() != nullptr);
+        QCOMPARE(expr.terminalPredicate()->comparison(), QOrm::Comparison::Between);
+        QCOMPARE(expr.terminalPredicate()->value(), QVariantList() << 1 << 5);
+        QVERIFY(!expr.terminalPredicate()->arithmeticOperator().has_value());
+    }
+
+    {
+        QOrmFilterExpression expr = Q_ORM_CLASS_PROPERTY(id).notBetween(1, 5);
+        QCOMPARE(expr.terminalPredicate()->comparison(), QOrm::Comparison::NotBetween);
+    }
+
+    {
+        QOrmFilterExpression expr = Q_ORM_CLASS_PROPERTY(id).startsWith("abc");
+        QCOMPARE(expr.terminalPredicate()->comparison(), QOrm::Comparison::StartsWith);
+        QCOMPARE(expr.terminalPredicate()->value(), QVariant{"abc"});
+    }
+
+    {
+        QOrmFilterExpression expr = Q_ORM_CLASS_PROPERTY(id).equalsIgnoringCase("abc");
+        QCOMPARE(expr.terminalPredicate()->comparison(), QOrm::Comparison::EqualIgnoringCase);
+        QCOMPARE(expr.terminalPredicate()->value(), QVariant{"abc"});
+    }
+}
+
+void QOrmFilterExpressionTest::testTerminalPredicateArithmetic()
+{
+    {
+        QOrmFilterTerminalPredicate predicate = (Q_ORM_CLASS_PROPERTY(id) * 2 > 10);
+        QCOMPARE(predicate.classProperty()->descriptor(), "id");
+        QVERIFY(predicate.arithmeticOperator().has_value());
+        QCOMPARE(*predicate.arithmeticOperator(), QOrm::ArithmeticOperator::Multiply);
+        QVERIFY(predicate.arithmeticOperand() != nullptr);
+        QCOMPARE(std::get<QVariant>(*predicate.arithmeticOperand()), QVariant{2});
+        QCOMPARE(predicate.comparison(), QOrm::Comparison::Greater);
+        QCOMPARE(predicate.value(), QVariant{10});
+        QVERIFY(!predicate.isResolved());
+    }
+
+    {
+        QOrmFilterTerminalPredicate predicate =
+            (Q_ORM_CLASS_PROPERTY(id) - Q_ORM_CLASS_PROPERTY(id) == 0);
+        QCOMPARE(*predicate.arithmeticOperator(), QOrm::ArithmeticOperator::Subtract);
+        QVERIFY(std::holds_alternative<QOrmClassProperty>(*predicate.arithmeticOperand()));
+        QCOMPARE(predicate.comparison(), QOrm::Comparison::Equal);
+    }
+}
+
 void QOrmFilterExpressionTest::testUnaryPredicateGeneration()
 {
     {
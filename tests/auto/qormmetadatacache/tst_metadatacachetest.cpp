@@ -45,6 +45,7 @@ private slots:
 
     void testCustomizedEntity();
     void testColumnNameForColumnWithReference();
+    void testLazyReference();
     void testNamespacedEntity();
 
     void testEnumColumn();
@@ -296,6 +297,31 @@ void MetadataCacheTest::testColumnNameForColumnWithReference()
     QCOMPARE(townPropertyMapping->isReference(), true);
 }
 
+class PersonWithLazyTown : public Person
+{
+    Q_OBJECT
+    Q_ORM_PROPERTY(town FETCH LAZY)
+
+public:
+    Q_INVOKABLE PersonWithLazyTown() {}
+};
+
+void MetadataCacheTest::testLazyReference()
+{
+    qRegisterOrmEntity<PersonWithLazyTown>();
+
+    QOrmMetadataCache cache;
+
+    auto townPropertyMapping = cache.get<PersonWithLazyTown>().classPropertyMapping("town");
+    QVERIFY(townPropertyMapping != nullptr);
+    QCOMPARE(townPropertyMapping->isReference(), true);
+    QCOMPARE(townPropertyMapping->isLazy(), true);
+
+    auto eagerTownPropertyMapping = cache.get<Person>().classPropertyMapping("town");
+    QVERIFY(eagerTownPropertyMapping != nullptr);
+    QCOMPARE(eagerTownPropertyMapping->isLazy(), false);
+}
+
 void MetadataCacheTest::testNamespacedEntity()
 {
     qRegisterOrmEntity<MyNamespace::WithNamespace>();
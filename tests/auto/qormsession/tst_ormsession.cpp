@@ -25,8 +25,10 @@
 #include <QOrmError>
 #include <QOrmMetadataCache>
 #include <QOrmSession>
+#include <QOrmSessionNotifier>
 #include <QOrmSqliteConfiguration>
 #include <QOrmSqliteProvider>
+#include <QPointer>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
@@ -38,6 +40,8 @@
 
 #include "private/qormglobal_p.h"
 
+Q_DECLARE_METATYPE(QOrm::ChangeTracking)
+
 class SqliteSessionTest : public QObject
 {
     Q_OBJECT
@@ -57,23 +61,56 @@ private slots:
     void testSelectWithOneToMany();
     void testSelectWithOneToManyWhereIsNull();
     void testSelectWithManyToOne();
+    void testSelectWithManyToOneLoadsReferencesInBatches();
+    void testSelectWithOneToManyLoadsCollectionsInBatches();
+    void testStreamReadsAllRows();
+    void testStreamEvictsInstances();
+    void testStreamEvictsReferencedInstances();
+    void testEntityInstanceCacheEvictsLeastRecentlyUsed();
+    void testMergeAfterEvictionDetachedCollection();
     void testSelectReturnsCachedInstances();
     void testSelectWithSingleStringFilter();
     void testSelectWithOrder();
     void testSelectFromNestedSelect();
     void testSelectWithListFilter();
+    void testSelectWithRangeAndPatternFilters();
+    void testInvokableFilterDoesNotCacheRejectedInstances();
+    void testInvokableFilterDoesNotCacheReferencesOfRejectedInstances();
     void testSelectWithLimitOffset();
+    void testSelectWithKeysetPagination();
     void testSelectWithOverwriteCachedInstances();
+    void testLazyReferenceIsLoadedOnDemand();
+    void testMergeWithLazyOneToMany();
+    void testSelectWithColumnsLeavesOtherPropertiesUnfetched();
+    void testFullSelectRefillsUnfetchedProperties();
+    void testAggregatesDoNotReadInstances();
+    void testAggregateGroupsRows();
 
     void testMergeFailsWithInconsistentReferences();
     void testMergeOfExistingUncachedEntitiesWithExplicitIdsUpdates();
     void testMergeNewEntitiesNoAutogeneratedIds();
     void testMergeNewEntitiesAfterSchemaUpdate();
+    void testMergeAllInsertsInBatches();
+    void testMergeAllIssuesMultiRowInserts();
+    void testMergeAllMergesReferencedInstances();
+    void testMergeAllUpsertsInstancesWithAssignedIds();
+    void testDeferredMergeIsWrittenOnFlush();
+    void testDeferredMergeIsWrittenOnCommit();
+    void testFailedFlushKeepsInstancesPending();
+    void testDeferredMergeOfCachedInstancesReferringToEachOther();
+    void testPendingInstancesAreNotEvicted();
+    void testMergeUpdatesOnlyModifiedColumns_data();
+    void testMergeUpdatesOnlyModifiedColumns();
 
     void testRemoveInstance();
     void testRemoveWithFilter();
 
+    void testUpdateWithFilter();
+
     void testTransactionRollback();
+    void testNotifierEmitsCoalescedChangesAfterCommit();
+
+    void testPreparedStatementsAreReused();
 
     void testSchemaCreatedForReferencedEntities();
     void testSchemaAppendCreatesTablesAndAddsColumns();
@@ -354,6 +391,432 @@ void SqliteSessionTest::testSelectWithManyToOne()
     QCOMPARE(lisaMaier->town()->name(), QString::fromUtf8("Hagenberg"));
 }
 
+void SqliteSessionTest::testSelectWithManyToOneLoadsReferencesInBatches()
+{
+    static constexpr int provinceCount = 5;
+
+    // prepare database
+    {
+        QOrmSession session;
+
+        QVector<Town*> towns;
+
+        for (int i = 0; i < provinceCount; ++i)
+        {
+            Province* province = new Province{QString{"Province %1"}.arg(i)};
+            Town* a = new Town{QString{"Town %1a"}.arg(i), province};
+            Town* b = new Town{QString{"Town %1b"}.arg(i), province};
+            province->setTowns({a, b});
+            towns.push_back(a);
+            towns.push_back(b);
+        }
+
+        QVERIFY(session.mergeAll(towns));
+    }
+
+    // Load data from the database using a new ORM session
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setVerbose(true);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Bypass);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true};
+    QOrmSession session{sessionConfiguration};
+
+    auto result = session.from<Town>().select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+
+    auto towns = result.toVector();
+    QCOMPARE(towns.size(), provinceCount * 2);
+
+    for (int i = 0; i < towns.size(); i += 2)
+    {
+        QVERIFY(towns[i]->province() != nullptr);
+        QCOMPARE(towns[i]->province(), towns[i + 1]->province());
+        QCOMPARE(towns[i]->province()->name(), QString{"Province %1"}.arg(i / 2));
+        QCOMPARE(towns[i]->province()->towns().size(), 2);
+        QVERIFY(towns[i]->province()->towns().contains(towns[i]));
+    }
+
+    // One statement for the towns, one for all provinces and one for the towns of all provinces
+    QCOMPARE(sqliteProvider->statementCacheHits() + sqliteProvider->statementCacheMisses(), 3);
+}
+
+void SqliteSessionTest::testSelectWithOneToManyLoadsCollectionsInBatches()
+{
+    static constexpr int provinceCount = 5;
+
+    // province i has i towns
+    {
+        QOrmSession session;
+
+        QVector<Province*> provinces;
+        QVector<Town*> towns;
+
+        for (int i = 0; i < provinceCount; ++i)
+        {
+            Province* province = new Province{QString{"Province %1"}.arg(i)};
+            QVector<Town*> provinceTowns;
+
+            for (int j = 0; j < i; ++j)
+                provinceTowns.push_back(new Town{QString{"Town %1-%2"}.arg(i).arg(j), province});
+
+            province->setTowns(provinceTowns);
+            provinces.push_back(province);
+            towns += provinceTowns;
+        }
+
+        QVERIFY(session.mergeAll(provinces));
+        QVERIFY(session.mergeAll(towns));
+    }
+
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setVerbose(true);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Bypass);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true};
+    QOrmSession session{sessionConfiguration};
+
+    auto result = session.from<Province>().order(Q_ORM_CLASS_PROPERTY(id)).select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+
+    auto provinces = result.toVector();
+    QCOMPARE(provinces.size(), provinceCount);
+
+    for (int i = 0; i < provinces.size(); ++i)
+    {
+        QCOMPARE(provinces[i]->towns().size(), i);
+
+        for (Town* town : provinces[i]->towns())
+        {
+            QCOMPARE(town->province(), provinces[i]);
+            QVERIFY(town->name().startsWith(QString{"Town %1-"}.arg(i)));
+        }
+    }
+
+    // One statement for the provinces and one IN query for the towns of all provinces
+    QCOMPARE(sqliteProvider->statementCacheHits() + sqliteProvider->statementCacheMisses(), 2);
+}
+
+void SqliteSessionTest::testStreamReadsAllRows()
+{
+    // more rows than the cursor reads at once
+    static constexpr int provinceCount = 600;
+
+    {
+        QOrmSession session;
+
+        QVector<Province*> provinces;
+
+        for (int i = 0; i < provinceCount; ++i)
+            provinces.push_back(new Province{QString{"Province %1"}.arg(i)});
+
+        QVERIFY(session.mergeAll(provinces));
+    }
+
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setVerbose(false);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Bypass);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true};
+    QOrmSession session{sessionConfiguration};
+
+    auto cursor = session.from<Province>().order(Q_ORM_CLASS_PROPERTY(id)).stream();
+    int count = 0;
+
+    while (cursor.next())
+    {
+        QCOMPARE(cursor.current()->name(), QString{"Province %1"}.arg(count));
+        QVERIFY(session.entityInstanceCache()->contains(cursor.current()));
+        ++count;
+    }
+
+    QVERIFY(!cursor.hasError());
+    QCOMPARE(count, provinceCount);
+
+    // the instances stay in the cache
+    QCOMPARE(session.from<Province>().select().toVector().size(), provinceCount);
+}
+
+void SqliteSessionTest::testStreamEvictsInstances()
+{
+    static constexpr int provinceCount = 600;
+
+    {
+        QOrmSession session;
+
+        QVector<Province*> provinces;
+
+        for (int i = 0; i < provinceCount; ++i)
+            provinces.push_back(new Province{QString{"Province %1"}.arg(i)});
+
+        QVERIFY(session.mergeAll(provinces));
+    }
+
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setVerbose(false);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Bypass);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true};
+    QOrmSession session{sessionConfiguration};
+
+    // an instance which was cached before streaming is not evicted
+    Province* first =
+        session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) == 1).select().first();
+    QVERIFY(first != nullptr);
+
+    // the cursor reads chunks of 256 rows
+    static constexpr int chunkSize = 256;
+    static constexpr int modifiedRow = 10;
+
+    QVector<QPointer<Province>> streamed;
+    int count = 0;
+
+    {
+        auto cursor = session.from<Province>()
+                          .order(Q_ORM_CLASS_PROPERTY(id))
+                          .stream(QOrm::QueryFlags::EvictStreamedInstances);
+
+        while (cursor.next())
+        {
+            QCOMPARE(cursor.current()->name(), QString{"Province %1"}.arg(count));
+            streamed.push_back(cursor.current());
+
+            // an unsaved change is not evicted
+            if (count == modifiedRow)
+                cursor.current()->setName(QString{"Modified"});
+
+            // the rows of the previous chunk were evicted when this one was read
+            int previousChunkRow = count - chunkSize;
+
+            if (previousChunkRow > 0 && previousChunkRow != modifiedRow)
+                QVERIFY(streamed[previousChunkRow].isNull());
+
+            ++count;
+        }
+
+        QVERIFY(!cursor.hasError());
+        QVERIFY(!streamed.last().isNull());
+    }
+
+    QCOMPARE(count, provinceCount);
+    QVERIFY(session.entityInstanceCache()->contains(first));
+    QVERIFY(streamed.first() == first);
+
+    for (int row = 1; row < streamed.size(); ++row)
+        QCOMPARE(streamed[row].isNull(), row != modifiedRow);
+
+    QVERIFY(session.entityInstanceCache()->isModified(streamed[modifiedRow]));
+    QCOMPARE(streamed[modifiedRow]->name(), QString{"Modified"});
+}
+
+void SqliteSessionTest::testStreamEvictsReferencedInstances()
+{
+    static constexpr int provinceCount = 2;
+    static constexpr int townsPerProvince = 200;
+
+    {
+        QOrmSession session;
+
+        QVector<Province*> provinces;
+        QVector<Town*> towns;
+
+        for (int i = 0; i < provinceCount; ++i)
+        {
+            Province* province = new Province{QString{"Province %1"}.arg(i)};
+            QVector<Town*> provinceTowns;
+
+            for (int j = 0; j < townsPerProvince; ++j)
+                provinceTowns.push_back(new Town{QString{"Town %1-%2"}.arg(i).arg(j), province});
+
+            province->setTowns(provinceTowns);
+            provinces.push_back(province);
+            towns += provinceTowns;
+        }
+
+        QVERIFY(session.mergeAll(provinces));
+        QVERIFY(session.mergeAll(towns));
+    }
+
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setVerbose(false);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Bypass);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true};
+    QOrmSession session{sessionConfiguration};
+
+    // the cursor reads chunks of 256 rows
+    static constexpr int chunkSize = 256;
+
+    QVector<QPointer<Town>> towns;
+    QVector<QPointer<Province>> provinces;
+    int count = 0;
+
+    {
+        auto cursor = session.from<Town>()
+                          .order(Q_ORM_CLASS_PROPERTY(id))
+                          .stream(QOrm::QueryFlags::EvictStreamedInstances);
+
+        while (cursor.next())
+        {
+            Town* town = cursor.current();
+            QCOMPARE(town->name(),
+                     QString{"Town %1-%2"}
+                         .arg(count / townsPerProvince)
+                         .arg(count % townsPerProvince));
+            QVERIFY(town->province() != nullptr);
+
+            // the town and its province of the previous chunk were evicted together
+            if (count >= chunkSize)
+            {
+                QVERIFY(towns[count - chunkSize].isNull());
+                QVERIFY(provinces[count - chunkSize].isNull());
+            }
+
+            towns.push_back(town);
+            provinces.push_back(town->province());
+            ++count;
+        }
+
+        QVERIFY(!cursor.hasError());
+    }
+
+    for (const QPointer<Town>& town : towns)
+        QVERIFY(town.isNull());
+
+    QCOMPARE(count, provinceCount * townsPerProvince);
+
+    // the provinces and the towns read for them are evicted with the chunks of the stream
+    for (const QPointer<Province>& province : provinces)
+        QVERIFY(province.isNull());
+
+    QCOMPARE(session.from<Town>().select().toVector().size(), provinceCount * townsPerProvince);
+}
+
+void SqliteSessionTest::testEntityInstanceCacheEvictsLeastRecentlyUsed()
+{
+    static constexpr int provinceCount = 20;
+
+    {
+        QOrmSession session;
+
+        QVector<Province*> provinces;
+
+        for (int i = 0; i < provinceCount; ++i)
+            provinces.push_back(new Province{QString{"Province %1"}.arg(i)});
+
+        QVERIFY(session.mergeAll(provinces));
+    }
+
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setVerbose(false);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Bypass);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true, 10};
+    QOrmSession session{sessionConfiguration};
+
+    QOrmEntityInstanceCache* cache = session.entityInstanceCache();
+    QCOMPARE(cache->maxSize(), 10);
+
+    // instances used by the current query are not evicted
+    QVector<Province*> provinces = session.from<Province>().select().toVector();
+    QCOMPARE(provinces.size(), provinceCount);
+    QCOMPARE(cache->evictions(), 0);
+
+    QVector<QPointer<Province>> instances(std::cbegin(provinces), std::cend(provinces));
+    QPointer<Province> first = provinces.front();
+
+    qint64 hits = cache->hits();
+    Province* province =
+        session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) == first->id()).select().first();
+
+    QCOMPARE(province, first.data());
+    QCOMPARE(cache->hits(), hits + 1);
+
+    // evicted down to 90% of the maximum size, keeping the instance just read
+    QCOMPARE(cache->evictions(), provinceCount - 9);
+    auto isEvicted = [](const QPointer<Province>& instance) { return instance.isNull(); };
+    QCOMPARE(static_cast<int>(
+                 std::count_if(std::cbegin(instances), std::cend(instances), isEvicted)),
+             provinceCount - 9);
+    QVERIFY(cache->contains(first));
+
+    // an evicted instance is read again as a new instance
+    auto evicted = std::find_if(std::cbegin(instances), std::cend(instances), isEvicted);
+    int evictedIndex = static_cast<int>(std::distance(std::cbegin(instances), evicted));
+    qint64 misses = cache->misses();
+    province = session.from<Province>()
+                   .filter(Q_ORM_CLASS_PROPERTY(id) == evictedIndex + 1)
+                   .select()
+                   .first();
+
+    QVERIFY(province != nullptr);
+    QCOMPARE(province->name(), QString{"Province %1"}.arg(evictedIndex));
+    QCOMPARE(cache->misses(), misses + 1);
+}
+
+void SqliteSessionTest::testMergeAfterEvictionDetachedCollection()
+{
+    {
+        QOrmSession session;
+
+        Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+        Town* hagenberg = new Town(QString::fromUtf8("Hagenberg"), upperAustria);
+        Town* pregarten = new Town(QString::fromUtf8("Pregarten"), upperAustria);
+        upperAustria->setTowns({hagenberg, pregarten});
+
+        QVERIFY(session.merge(hagenberg, pregarten, upperAustria));
+    }
+
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setVerbose(true);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Bypass);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true};
+    QOrmSession session{sessionConfiguration};
+
+    Province* upperAustria = session.from<Province>().select().first();
+    QVERIFY(upperAustria != nullptr);
+    QCOMPARE(upperAustria->towns().size(), 2);
+
+    Town* hagenberg = upperAustria->towns().at(0);
+    Town* pregarten = upperAustria->towns().at(1);
+
+    if (hagenberg->name() != QString::fromUtf8("Hagenberg"))
+        std::swap(hagenberg, pregarten);
+
+    // the collection of the province becomes unfetched: it no longer tells whether a town belongs
+    // to the province
+    session.entityInstanceCache()->evict({hagenberg});
+    QVERIFY(upperAustria->towns().isEmpty());
+    QCOMPARE(pregarten->province(), upperAustria);
+
+    pregarten->setName(QString::fromUtf8("Pregarten-Stadt"));
+    QVERIFY(session.merge(pregarten));
+
+    upperAustria->setName(QString::fromUtf8("Upper Austria"));
+    QVERIFY(session.merge(upperAustria));
+
+    QSqlQuery query{sqliteProvider->database()};
+    QVERIFY(query.exec("SELECT name, province_id FROM Town ORDER BY id"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toString(), QString::fromUtf8("Hagenberg"));
+    QCOMPARE(query.value(1).toInt(), upperAustria->id());
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toString(), QString::fromUtf8("Pregarten-Stadt"));
+    QCOMPARE(query.value(1).toInt(), upperAustria->id());
+
+    QVERIFY(query.exec("SELECT name FROM Province"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toString(), QString::fromUtf8("Upper Austria"));
+}
+
 void SqliteSessionTest::testSelectReturnsCachedInstances()
 {
     QOrmSession session;
@@ -479,70 +942,1018 @@ void SqliteSessionTest::testSelectWithListFilter()
     }
 }
 
-void SqliteSessionTest::testSelectWithLimitOffset()
+void SqliteSessionTest::testSelectWithRangeAndPatternFilters()
 {
     QOrmSession session;
-    session.merge(new Province(QString::fromUtf8("Tirol")),
-                  new Province(QString::fromUtf8("Oberösterreich")),
-                  new Province(QString::fromUtf8("Niederösterreich")),
-                  new Province(QString::fromUtf8("Salzburg")),
-                  new Province(QString::fromUtf8("Burgenland")),
-                  new Province(QString::fromUtf8("Kärnten")));
 
+    QVector<Province*> provinces;
+
+    for (int i = 1; i <= 10; ++i)
+        provinces.push_back(new Province(QString{"Province %1"}.arg(i, 2, 10, QChar{'0'})));
+
+    QVERIFY(session.mergeAll(provinces));
+
+    QCOMPARE(session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id).between(3, 5)).count(),
+             qint64{3});
+    QCOMPARE(session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id).notBetween(3, 5)).count(),
+             qint64{7});
+    QCOMPARE(session.from<Province>()
+                 .filter(Q_ORM_CLASS_PROPERTY(name).between("Province 02", "Province 04"))
+                 .count(),
+             qint64{3});
+
+    QCOMPARE(session.from<Province>()
+                 .filter(Q_ORM_CLASS_PROPERTY(name).startsWith("Province 1"))
+                 .count(),
+             qint64{1});
+    QCOMPARE(session.from<Province>()
+                 .filter(Q_ORM_CLASS_PROPERTY(name).startsWith("province 1"))
+                 .count(),
+             qint64{0});
+    QCOMPARE(session.from<Province>()
+                 .filter(Q_ORM_CLASS_PROPERTY(name).equalsIgnoringCase("PROVINCE 07"))
+                 .count(),
+             qint64{1});
+
+    QCOMPARE(session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) * 2 > 14).count(),
+             qint64{3});
+    QCOMPARE(session.from<Province>()
+                 .filter(Q_ORM_CLASS_PROPERTY(id) - Q_ORM_CLASS_PROPERTY(id) == 0)
+                 .count(),
+             qint64{10});
+}
+
+void SqliteSessionTest::testInvokableFilterDoesNotCacheRejectedInstances()
+{
     {
-        auto result =
-            session.from<Province>().order(Q_ORM_CLASS_PROPERTY(id)).limit(3).select().toVector();
+        QOrmSession session;
 
-        QCOMPARE(result.size(), 3);
-        QCOMPARE(result.at(0)->id(), 1);
-        QCOMPARE(result.at(1)->id(), 2);
-        QCOMPARE(result.at(2)->id(), 3);
+        QVector<Province*> provinces;
+
+        for (int i = 1; i <= 10; ++i)
+            provinces.push_back(new Province(QString{"Province %1"}.arg(i)));
+
+        QVERIFY(session.mergeAll(provinces));
     }
 
+    QOrmSession session{QOrmSessionConfiguration::fromFile(":/qtorm_bypass_schema.json")};
+    QOrmEntityInstanceCache* cache = session.entityInstanceCache();
+    const QOrmMetadata& provinceMetadata = session.metadataCache()->get<Province>();
+
+    auto first = session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) == 1).select().toVector();
+    QCOMPARE(first.size(), 1);
+
     {
-        auto result =
-            session.from<Province>().order(Q_ORM_CLASS_PROPERTY(id)).offset(2).select().toVector();
+        auto result = session.from<Province>()
+                          .filter(Q_ORM_CLASS_PROPERTY(id) <= 6)
+                          .filter([](const Province* province) { return province->id() != 3; })
+                          .filter([](const Province* province) { return province->id() != 5; })
+                          .select()
+                          .toVector();
 
         QCOMPARE(result.size(), 4);
-        QCOMPARE(result.at(0)->id(), 3);
-        QCOMPARE(result.at(1)->id(), 4);
-        QCOMPARE(result.at(2)->id(), 5);
-        QCOMPARE(result.at(3)->id(), 6);
+        QVERIFY(cache->get(provinceMetadata, 2) != nullptr);
+        QVERIFY(cache->get(provinceMetadata, 3) == nullptr);
+        QVERIFY(cache->get(provinceMetadata, 5) == nullptr);
     }
 
     {
+        // already cached instances stay in the cache
         auto result = session.from<Province>()
-                          .order(Q_ORM_CLASS_PROPERTY(id))
-                          .limit(3)
-                          .offset(2)
+                          .filter(Q_ORM_CLASS_PROPERTY(id) <= 2)
+                          .filter([](const Province* province) { return province->id() != 1; })
                           .select()
                           .toVector();
 
-        QCOMPARE(result.size(), 3);
-        QCOMPARE(result.at(0)->id(), 3);
-        QCOMPARE(result.at(1)->id(), 4);
-        QCOMPARE(result.at(2)->id(), 5);
+        QCOMPARE(result.size(), 1);
+        QVERIFY(cache->get(provinceMetadata, 1) == first.front());
     }
-}
-
-void SqliteSessionTest::testSelectWithOverwriteCachedInstances()
-{
-    QOrmSession session;
 
-    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    QTest::ignoreMessage(QtWarningMsg,
+                         QRegularExpression{"Invokable filter without an expression filter"});
 
-    QVERIFY(session.merge(upperAustria));
+    auto result = session.from<Province>()
+                      .filter([](const Province* province) { return province->id() > 8; })
+                      .select()
+                      .toVector();
 
-    upperAustria->setName("Oberoesterreich");
+    QCOMPARE(result.size(), 2);
+    QVERIFY(cache->get(provinceMetadata, 7) == nullptr);
+}
 
-    QVERIFY(session.entityInstanceCache()->isModified(upperAustria));
+void SqliteSessionTest::testInvokableFilterDoesNotCacheReferencesOfRejectedInstances()
+{
+    {
+        QOrmSession session;
 
-    std::ignore =
+        Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+        Province* lowerAustria = new Province(QString::fromUtf8("Niederösterreich"));
+        Town* hagenberg = new Town(QString::fromUtf8("Hagenberg"), upperAustria);
+        Town* pregarten = new Town(QString::fromUtf8("Pregarten"), upperAustria);
+        Town* melk = new Town(QString::fromUtf8("Melk"), lowerAustria);
+        Town* krems = new Town(QString::fromUtf8("Krems"), lowerAustria);
+        upperAustria->setTowns({hagenberg, pregarten});
+        lowerAustria->setTowns({melk, krems});
+
+        QVERIFY(session.merge(hagenberg, pregarten, melk, krems, upperAustria, lowerAustria));
+    }
+
+    QOrmSession session{QOrmSessionConfiguration::fromFile(":/qtorm_bypass_schema.json")};
+    QOrmEntityInstanceCache* cache = session.entityInstanceCache();
+    const QOrmMetadata& provinceMetadata = session.metadataCache()->get<Province>();
+    const QOrmMetadata& townMetadata = session.metadataCache()->get<Town>();
+
+    auto result = session.from<Town>()
+                      .filter(Q_ORM_CLASS_PROPERTY(id) <= 4)
+                      .filter([](const Town* town) { return town->province()->id() == 1; })
+                      .select()
+                      .toVector();
+
+    QCOMPARE(result.size(), 2);
+
+    // the province of the accepted towns and its collection stay cached
+    Province* upperAustria = qobject_cast<Province*>(cache->get(provinceMetadata, 1));
+    QVERIFY(upperAustria != nullptr);
+    QVERIFY(upperAustria == result.front()->province());
+    QCOMPARE(upperAustria->towns().size(), 2);
+
+    // the province read only for the rejected towns is evicted with them
+    QVERIFY(cache->get(provinceMetadata, 2) == nullptr);
+    QVERIFY(cache->get(townMetadata, 3) == nullptr);
+    QVERIFY(cache->get(townMetadata, 4) == nullptr);
+}
+
+void SqliteSessionTest::testSelectWithLimitOffset()
+{
+    QOrmSession session;
+    session.merge(new Province(QString::fromUtf8("Tirol")),
+                  new Province(QString::fromUtf8("Oberösterreich")),
+                  new Province(QString::fromUtf8("Niederösterreich")),
+                  new Province(QString::fromUtf8("Salzburg")),
+                  new Province(QString::fromUtf8("Burgenland")),
+                  new Province(QString::fromUtf8("Kärnten")));
+
+    {
+        auto result =
+            session.from<Province>().order(Q_ORM_CLASS_PROPERTY(id)).limit(3).select().toVector();
+
+        QCOMPARE(result.size(), 3);
+        QCOMPARE(result.at(0)->id(), 1);
+        QCOMPARE(result.at(1)->id(), 2);
+        QCOMPARE(result.at(2)->id(), 3);
+    }
+
+    {
+        auto result =
+            session.from<Province>().order(Q_ORM_CLASS_PROPERTY(id)).offset(2).select().toVector();
+
+        QCOMPARE(result.size(), 4);
+        QCOMPARE(result.at(0)->id(), 3);
+        QCOMPARE(result.at(1)->id(), 4);
+        QCOMPARE(result.at(2)->id(), 5);
+        QCOMPARE(result.at(3)->id(), 6);
+    }
+
+    {
+        auto result = session.from<Province>()
+                          .order(Q_ORM_CLASS_PROPERTY(id))
+                          .limit(3)
+                          .offset(2)
+                          .select()
+                          .toVector();
+
+        QCOMPARE(result.size(), 3);
+        QCOMPARE(result.at(0)->id(), 3);
+        QCOMPARE(result.at(1)->id(), 4);
+        QCOMPARE(result.at(2)->id(), 5);
+    }
+}
+
+void SqliteSessionTest::testSelectWithKeysetPagination()
+{
+    QOrmSession session;
+
+    QVector<Province*> provinces{new Province(QString::fromUtf8("A")),
+                                 new Province(QString::fromUtf8("B")),
+                                 new Province(QString::fromUtf8("B")),
+                                 new Province(QString::fromUtf8("C")),
+                                 new Province(QString::fromUtf8("D")),
+                                 new Province(QString::fromUtf8("D"))};
+
+    QVERIFY(session.mergeAll(provinces));
+
+    auto ids = [](const QVector<Province*>& result) {
+        QVector<int> values;
+
+        for (const Province* province : result)
+            values.push_back(province->id());
+
+        return values;
+    };
+
+    // ties of the ordered property are broken by the object ID
+    QCOMPARE(ids(session.from<Province>()
+                     .order(Q_ORM_CLASS_PROPERTY(name))
+                     .after(provinces[1])
+                     .limit(2)
+                     .select()
+                     .toVector()),
+             (QVector<int>{3, 4}));
+    QCOMPARE(ids(session.from<Province>()
+                     .order(Q_ORM_CLASS_PROPERTY(name))
+                     .after(provinces[4])
+                     .select()
+                     .toVector()),
+             (QVector<int>{6}));
+    QCOMPARE(ids(session.from<Province>()
+                     .order(Q_ORM_CLASS_PROPERTY(name))
+                     .before(provinces[3])
+                     .limit(2)
+                     .select()
+                     .toVector()),
+             (QVector<int>{2, 3}));
+
+    QCOMPARE(ids(session.from<Province>()
+                     .order(Q_ORM_CLASS_PROPERTY(name), Qt::DescendingOrder)
+                     .after(provinces[5])
+                     .limit(2)
+                     .select()
+                     .toVector()),
+             (QVector<int>{4, 2}));
+    QCOMPARE(ids(session.from<Province>()
+                     .order(Q_ORM_CLASS_PROPERTY(name), Qt::DescendingOrder)
+                     .before(provinces[1])
+                     .limit(2)
+                     .select()
+                     .toVector()),
+             (QVector<int>{6, 4}));
+
+    QCOMPARE(ids(session.from<Province>().after(provinces[3]).select().toVector()),
+             (QVector<int>{5, 6}));
+    QCOMPARE(ids(session.from<Province>()
+                     .filter(Q_ORM_CLASS_PROPERTY(name) != "D")
+                     .before(provinces[5])
+                     .select()
+                     .toVector()),
+             (QVector<int>{1, 2, 3, 4}));
+    QCOMPARE(session.from<Province>().after(provinces[0]).count(), qint64{5});
+
+    // null values are ordered first: they follow all other rows in the descending order
+    QVERIFY(session.merge(new Province(QString::fromUtf8("E")),
+                          new Province(QString::fromUtf8("E"))));
+
+    QSqlQuery query{
+        static_cast<QOrmSqliteProvider*>(session.configuration().provider())->database()};
+    QVERIFY(query.exec("UPDATE Province SET name = NULL WHERE id > 6"));
+
+    QCOMPARE(ids(session.from<Province>()
+                     .order(Q_ORM_CLASS_PROPERTY(name), Qt::DescendingOrder)
+                     .after(provinces[3])
+                     .select()
+                     .toVector()),
+             (QVector<int>{2, 3, 1, 7, 8}));
+    QCOMPARE(ids(session.from<Province>()
+                     .order(Q_ORM_CLASS_PROPERTY(name), Qt::DescendingOrder)
+                     .after(provinces[0])
+                     .limit(1)
+                     .select()
+                     .toVector()),
+             (QVector<int>{7}));
+    QCOMPARE(ids(session.from<Province>()
+                     .order(Q_ORM_CLASS_PROPERTY(name))
+                     .before(provinces[1])
+                     .select()
+                     .toVector()),
+             (QVector<int>{7, 8, 1}));
+    QCOMPARE(ids(session.from<Province>()
+                     .order(Q_ORM_CLASS_PROPERTY(name))
+                     .after(provinces[0])
+                     .select()
+                     .toVector()),
+             (QVector<int>{2, 3, 4, 5, 6}));
+}
+
+void SqliteSessionTest::testSelectWithOverwriteCachedInstances()
+{
+    QOrmSession session;
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+
+    QVERIFY(session.merge(upperAustria));
+
+    upperAustria->setName("Oberoesterreich");
+
+    QVERIFY(session.entityInstanceCache()->isModified(upperAustria));
+
+    std::ignore =
         session.from<Province>().select(QOrm::QueryFlags::OverwriteCachedInstances).toVector();
     QCOMPARE(upperAustria->name(), QString::fromUtf8("Oberösterreich"));
     QVERIFY(!session.entityInstanceCache()->isModified(upperAustria));
 }
 
+class TownWithLazyProvince : public Town
+{
+    Q_OBJECT
+
+    Q_ORM_PROPERTY(province FETCH LAZY)
+
+public:
+    Q_INVOKABLE TownWithLazyProvince(QObject* parent = nullptr)
+        : Town{parent}
+    {
+    }
+};
+
+void SqliteSessionTest::testLazyReferenceIsLoadedOnDemand()
+{
+    qRegisterOrmEntity<TownWithLazyProvince>();
+
+    // prepare database
+    {
+        QOrmSession session;
+
+        TownWithLazyProvince* hagenberg = new TownWithLazyProvince;
+        hagenberg->setName(QString::fromUtf8("Hagenberg"));
+        hagenberg->setProvince(new Province{QString::fromUtf8("Oberösterreich")});
+
+        QVERIFY(session.merge(hagenberg));
+    }
+
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setVerbose(true);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Bypass);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true};
+    QOrmSession session{sessionConfiguration};
+
+    auto towns = session.from<TownWithLazyProvince>().select().toVector();
+    QCOMPARE(towns.size(), 1);
+
+    TownWithLazyProvince* hagenberg = towns[0];
+    QVERIFY(hagenberg->province() == nullptr);
+    QVERIFY(!session.entityInstanceCache()->isFetched(hagenberg, "province"));
+
+    // the unloaded reference is not overwritten by a merge
+    hagenberg->setName(QString::fromUtf8("Hagenberg im Mühlkreis"));
+    QVERIFY(session.merge(hagenberg));
+
+    QVERIFY(session.load(hagenberg, Q_ORM_CLASS_PROPERTY(province)));
+    QVERIFY(hagenberg->province() != nullptr);
+    QCOMPARE(hagenberg->province()->name(), QString::fromUtf8("Oberösterreich"));
+    QVERIFY(session.entityInstanceCache()->isFetched(hagenberg, "province"));
+    QVERIFY(!session.entityInstanceCache()->isModified(hagenberg));
+}
+
+class ProvinceWithLazyTowns;
+
+class TownOfLazyProvince : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int id READ id WRITE setId NOTIFY idChanged)
+    Q_PROPERTY(QString name READ name WRITE setName NOTIFY nameChanged)
+    Q_PROPERTY(ProvinceWithLazyTowns* province READ province WRITE setProvince NOTIFY
+                   provinceChanged)
+
+public:
+    Q_INVOKABLE explicit TownOfLazyProvince(QObject* parent = nullptr)
+        : QObject{parent}
+    {
+    }
+
+    int id() const { return m_id; }
+    void setId(int id)
+    {
+        m_id = id;
+        emit idChanged();
+    }
+
+    QString name() const { return m_name; }
+    void setName(QString name)
+    {
+        m_name = name;
+        emit nameChanged();
+    }
+
+    ProvinceWithLazyTowns* province() const { return m_province; }
+    void setProvince(ProvinceWithLazyTowns* province)
+    {
+        m_province = province;
+        emit provinceChanged();
+    }
+
+signals:
+    void idChanged();
+    void nameChanged();
+    void provinceChanged();
+
+private:
+    int m_id{0};
+    QString m_name;
+    ProvinceWithLazyTowns* m_province{nullptr};
+};
+
+class ProvinceWithLazyTowns : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int id READ id WRITE setId NOTIFY idChanged)
+    Q_PROPERTY(QString name READ name WRITE setName NOTIFY nameChanged)
+    Q_PROPERTY(QVector<TownOfLazyProvince*> towns READ towns WRITE setTowns NOTIFY townsChanged)
+
+    Q_ORM_PROPERTY(towns FETCH LAZY)
+
+public:
+    Q_INVOKABLE explicit ProvinceWithLazyTowns(QObject* parent = nullptr)
+        : QObject{parent}
+    {
+    }
+
+    int id() const { return m_id; }
+    void setId(int id)
+    {
+        m_id = id;
+        emit idChanged();
+    }
+
+    QString name() const { return m_name; }
+    void setName(QString name)
+    {
+        m_name = name;
+        emit nameChanged();
+    }
+
+    QVector<TownOfLazyProvince*> towns() const { return m_towns; }
+    void setTowns(QVector<TownOfLazyProvince*> towns)
+    {
+        m_towns = towns;
+        emit townsChanged();
+    }
+
+signals:
+    void idChanged();
+    void nameChanged();
+    void townsChanged();
+
+private:
+    int m_id{0};
+    QString m_name;
+    QVector<TownOfLazyProvince*> m_towns;
+};
+
+void SqliteSessionTest::testMergeWithLazyOneToMany()
+{
+    qRegisterOrmEntity<ProvinceWithLazyTowns, TownOfLazyProvince>();
+
+    // prepare database
+    {
+        QOrmSession session;
+
+        ProvinceWithLazyTowns* upperAustria = new ProvinceWithLazyTowns;
+        upperAustria->setName(QString::fromUtf8("Oberösterreich"));
+
+        TownOfLazyProvince* hagenberg = new TownOfLazyProvince;
+        hagenberg->setName(QString::fromUtf8("Hagenberg"));
+        hagenberg->setProvince(upperAustria);
+
+        TownOfLazyProvince* linz = new TownOfLazyProvince;
+        linz->setName(QString::fromUtf8("Linz"));
+        linz->setProvince(upperAustria);
+
+        upperAustria->setTowns({hagenberg, linz});
+
+        QVERIFY(session.merge(hagenberg, linz));
+    }
+
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setVerbose(true);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Bypass);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true};
+    QOrmSession session{sessionConfiguration};
+
+    auto towns = session.from<TownOfLazyProvince>().select().toVector();
+    QCOMPARE(towns.size(), 2);
+
+    TownOfLazyProvince* hagenberg = towns[0];
+    ProvinceWithLazyTowns* upperAustria = hagenberg->province();
+    QVERIFY(upperAustria != nullptr);
+    QVERIFY(upperAustria->towns().isEmpty());
+    QVERIFY(!session.entityInstanceCache()->isFetched(upperAustria, "towns"));
+
+    // the unfetched collection is not checked for the back-reference
+    hagenberg->setName(QString::fromUtf8("Hagenberg im Mühlkreis"));
+    QVERIFY(session.merge(hagenberg));
+
+    upperAustria->setName(QString::fromUtf8("Upper Austria"));
+    QVERIFY(session.merge(upperAustria));
+
+    QVERIFY(session.load(upperAustria, Q_ORM_CLASS_PROPERTY(towns)));
+    QCOMPARE(upperAustria->towns().size(), 2);
+    QVERIFY(upperAustria->towns().contains(hagenberg));
+
+    // once fetched, the collection is checked again
+    TownOfLazyProvince* linz = towns[1];
+    upperAustria->setTowns({hagenberg});
+    linz->setName(QString::fromUtf8("Linz an der Donau"));
+    QVERIFY(QOrmPrivate::crossReferenceError(session.metadataCache()->get<TownOfLazyProvince>(),
+                                             linz,
+                                             session.entityInstanceCache())
+                .has_value());
+}
+
+void SqliteSessionTest::testSelectWithColumnsLeavesOtherPropertiesUnfetched()
+{
+    // prepare database
+    {
+        QOrmSession session;
+
+        Province* upperAustria = new Province{QString::fromUtf8("Oberösterreich")};
+        Town* hagenberg = new Town{QString::fromUtf8("Hagenberg"), upperAustria};
+        upperAustria->setTowns({hagenberg});
+
+        QVERIFY(session.merge(hagenberg, upperAustria));
+    }
+
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setVerbose(true);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Bypass);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true};
+    QOrmSession session{sessionConfiguration};
+
+    auto towns = session.from<Town>().columns(Q_ORM_CLASS_PROPERTY(name)).select().toVector();
+    QCOMPARE(towns.size(), 1);
+
+    Town* hagenberg = towns[0];
+    QCOMPARE(hagenberg->id(), 1);
+    QCOMPARE(hagenberg->name(), QString::fromUtf8("Hagenberg"));
+    QVERIFY(hagenberg->province() == nullptr);
+    QVERIFY(session.entityInstanceCache()->isFetched(hagenberg, "name"));
+    QVERIFY(!session.entityInstanceCache()->isFetched(hagenberg, "province"));
+
+    // the unfetched reference is not overwritten by a merge
+    hagenberg->setName(QString::fromUtf8("Hagenberg im Mühlkreis"));
+    QVERIFY(session.merge(hagenberg));
+
+    QSqlQuery query{sqliteProvider->database()};
+    QVERIFY(query.exec("SELECT province_id FROM Town WHERE id = 1"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 1);
+    query.finish();
+
+    QVERIFY(session.load(hagenberg, Q_ORM_CLASS_PROPERTY(province)));
+    QVERIFY(hagenberg->province() != nullptr);
+    QCOMPARE(hagenberg->province()->name(), QString::fromUtf8("Oberösterreich"));
+    QCOMPARE(hagenberg->name(), QString::fromUtf8("Hagenberg im Mühlkreis"));
+    QVERIFY(session.entityInstanceCache()->isFetched(hagenberg, "province"));
+    QVERIFY(!session.entityInstanceCache()->isModified(hagenberg));
+}
+
+void SqliteSessionTest::testFullSelectRefillsUnfetchedProperties()
+{
+    // prepare database
+    {
+        QOrmSession session;
+
+        Province* upperAustria = new Province{QString::fromUtf8("Oberösterreich")};
+        Town* hagenberg = new Town{QString::fromUtf8("Hagenberg"), upperAustria};
+        upperAustria->setTowns({hagenberg});
+
+        QVERIFY(session.merge(hagenberg, upperAustria));
+    }
+
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setVerbose(true);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Bypass);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true};
+    QOrmSession session{sessionConfiguration};
+
+    auto towns = session.from<Town>().columns(Q_ORM_CLASS_PROPERTY(name)).select().toVector();
+    QCOMPARE(towns.size(), 1);
+
+    Town* hagenberg = towns[0];
+    QVERIFY(hagenberg->province() == nullptr);
+    QVERIFY(!session.entityInstanceCache()->isFetched(hagenberg, "province"));
+
+    // a full read returns the cached instance and fills its unfetched properties
+    towns = session.from<Town>().select().toVector();
+    QCOMPARE(towns.size(), 1);
+    QCOMPARE(towns[0], hagenberg);
+    QVERIFY(hagenberg->province() != nullptr);
+    QCOMPARE(hagenberg->province()->name(), QString::fromUtf8("Oberösterreich"));
+    QCOMPARE(hagenberg->province()->towns(), QVector<Town*>{hagenberg});
+    QVERIFY(session.entityInstanceCache()->isFetched(hagenberg, "province"));
+    QVERIFY(!session.entityInstanceCache()->isModified(hagenberg));
+
+    // the refilled instance can be merged
+    hagenberg->setName(QString::fromUtf8("Hagenberg im Mühlkreis"));
+    QVERIFY(session.merge(hagenberg));
+}
+
+void SqliteSessionTest::testMergeAllUpsertsInstancesWithAssignedIds()
+{
+    {
+        QOrmSession session;
+
+        QVERIFY(session.mergeAll(QVector<Province*>{new Province("Oberösterreich"),
+                                                    new Province("Niederösterreich")}));
+    }
+
+    {
+        QOrmSession session{QOrmSessionConfiguration::fromFile(":/qtorm_bypass_schema.json")};
+
+        QVector<Province*> provinces{new Province(1, "Upper Austria"),
+                                     new Province(5, "Vienna"),
+                                     new Province("Salzburg")};
+
+        QVERIFY(session.mergeAll(provinces));
+
+        QCOMPARE(provinces[0]->id(), 1);
+        QCOMPARE(provinces[1]->id(), 5);
+        QCOMPARE(provinces[2]->id(), 6);
+        QCOMPARE(session.from<Province>().select().toVector().size(), 4);
+
+        // the row of a cached instance cannot be upserted from another instance
+        QScopedPointer<Province> duplicate{new Province(5, "Wien")};
+        QVERIFY(!session.merge(duplicate.get()));
+        QCOMPARE(session.lastError().type(), QOrm::ErrorType::UnsynchronizedEntity);
+        QCOMPARE(provinces[1]->name(), QString{"Vienna"});
+    }
+
+    {
+        QOrmSession session{QOrmSessionConfiguration::fromFile(":/qtorm_bypass_schema.json")};
+
+        auto result = session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) == 1).select();
+        QCOMPARE(result.toVector().size(), 1);
+        QCOMPARE(result.toVector().front()->name(), QString{"Upper Austria"});
+    }
+}
+
+void SqliteSessionTest::testDeferredMergeIsWrittenOnFlush()
+{
+    QOrmSession session;
+    session.setFlushMode(QOrm::FlushMode::Deferred);
+
+    auto* sqliteProvider = static_cast<QOrmSqliteProvider*>(session.configuration().provider());
+
+    // process the schema before counting statements
+    QVERIFY(session.from<Province>().select().toVector().isEmpty());
+    QVERIFY(session.from<Town>().select().toVector().isEmpty());
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    Province* styria = new Province(QString::fromUtf8("Steiermark"));
+    Town* hagenberg = new Town(QString::fromUtf8("Hagenberg"), upperAustria);
+    Town* linz = new Town(QString::fromUtf8("Linz"), upperAustria);
+    Town* graz = new Town(QString::fromUtf8("Graz"), styria);
+    upperAustria->setTowns({hagenberg, linz});
+    styria->setTowns({graz});
+
+    QVERIFY(session.merge(hagenberg));
+    QVERIFY(session.merge(linz));
+    QVERIFY(session.merge(graz));
+
+    QVERIFY(!session.entityInstanceCache()->contains(hagenberg));
+    QVERIFY(session.from<Town>().select().toVector().isEmpty());
+
+    qint64 statements = sqliteProvider->statementCacheHits() +
+                        sqliteProvider->statementCacheMisses();
+
+    // the provinces before the towns, one INSERT per entity
+    QVERIFY(session.flush());
+    QCOMPARE(sqliteProvider->statementCacheHits() + sqliteProvider->statementCacheMisses(),
+             statements + 2);
+
+    QCOMPARE(upperAustria->id(), 1);
+    QCOMPARE(styria->id(), 2);
+    QVERIFY(session.entityInstanceCache()->contains(upperAustria));
+    QVERIFY(session.entityInstanceCache()->contains(graz));
+
+    auto towns = session.from<Town>()
+                     .filter(Q_ORM_CLASS_PROPERTY(province) == styria)
+                     .select()
+                     .toVector();
+    QCOMPARE(towns.size(), 1);
+    QCOMPARE(towns.front(), graz);
+
+    // modifications are written by the next flush
+    linz->setName(QString::fromUtf8("Linz an der Donau"));
+    QVERIFY(session.merge(linz));
+    QVERIFY(session.entityInstanceCache()->isModified(linz));
+
+    QVERIFY(session.flush());
+    QVERIFY(!session.entityInstanceCache()->isModified(linz));
+
+    QSqlQuery query{sqliteProvider->database()};
+    QVERIFY(query.exec("SELECT name FROM Town WHERE id = 2"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toString(), QString::fromUtf8("Linz an der Donau"));
+}
+
+void SqliteSessionTest::testDeferredMergeIsWrittenOnCommit()
+{
+    QOrmSession session;
+    session.setFlushMode(QOrm::FlushMode::Deferred);
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+
+    {
+        auto token = session.declareTransaction(QOrm::TransactionPropagation::Require,
+                                                QOrm::TransactionAction::Commit);
+
+        QVERIFY(session.merge(upperAustria));
+        QVERIFY(!session.entityInstanceCache()->contains(upperAustria));
+    }
+
+    QVERIFY(!session.isTransactionActive());
+    QVERIFY(session.entityInstanceCache()->contains(upperAustria));
+    QCOMPARE(upperAustria->id(), 1);
+
+    // an instance which was not written yet is only unregistered
+    Province* styria = new Province(QString::fromUtf8("Steiermark"));
+    QVERIFY(session.merge(styria));
+    std::unique_ptr<Province> removed = session.remove(styria);
+    QVERIFY(removed != nullptr);
+    QVERIFY(session.flush());
+    QCOMPARE(session.from<Province>().select().toVector().size(), 1);
+}
+
+void SqliteSessionTest::testFailedFlushKeepsInstancesPending()
+{
+    QOrmSession session;
+    session.setFlushMode(QOrm::FlushMode::Deferred);
+
+    auto* sqliteProvider = static_cast<QOrmSqliteProvider*>(session.configuration().provider());
+
+    // process the schema before changing it
+    QVERIFY(session.from<Province>().select().toVector().isEmpty());
+    QVERIFY(session.from<Person>().select().toVector().isEmpty());
+
+    // new instances referring to each other cannot be inserted one after the other
+    Person* alice = new Person{QString::fromUtf8("Alice"), QString::fromUtf8("Huber"), nullptr};
+    Person* bob = new Person{QString::fromUtf8("Bob"), QString::fromUtf8("Huber"), nullptr};
+    alice->setPersonParent(bob);
+    bob->setPersonParent(alice);
+    alice->setPersonChildren({bob});
+    bob->setPersonChildren({alice});
+
+    QVERIFY(session.merge(alice));
+    QVERIFY(!session.flush());
+    QCOMPARE(session.lastError().type(), QOrm::ErrorType::Other);
+    QVERIFY(!session.entityInstanceCache()->contains(alice));
+
+    bob->setPersonParent(nullptr);
+    alice->setPersonChildren({});
+
+    QVERIFY(session.flush());
+    QVERIFY(session.entityInstanceCache()->contains(alice));
+    QVERIFY(session.entityInstanceCache()->contains(bob));
+
+    // a failed write is rolled back and written again by the next flush
+    QSqlQuery query{sqliteProvider->database()};
+    QVERIFY(query.exec("CREATE TRIGGER RejectProvince BEFORE INSERT ON Province "
+                       "BEGIN SELECT RAISE(ABORT, 'rejected'); END"));
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    QVERIFY(session.merge(upperAustria));
+    QVERIFY(!session.flush());
+    QCOMPARE(session.lastError().type(), QOrm::ErrorType::Provider);
+    QVERIFY(!session.entityInstanceCache()->contains(upperAustria));
+
+    QVERIFY(query.exec("DROP TRIGGER RejectProvince"));
+
+    QVERIFY(session.flush());
+    QVERIFY(session.entityInstanceCache()->contains(upperAustria));
+    QCOMPARE(upperAustria->id(), 1);
+    QCOMPARE(session.from<Province>().select().toVector().size(), 1);
+}
+
+void SqliteSessionTest::testDeferredMergeOfCachedInstancesReferringToEachOther()
+{
+    QOrmSession session;
+
+    Person* alice = new Person{QString::fromUtf8("Alice"), QString::fromUtf8("Huber"), nullptr};
+    Person* bob = new Person{QString::fromUtf8("Bob"), QString::fromUtf8("Huber"), nullptr};
+    Person* carol = new Person{QString::fromUtf8("Carol"), QString::fromUtf8("Huber"), nullptr};
+    QVERIFY(session.merge(alice, bob, carol));
+
+    session.setFlushMode(QOrm::FlushMode::Deferred);
+
+    // updates of cached instances have no order, unlike insertions of new instances
+    alice->setPersonParent(bob);
+    bob->setPersonParent(alice);
+    alice->setPersonChildren({bob});
+    bob->setPersonChildren({alice});
+    carol->setPersonParent(carol);
+    carol->setPersonChildren({carol});
+
+    QVERIFY(session.merge(alice, bob, carol));
+    QVERIFY(session.flush());
+    QCOMPARE(session.lastError().type(), QOrm::ErrorType::None);
+    QVERIFY(!session.entityInstanceCache()->isModified(alice));
+    QVERIFY(!session.entityInstanceCache()->isModified(bob));
+    QVERIFY(!session.entityInstanceCache()->isModified(carol));
+
+    QSqlQuery query{
+        static_cast<QOrmSqliteProvider*>(session.configuration().provider())->database()};
+    QVERIFY(query.exec("SELECT id, personParent_id FROM Person ORDER BY id"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(1).toInt(), bob->id());
+    QVERIFY(query.next());
+    QCOMPARE(query.value(1).toInt(), alice->id());
+    QVERIFY(query.next());
+    QCOMPARE(query.value(1).toInt(), carol->id());
+}
+
+void SqliteSessionTest::testPendingInstancesAreNotEvicted()
+{
+    static constexpr int provinceCount = 20;
+
+    {
+        QOrmSession session;
+
+        QVector<Province*> provinces;
+
+        for (int i = 0; i < provinceCount; ++i)
+            provinces.push_back(new Province{QString{"Province %1"}.arg(i)});
+
+        QVERIFY(session.mergeAll(provinces));
+    }
+
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setVerbose(false);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Bypass);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true, 10};
+    QOrmSession session{sessionConfiguration};
+    session.setFlushMode(QOrm::FlushMode::Deferred);
+
+    QOrmEntityInstanceCache* cache = session.entityInstanceCache();
+
+    // an unmodified instance registered for a deferred merge stays cached until it is flushed
+    QPointer<Province> first =
+        session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) == 1).select().first();
+    QVERIFY(first != nullptr);
+    QVERIFY(session.merge(first.data()));
+
+    auto readOthers = [&session]() {
+        return session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) > 1).select().toVector();
+    };
+
+    // the other instances are used more recently
+    QCOMPARE(readOthers().size(), provinceCount - 1);
+    QVERIFY(!first.isNull());
+    QVERIFY(cache->contains(first));
+
+    QVERIFY(session.flush());
+
+    // once flushed, it may be evicted again
+    qint64 evictions = cache->evictions();
+    QCOMPARE(readOthers().size(), provinceCount - 1);
+    QCOMPARE(cache->evictions(), evictions + 1);
+    QVERIFY(first.isNull());
+}
+
+void SqliteSessionTest::testMergeUpdatesOnlyModifiedColumns_data()
+{
+    QTest::addColumn<QOrm::ChangeTracking>("changeTracking");
+
+    QTest::newRow("notify signals") << QOrm::ChangeTracking::NotifySignals;
+    QTest::newRow("snapshots") << QOrm::ChangeTracking::Snapshots;
+}
+
+void SqliteSessionTest::testMergeUpdatesOnlyModifiedColumns()
+{
+    QFETCH(QOrm::ChangeTracking, changeTracking);
+
+    {
+        QOrmSession session;
+
+        Town* hagenberg = new Town{QString::fromUtf8("Hagenberg"),
+                                   new Province{QString::fromUtf8("Oberösterreich")}};
+        QVERIFY(session.merge(hagenberg));
+    }
+
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setVerbose(true);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Bypass);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true, 0, changeTracking};
+    QOrmSession session{sessionConfiguration};
+
+    Town* hagenberg = session.from<Town>().select().first();
+    QVERIFY(hagenberg != nullptr);
+    QVERIFY(hagenberg->province() != nullptr);
+
+    // a concurrent change of a column which is not modified in the session is kept
+    QSqlQuery query{sqliteProvider->database()};
+    QVERIFY(query.exec("UPDATE Town SET name = 'Hagenberg im Mühlkreis' WHERE id = 1"));
+    query.finish();
+
+    hagenberg->setProvince(nullptr);
+    QCOMPARE(session.entityInstanceCache()->modifiedProperties(hagenberg),
+             QSet<QString>{"province"});
+    QVERIFY(session.merge(hagenberg));
+    QVERIFY(session.entityInstanceCache()->modifiedProperties(hagenberg).isEmpty());
+
+    QVERIFY(query.exec("SELECT name, province_id FROM Town WHERE id = 1"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toString(), QString::fromUtf8("Hagenberg im Mühlkreis"));
+    QVERIFY(query.value(1).isNull());
+}
+
+void SqliteSessionTest::testAggregatesDoNotReadInstances()
+{
+    {
+        QOrmSession session;
+
+        QVector<Province*> provinces;
+
+        for (int i = 1; i <= 10; ++i)
+            provinces.push_back(new Province(QString{"Province %1"}.arg(i, 2, 10, QChar{'0'})));
+
+        QVERIFY(session.mergeAll(provinces));
+    }
+
+    QOrmSession session{QOrmSessionConfiguration::fromFile(":/qtorm_bypass_schema.json")};
+    QOrmEntityInstanceCache* cache = session.entityInstanceCache();
+    qint64 misses = cache->misses();
+
+    QCOMPARE(session.from<Province>().count(), qint64{10});
+    QCOMPARE(session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) > 7).count(), qint64{3});
+    QCOMPARE(session.from<Province>().order(Q_ORM_CLASS_PROPERTY(id)).limit(4).offset(8).count(),
+             qint64{2});
+    QVERIFY(session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) == 5).exists());
+    QVERIFY(!session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) == 11).exists());
+
+    QCOMPARE(session.from<Province>().sum(Q_ORM_CLASS_PROPERTY(id)).toInt(), 55);
+    QCOMPARE(session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) <= 4)
+                 .avg(Q_ORM_CLASS_PROPERTY(id))
+                 .toDouble(),
+             2.5);
+    QCOMPARE(session.from<Province>().min(Q_ORM_CLASS_PROPERTY(name)).toString(),
+             QString{"Province 01"});
+    QCOMPARE(session.from<Province>().max(Q_ORM_CLASS_PROPERTY(id)).toInt(), 10);
+    QVERIFY(session.from<Province>()
+                .filter(Q_ORM_CLASS_PROPERTY(id) > 10)
+                .max(Q_ORM_CLASS_PROPERTY(id))
+                .isNull());
+
+    QCOMPARE(cache->misses(), misses);
+}
+
+void SqliteSessionTest::testAggregateGroupsRows()
+{
+    QOrmSession session;
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    Province* lowerAustria = new Province(QString::fromUtf8("Niederösterreich"));
+    Province* vienna = new Province(QString::fromUtf8("Wien"));
+
+    QVector<Town*> towns{new Town("Hagenberg", upperAustria),
+                         new Town("Pregarten", upperAustria),
+                         new Town("Linz", upperAustria),
+                         new Town("Melk", lowerAustria),
+                         new Town("Krems", lowerAustria),
+                         new Town("Wien", vienna)};
+
+    upperAustria->setTowns(towns.mid(0, 3));
+    lowerAustria->setTowns(towns.mid(3, 2));
+    vienna->setTowns(towns.mid(5));
+
+    QVERIFY(session.mergeAll(towns));
+
+    QOrmQueryResult result = session.from<Town>()
+                                 .groupBy(Q_ORM_CLASS_PROPERTY(province))
+                                 .having(QOrmAggregate{QOrm::AggregateFunction::Count},
+                                         QOrm::Comparison::Greater,
+                                         1)
+                                 .order(Q_ORM_CLASS_PROPERTY(province))
+                                 .aggregate({QOrmAggregate{QOrm::AggregateFunction::Count},
+                                             QOrmAggregate{QOrm::AggregateFunction::Min,
+                                                           Q_ORM_CLASS_PROPERTY(name)}});
+
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.values().size(), 2);
+    QCOMPARE(result.values()[0], (QVariantList{upperAustria->id(), 3, "Hagenberg"}));
+    QCOMPARE(result.values()[1], (QVariantList{lowerAustria->id(), 2, "Krems"}));
+
+    // without groups, a single row is read
+    QOrmQueryResult total = session.from<Town>().aggregate(
+        {QOrmAggregate{QOrm::AggregateFunction::Count},
+         QOrmAggregate{QOrm::AggregateFunction::Max, Q_ORM_CLASS_PROPERTY(name)}});
+
+    QCOMPARE(total.values().size(), 1);
+    QCOMPARE(total.values().front(), (QVariantList{6, "Wien"}));
+}
+
 void SqliteSessionTest::testMergeFailsWithInconsistentReferences()
 {
     QOrmSession session;
@@ -594,9 +2005,8 @@ void SqliteSessionTest::testMergeOfExistingUncachedEntitiesWithExplicitIdsUpdate
         Province* lowerAustria =
             new Province(idLowerAustria, QString::fromUtf8("Niederösterreich"));
 
-        session.merge(upperAustria, lowerAustria);
+        QVERIFY(session.merge(upperAustria, lowerAustria));
 
-        QEXPECT_FAIL("", "Not implemented yet", TestFailMode::Abort);
         QCOMPARE(upperAustria->id(), idUpperAustria);
         QCOMPARE(lowerAustria->id(), idLowerAustria);
         QCOMPARE(session.from<Province>().select().toVector().size(), 2);
@@ -672,6 +2082,161 @@ void SqliteSessionTest::testMergeNewEntitiesAfterSchemaUpdate()
     QCOMPARE(hagenberg->id(), 4232);
 }
 
+void SqliteSessionTest::testMergeAllInsertsInBatches()
+{
+    QOrmSession session;
+
+    QVector<Province*> provinces;
+
+    for (int i = 0; i < 1500; ++i)
+        provinces.push_back(new Province(QString{"Province %1"}.arg(i)));
+
+    QVERIFY(session.mergeAll(provinces));
+
+    for (int i = 0; i < provinces.size(); ++i)
+    {
+        QCOMPARE(provinces[i]->id(), i + 1);
+        QVERIFY(session.entityInstanceCache()->contains(provinces[i]));
+    }
+
+    auto result = session.from<Province>().filter(Q_ORM_CLASS_PROPERTY(id) == 1500).select();
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.toVector().size(), 1);
+    QCOMPARE(result.toVector().front(), provinces.last());
+    QCOMPARE(result.toVector().front()->name(), QString{"Province 1499"});
+}
+
+void SqliteSessionTest::testMergeAllIssuesMultiRowInserts()
+{
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName(":memory:");
+    sqliteConfiguration.setStatementCacheSize(8);
+    QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+    QOrmSession session{QOrmSessionConfiguration{sqliteProvider, false}};
+
+    QOrmSqliteProvider::SqliteCapabilities caps{session.configuration().provider()->capabilities()};
+
+    if (!caps.testFlag(QOrmSqliteProvider::SupportsReturningClause))
+        QSKIP("SQLite version does not support RETURNING");
+
+    QVector<Province*> provinces;
+
+    for (int i = 0; i < 100; ++i)
+        provinces.push_back(new Province(QString{"Province %1"}.arg(i)));
+
+    QVERIFY(session.mergeAll(provinces));
+
+    // one INSERT statement for all instances
+    QCOMPARE(sqliteProvider->statementCacheHits() + sqliteProvider->statementCacheMisses(), 1);
+
+    // the IDs are assigned in the order of the instances
+    QSqlQuery query{sqliteProvider->database()};
+    QVERIFY(query.exec("SELECT id, name FROM Province"));
+
+    int rowCount = 0;
+
+    for (; query.next(); ++rowCount)
+    {
+        int id = query.value(0).toInt();
+        QVERIFY(id >= 1 && id <= provinces.size());
+        QCOMPARE(provinces[id - 1]->id(), id);
+        QCOMPARE(query.value(1).toString(), provinces[id - 1]->name());
+    }
+
+    QCOMPARE(rowCount, provinces.size());
+}
+
+void SqliteSessionTest::testMergeAllMergesReferencedInstances()
+{
+    QOrmSession session;
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    Town* hagenberg = new Town(QString::fromUtf8("Hagenberg"), upperAustria);
+    Town* pregarten = new Town(QString::fromUtf8("Pregarten"), upperAustria);
+    upperAustria->setTowns({hagenberg, pregarten});
+
+    QVERIFY(session.mergeAll(QVector<Town*>{hagenberg, pregarten}));
+
+    QCOMPARE(upperAustria->id(), 1);
+    QCOMPARE(hagenberg->id(), 1);
+    QCOMPARE(pregarten->id(), 2);
+
+    hagenberg->setName(QString::fromUtf8("Hagenberg im Mühlkreis"));
+    Town* freistadt = new Town(QString::fromUtf8("Freistadt"), upperAustria);
+    upperAustria->setTowns({hagenberg, pregarten, freistadt});
+
+    QVERIFY(session.mergeAll(QVector<Town*>{hagenberg, pregarten, freistadt}));
+    QCOMPARE(freistadt->id(), 3);
+    QVERIFY(!session.entityInstanceCache()->isModified(hagenberg));
+
+    auto towns = session.from<Town>()
+                     .filter(Q_ORM_CLASS_PROPERTY(province) == upperAustria)
+                     .select()
+                     .toVector();
+    QCOMPARE(towns.size(), 3);
+}
+
+void SqliteSessionTest::testUpdateWithFilter()
+{
+    QOrmSession session;
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    Province* styria = new Province(QString::fromUtf8("Steiermark"));
+    Town* hagenberg = new Town(QString::fromUtf8("Hagenberg"), upperAustria);
+    Town* linz = new Town(QString::fromUtf8("Linz"), upperAustria);
+    Town* graz = new Town(QString::fromUtf8("Graz"), styria);
+    upperAustria->setTowns({hagenberg, linz});
+    styria->setTowns({graz});
+
+    QVERIFY(session.merge(hagenberg, linz, graz));
+
+    // a pending modification of another property is kept
+    hagenberg->setName(QString::fromUtf8("Hagenberg im Mühlkreis"));
+
+    auto result = session.from<Town>()
+                      .filter(Q_ORM_CLASS_PROPERTY(province) == upperAustria)
+                      .update({{Q_ORM_CLASS_PROPERTY(province), QVariant::fromValue(styria)}});
+
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+    QCOMPARE(result.numRowsAffected(), 2);
+
+    QCOMPARE(hagenberg->province(), styria);
+    QCOMPARE(linz->province(), styria);
+    QVERIFY(!session.entityInstanceCache()->isModified(linz));
+    QVERIFY(session.entityInstanceCache()->isModified(hagenberg));
+    QCOMPARE(session.entityInstanceCache()->modifiedProperties(hagenberg),
+             QSet<QString>{"name"});
+
+    // the towns are moved between the collections of the cached provinces
+    QVERIFY(upperAustria->towns().isEmpty());
+    QCOMPARE(styria->towns().size(), 3);
+    QVERIFY(styria->towns().contains(hagenberg));
+    QVERIFY(styria->towns().contains(linz));
+    QVERIFY(!session.entityInstanceCache()->isModified(upperAustria));
+    QVERIFY(!session.entityInstanceCache()->isModified(styria));
+
+    auto towns = session.from<Town>()
+                     .filter(Q_ORM_CLASS_PROPERTY(province) == styria)
+                     .select()
+                     .toVector();
+    QCOMPARE(towns.size(), 3);
+
+    // the pending modification passes the cross-reference check
+    QVERIFY(session.merge(hagenberg));
+
+    // assigning an object ID
+    auto idResult = session.from<Town>()
+                        .filter(Q_ORM_CLASS_PROPERTY(name) == QString::fromUtf8("Graz"))
+                        .update({{Q_ORM_CLASS_PROPERTY(province), upperAustria->id()}});
+
+    QCOMPARE(idResult.numRowsAffected(), 1);
+    QCOMPARE(graz->province(), upperAustria);
+    QCOMPARE(upperAustria->towns(), QVector<Town*>{graz});
+    QCOMPARE(styria->towns().size(), 2);
+    QVERIFY(!styria->towns().contains(graz));
+}
+
 void SqliteSessionTest::testTransactionRollback()
 {
     QOrmSession session;
@@ -692,6 +2257,128 @@ void SqliteSessionTest::testTransactionRollback()
     QCOMPARE(upperAustria->name(), QString::fromUtf8("Oberösterreich"));
 }
 
+void SqliteSessionTest::testNotifierEmitsCoalescedChangesAfterCommit()
+{
+    QOrmSession session;
+    QSignalSpy changed{session.notifier(), &QOrmSessionNotifier::changed};
+
+    auto takeChangeSets = [&changed]() {
+        return changed.takeFirst().at(0).value<QVector<QOrmChangeSet>>();
+    };
+
+    Province* upperAustria = new Province(QString::fromUtf8("Oberösterreich"));
+    QVERIFY(session.merge(upperAustria));
+
+    QCOMPARE(changed.count(), 1);
+    QVector<QOrmChangeSet> changeSets = takeChangeSets();
+    QCOMPARE(changeSets.size(), 1);
+    QVERIFY(changeSets[0].entity() == &Province::staticMetaObject);
+    QCOMPARE(changeSets[0].operation(), QOrm::Operation::Create);
+    QCOMPARE(changeSets[0].objectIds(), QVariantList{upperAustria->id()});
+
+    Province* lowerAustria = new Province(QString::fromUtf8("Niederösterreich"));
+
+    {
+        auto token = session.declareTransaction(QOrm::TransactionPropagation::Require,
+                                                QOrm::TransactionAction::Commit);
+
+        QVERIFY(session.merge(lowerAustria));
+        lowerAustria->setName(QString::fromUtf8("Lower Austria"));
+        QVERIFY(session.merge(lowerAustria));
+
+        upperAustria->setName(QString::fromUtf8("Upper Austria"));
+        QVERIFY(session.merge(upperAustria));
+
+        // created and removed within the transaction: not reported
+        Province* tirol = new Province(QString::fromUtf8("Tirol"));
+        QVERIFY(session.merge(tirol));
+        QVERIFY(session.remove(tirol) != nullptr);
+
+        QCOMPARE(changed.count(), 0);
+    }
+
+    QCOMPARE(changed.count(), 1);
+    changeSets = takeChangeSets();
+    QCOMPARE(changeSets.size(), 2);
+    QCOMPARE(changeSets[0].operation(), QOrm::Operation::Create);
+    QCOMPARE(changeSets[0].objectIds(), QVariantList{lowerAustria->id()});
+    QCOMPARE(changeSets[1].operation(), QOrm::Operation::Update);
+    QCOMPARE(changeSets[1].objectIds(), QVariantList{upperAustria->id()});
+
+    {
+        auto token = session.declareTransaction(QOrm::TransactionPropagation::Require,
+                                                QOrm::TransactionAction::Rollback);
+
+        upperAustria->setName(QString::fromUtf8("Oberösterreich"));
+        QVERIFY(session.merge(upperAustria));
+    }
+
+    QCOMPARE(changed.count(), 0);
+
+    // the rows updated with a filter are not known
+    auto result =
+        session.from<Province>()
+            .filter(Q_ORM_CLASS_PROPERTY(name) == QString::fromUtf8("Lower Austria"))
+            .update({{Q_ORM_CLASS_PROPERTY(name), QString::fromUtf8("Niederösterreich")}});
+    QCOMPARE(result.error().type(), QOrm::ErrorType::None);
+
+    QCOMPARE(changed.count(), 1);
+    changeSets = takeChangeSets();
+    QCOMPARE(changeSets.size(), 1);
+    QCOMPARE(changeSets[0].operation(), QOrm::Operation::Update);
+    QVERIFY(changeSets[0].objectIds().isEmpty());
+
+    std::unique_ptr<Province> removed = session.remove(lowerAustria);
+    QVERIFY(removed != nullptr);
+
+    QCOMPARE(changed.count(), 1);
+    changeSets = takeChangeSets();
+    QCOMPARE(changeSets.size(), 1);
+    QCOMPARE(changeSets[0].operation(), QOrm::Operation::Delete);
+    QCOMPARE(changeSets[0].objectIds(), QVariantList{removed->id()});
+}
+
+void SqliteSessionTest::testPreparedStatementsAreReused()
+{
+    QOrmSqliteConfiguration sqliteConfiguration{};
+    sqliteConfiguration.setVerbose(true);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName(":memory:");
+    sqliteConfiguration.setStatementCacheSize(8);
+
+    {
+        QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+        QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true};
+        QOrmSession session{sessionConfiguration};
+
+        QVERIFY(session.merge(new Province(QString::fromUtf8("Oberösterreich"))));
+        qint64 misses = sqliteProvider->statementCacheMisses();
+        QCOMPARE(sqliteProvider->statementCacheHits(), 0);
+
+        QVERIFY(session.merge(new Province(QString::fromUtf8("Niederösterreich"))));
+        QCOMPARE(sqliteProvider->statementCacheHits(), 1);
+        QCOMPARE(sqliteProvider->statementCacheMisses(), misses);
+
+        QCOMPARE(session.from<Province>().select().toVector().size(), 2);
+        QCOMPARE(session.from<Province>().select().toVector().size(), 2);
+        QCOMPARE(sqliteProvider->statementCacheHits(), 2);
+        QCOMPARE(sqliteProvider->statementCacheMisses(), misses + 1);
+    }
+
+    // without a statement cache, no lookups are counted
+    {
+        sqliteConfiguration.setStatementCacheSize(0);
+        QOrmSqliteProvider* sqliteProvider = new QOrmSqliteProvider{sqliteConfiguration};
+        QOrmSessionConfiguration sessionConfiguration{sqliteProvider, true};
+        QOrmSession session{sessionConfiguration};
+
+        QVERIFY(session.merge(new Province(QString::fromUtf8("Tirol"))));
+        QCOMPARE(session.from<Province>().select().toVector().size(), 1);
+        QCOMPARE(sqliteProvider->statementCacheHits(), 0);
+        QCOMPARE(sqliteProvider->statementCacheMisses(), 0);
+    }
+}
+
 void SqliteSessionTest::testSchemaCreatedForReferencedEntities()
 {
     {
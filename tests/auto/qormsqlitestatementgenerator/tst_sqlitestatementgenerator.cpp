@@ -19,6 +19,7 @@
  * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <QOrmAggregate>
 #include <QOrmFilter>
 #include <QOrmFilterExpression>
 #include <QOrmMetadataCache>
@@ -49,12 +50,17 @@ private slots:
     void testInsertWithOneToManyNullReference();
     void testInsertForCustomizedEntity();
     void testInsertWithNamespace();
+    void testInsertMultipleRows();
+    void testUpsertMultipleRows();
 
     void testFilterWithReference();
     void testFilterWithReferenceIsNull();
     void testFilterWithReferenceExplicitId();
     void testFilterWithNull();
     void testFilterWithList();
+    void testFilterWithJsonList();
+    void testFilterWithRangesAndPatterns();
+    void testFilterWithArithmetic();
 
     void testUpdateWithManyToOne();
     void testUpdateWithOneToMany();
@@ -62,6 +68,7 @@ private slots:
 
     void testDeleteWhere();
     void testDeleteWhereWithReturning();
+    void testUpdateWhere();
 
     void testCreateTableWithReference();
     void testCreateTableWithManyToOne();
@@ -75,9 +82,15 @@ private slots:
     void testAlterTableAddColumnWithReference();
 
     void testSelectWithLimitOffset();
+    void testSelectWithColumns();
+    void testSelectAggregates();
+    void testSelectGroupedAggregates();
     void testSelectWithNamespace();
     void testLimitOffset();
     void testLimitOffset_data();
+
+    void testPositionalParameters();
+    void testPositionalLimitOffset();
 };
 
 void SqliteStatementGenerator::init()
@@ -171,6 +184,86 @@ void SqliteStatementGenerator::testInsertWithNamespace()
     QCOMPARE(statement, R"(INSERT INTO "MyNamespace_WithNamespace"("value") VALUES(:value))");
 }
 
+void SqliteStatementGenerator::testInsertMultipleRows()
+{
+    QOrmMetadataCache cache;
+
+    QScopedPointer<Province> upperAustria{new Province(1, "Oberösterreich")};
+    QScopedPointer<Town> hagenberg{new Town{"Hagenberg", upperAustria.get()}};
+    QScopedPointer<Town> melk{new Town{"Melk", nullptr}};
+
+    {
+        QOrmSqliteStatementGenerator generator;
+        QVariantMap boundParameters;
+        QString statement = generator.generateInsertStatement(cache.get<Town>(),
+                                                              {hagenberg.get(), melk.get()},
+                                                              boundParameters);
+
+        QCOMPARE(statement,
+                 R"(INSERT INTO "Town"("name","province_id") )"
+                 R"(VALUES(:name,:province_id),(:name0,:province_id0))");
+        QCOMPARE(boundParameters[":name"], "Hagenberg");
+        QCOMPARE(boundParameters[":province_id"], 1);
+        QCOMPARE(boundParameters[":name0"], "Melk");
+        QCOMPARE(boundParameters[":province_id0"], QVariant::fromValue(nullptr));
+    }
+
+    {
+        QOrmSqliteStatementGenerator generator{QOrmSqliteStatementGenerator::WithReturningClause |
+                                               QOrmSqliteStatementGenerator::PositionalParameters};
+        QVariantMap boundParameters;
+        QString statement = generator.generateInsertStatement(cache.get<Town>(),
+                                                              {hagenberg.get(), melk.get()},
+                                                              boundParameters);
+
+        QCOMPARE(statement,
+                 R"(INSERT INTO "Town"("name","province_id") VALUES(?,?),(?,?) )"
+                 R"(RETURNING "Town"."id" AS "id")");
+        QCOMPARE(boundParameters.values(),
+                 (QVariantList{"Hagenberg", 1, "Melk", QVariant::fromValue(nullptr)}));
+    }
+}
+
+void SqliteStatementGenerator::testUpsertMultipleRows()
+{
+    QOrmMetadataCache cache;
+
+    QScopedPointer<Province> upperAustria{new Province(1, "Oberösterreich")};
+    QScopedPointer<Town> hagenberg{new Town{4232, "Hagenberg", upperAustria.get()}};
+    QScopedPointer<Town> melk{new Town{3390, "Melk", nullptr}};
+
+    {
+        QOrmSqliteStatementGenerator generator{QOrmSqliteStatementGenerator::WithUpsertClause};
+        QVariantMap boundParameters;
+        QString statement = generator.generateUpsertStatement(cache.get<Town>(),
+                                                              {hagenberg.get(), melk.get()},
+                                                              boundParameters);
+
+        QCOMPARE(statement,
+                 R"(INSERT INTO "Town"("id","name","province_id") )"
+                 R"(VALUES(:id,:name,:province_id),(:id0,:name0,:province_id0) )"
+                 R"(ON CONFLICT("id") DO UPDATE SET )"
+                 R"("name" = excluded."name","province_id" = excluded."province_id")");
+        QCOMPARE(boundParameters[":id"], 4232);
+        QCOMPARE(boundParameters[":name"], "Hagenberg");
+        QCOMPARE(boundParameters[":province_id"], 1);
+        QCOMPARE(boundParameters[":id0"], 3390);
+        QCOMPARE(boundParameters[":name0"], "Melk");
+        QCOMPARE(boundParameters[":province_id0"], QVariant::fromValue(nullptr));
+    }
+
+    {
+        QOrmSqliteStatementGenerator generator;
+        QVariantMap boundParameters;
+        QString statement =
+            generator.generateUpsertStatement(cache.get<Town>(), {melk.get()}, boundParameters);
+
+        QCOMPARE(statement,
+                 R"(INSERT INTO "Town"("id","name","province_id") )"
+                 R"(VALUES(:id,:name,:province_id))");
+    }
+}
+
 void SqliteStatementGenerator::testFilterWithReference()
 {
     QOrmSqliteStatementGenerator generator;
@@ -285,6 +378,119 @@ void SqliteStatementGenerator::testFilterWithList()
     }
 }
 
+void SqliteStatementGenerator::testFilterWithJsonList()
+{
+    QOrmSqliteStatementGenerator generator{QOrmSqliteStatementGenerator::WithJsonListParameters};
+    QOrmMetadataCache cache;
+
+    QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(QOrmRelation{cache.get<Town>()},
+                                                            Q_ORM_CLASS_PROPERTY(id) ==
+                                                                QVector<int>{1, 3, 5})};
+
+    QVariantMap boundParameters;
+    QString statement = generator.generateWhereClause(filter, boundParameters);
+
+    QCOMPARE(statement, R"(WHERE "id" IN (SELECT value FROM json_each(:id)))");
+    QCOMPARE(boundParameters.size(), 1);
+    QCOMPARE(boundParameters[":id"], "[1,3,5]");
+}
+
+void SqliteStatementGenerator::testFilterWithRangesAndPatterns()
+{
+    QOrmSqliteStatementGenerator generator;
+    QOrmMetadataCache cache;
+    QOrmRelation relation{cache.get<Community>()};
+
+    {
+        QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(
+            relation, Q_ORM_CLASS_PROPERTY(population).between(1000, 5000))};
+
+        QVariantMap boundParameters;
+        QString statement = generator.generateWhereClause(filter, boundParameters);
+
+        QCOMPARE(statement, R"(WHERE "population" BETWEEN :population AND :population0)");
+        QCOMPARE(boundParameters[":population"], 1000);
+        QCOMPARE(boundParameters[":population0"], 5000);
+    }
+
+    {
+        QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(
+            relation, Q_ORM_CLASS_PROPERTY(population).notBetween(1000, 5000))};
+
+        QVariantMap boundParameters;
+        QString statement = generator.generateWhereClause(filter, boundParameters);
+
+        QCOMPARE(statement, R"(WHERE "population" NOT BETWEEN :population AND :population0)");
+    }
+
+    {
+        QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(
+            relation, Q_ORM_CLASS_PROPERTY(name).startsWith("Hag*[x]?"))};
+
+        QVariantMap boundParameters;
+        QString statement = generator.generateWhereClause(filter, boundParameters);
+
+        QCOMPARE(statement, R"(WHERE "name" GLOB :name)");
+        QCOMPARE(boundParameters[":name"], "Hag[*][[]x][?]*");
+    }
+
+    {
+        QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(
+            relation, Q_ORM_CLASS_PROPERTY(name).equalsIgnoringCase("hagenberg"))};
+
+        QVariantMap boundParameters;
+        QString statement = generator.generateWhereClause(filter, boundParameters);
+
+        QCOMPARE(statement, R"(WHERE "name" = :name COLLATE NOCASE)");
+        QCOMPARE(boundParameters[":name"], "hagenberg");
+    }
+}
+
+void SqliteStatementGenerator::testFilterWithArithmetic()
+{
+    QOrmMetadataCache cache;
+    QOrmRelation relation{cache.get<Community>()};
+
+    {
+        QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(
+            relation, Q_ORM_CLASS_PROPERTY(population) * 2 > 10000)};
+
+        QVariantMap boundParameters;
+        QString statement =
+            QOrmSqliteStatementGenerator{}.generateWhereClause(filter, boundParameters);
+
+        QCOMPARE(statement, R"(WHERE ("population" * :population) > :population0)");
+        QCOMPARE(boundParameters[":population"], 2);
+        QCOMPARE(boundParameters[":population0"], 10000);
+    }
+
+    {
+        QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(
+            relation, Q_ORM_CLASS_PROPERTY(population) - Q_ORM_CLASS_PROPERTY(communityId) >= 0)};
+
+        QVariantMap boundParameters;
+        QString statement =
+            QOrmSqliteStatementGenerator{}.generateWhereClause(filter, boundParameters);
+
+        QCOMPARE(statement, R"(WHERE ("population" - "community_id") >= :population)");
+        QCOMPARE(boundParameters.size(), 1);
+    }
+
+    {
+        // positional parameters are bound in the order of the statement
+        QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(
+            relation, Q_ORM_CLASS_PROPERTY(population) / 10 != 7)};
+
+        QVariantMap boundParameters;
+        QString statement =
+            QOrmSqliteStatementGenerator{QOrmSqliteStatementGenerator::PositionalParameters}
+                .generateWhereClause(filter, boundParameters);
+
+        QCOMPARE(statement, R"(WHERE ("population" / ?) <> ?)");
+        QCOMPARE(boundParameters.values(), (QVariantList{10, 7}));
+    }
+}
+
 void SqliteStatementGenerator::testUpdateWithManyToOne()
 {
     QOrmSqliteStatementGenerator generator;
@@ -372,6 +578,45 @@ void SqliteStatementGenerator::testDeleteWhereWithReturning()
     QCOMPARE(boundParameters[":id"], 1);
 }
 
+void SqliteStatementGenerator::testUpdateWhere()
+{
+    QOrmSqliteStatementGenerator generator{QOrmSqliteStatementGenerator::WithReturningClause};
+    QOrmMetadataCache cache;
+    const QOrmMetadata& town = cache.get<Town>();
+
+    QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(QOrmRelation{town},
+                                                            Q_ORM_CLASS_PROPERTY(name) == "Linz")};
+
+    QScopedPointer<Province> upperAustria{new Province(2, "Oberösterreich")};
+
+    QVariantMap boundParameters;
+    QString statement = generator.generateUpdateStatement(
+        town,
+        {{*town.classPropertyMapping("name"), QString{"Linz an der Donau"}},
+         {*town.classPropertyMapping("province"), QVariant::fromValue(upperAustria.get())}},
+        filter,
+        boundParameters);
+
+    QCOMPARE(
+        statement,
+        R"(UPDATE "Town" SET "name" = :name,"province_id" = :province_id WHERE "name" = :name0 RETURNING "Town"."id" AS "id")");
+    QCOMPARE(boundParameters.size(), 3);
+    QCOMPARE(boundParameters[":name"], QString{"Linz an der Donau"});
+    QCOMPARE(boundParameters[":province_id"], 2);
+    QCOMPARE(boundParameters[":name0"], QString{"Linz"});
+
+    // object IDs are assigned as they are, nullptr as NULL; without filter all rows are updated
+    boundParameters.clear();
+    statement = QOrmSqliteStatementGenerator{}.generateUpdateStatement(
+        town,
+        {{*town.classPropertyMapping("province"), QVariant::fromValue<QObject*>(nullptr)}},
+        std::nullopt,
+        boundParameters);
+
+    QCOMPARE(statement, R"(UPDATE "Town" SET "province_id" = :province_id)");
+    QVERIFY(boundParameters[":province_id"].isNull());
+}
+
 void SqliteStatementGenerator::testCreateTableWithReference()
 {
     QOrmMetadataCache cache;
@@ -476,6 +721,112 @@ void SqliteStatementGenerator::testSelectWithLimitOffset()
     QCOMPARE(boundParameters.value(":offset", 0), 20);
 }
 
+void SqliteStatementGenerator::testSelectWithColumns()
+{
+    QOrmMetadataCache cache;
+
+    QOrmRelation relation{cache.get<Town>()};
+    QOrmMetadata projection{cache.get<Town>()};
+
+    QOrmQuery query{QOrm::Operation::Read,
+                    relation,
+                    projection,
+                    std::nullopt,
+                    std::nullopt,
+                    {},
+                    QOrm::QueryFlags::None};
+    query.setColumns({*projection.classPropertyMapping("id"),
+                      *projection.classPropertyMapping("name")});
+
+    QVariantMap boundParameters;
+    QString actual =
+        QOrmSqliteStatementGenerator{}.generateSelectStatement(query, boundParameters).simplified();
+
+    QCOMPARE(actual, R"(SELECT "id","name" FROM "Town")");
+    QVERIFY(boundParameters.isEmpty());
+}
+
+void SqliteStatementGenerator::testSelectAggregates()
+{
+    QOrmMetadataCache cache;
+
+    QOrmRelation relation{cache.get<Town>()};
+    QOrmMetadata projection{cache.get<Town>()};
+    QOrmFilter filter{QOrmPrivate::resolvedFilterExpression(relation,
+                                                            Q_ORM_CLASS_PROPERTY(id) > 1)};
+
+    QOrmQuery query{QOrm::Operation::Read,
+                    relation,
+                    projection,
+                    filter,
+                    std::nullopt,
+                    {QOrmOrder{*projection.classPropertyMapping("name"), Qt::AscendingOrder}},
+                    QOrm::QueryFlags::None};
+    query.setAggregates({QOrmAggregate{QOrm::AggregateFunction::Count},
+                         QOrmAggregate{QOrm::AggregateFunction::Max,
+                                       *projection.classPropertyMapping("name")}});
+
+    {
+        QVariantMap boundParameters;
+        QString actual = QOrmSqliteStatementGenerator{}
+                             .generateSelectStatement(query, boundParameters)
+                             .simplified();
+
+        QCOMPARE(actual, R"(SELECT COUNT(*),MAX("name") FROM "Town" WHERE "id" > :id)");
+        QCOMPARE(boundParameters.value(":id"), 1);
+    }
+
+    // the aggregates of a page are computed over a subquery
+    query.setLimit(10);
+
+    {
+        QVariantMap boundParameters;
+        QString actual = QOrmSqliteStatementGenerator{}
+                             .generateSelectStatement(query, boundParameters)
+                             .simplified();
+
+        QCOMPARE(actual,
+                 R"(SELECT COUNT(*),MAX("name") FROM )"
+                 R"((SELECT * FROM "Town" WHERE "id" > :id ORDER BY name ASC LIMIT :limit))");
+        QCOMPARE(boundParameters.value(":limit"), 10);
+    }
+}
+
+void SqliteStatementGenerator::testSelectGroupedAggregates()
+{
+    QOrmMetadataCache cache;
+
+    QOrmRelation relation{cache.get<Town>()};
+    QOrmMetadata projection{cache.get<Town>()};
+    const QOrmPropertyMapping& province = *projection.classPropertyMapping("province");
+
+    QOrmQuery query{QOrm::Operation::Read,
+                    relation,
+                    projection,
+                    std::nullopt,
+                    std::nullopt,
+                    {QOrmOrder{province, Qt::DescendingOrder}},
+                    QOrm::QueryFlags::None};
+    query.setAggregates({QOrmAggregate{QOrm::AggregateFunction::Count},
+                         QOrmAggregate{QOrm::AggregateFunction::Min,
+                                       *projection.classPropertyMapping("name")}});
+    query.setGroupBy({province});
+    query.setHaving({{QOrmAggregate{QOrm::AggregateFunction::Count},
+                      QOrm::Comparison::GreaterOrEqual,
+                      2}});
+    query.setLimit(5);
+
+    QVariantMap boundParameters;
+    QString actual =
+        QOrmSqliteStatementGenerator{}.generateSelectStatement(query, boundParameters).simplified();
+
+    QCOMPARE(actual,
+             R"(SELECT "province_id",COUNT(*),MIN("name") FROM "Town" GROUP BY "province_id" )"
+             R"(HAVING COUNT(*) >= :having ORDER BY province_id DESC LIMIT :limit)");
+    QCOMPARE(boundParameters.value(":having"), 2);
+    QCOMPARE(boundParameters.value(":limit"), 5);
+}
+
 void SqliteStatementGenerator::testSelectWithNamespace()
 {
     QOrmMetadataCache cache;
@@ -550,6 +901,76 @@ void SqliteStatementGenerator::testLimitOffset_data()
         << QVariant{} << QVariant{42} << "LIMIT :limit OFFSET :offset";
 }
 
+void SqliteStatementGenerator::testPositionalParameters()
+{
+    QOrmSqliteStatementGenerator generator{QOrmSqliteStatementGenerator::PositionalParameters};
+    QOrmMetadataCache cache;
+
+    QScopedPointer<Province> upperAustria{new Province(1, "Oberösterreich")};
+    QScopedPointer<Town> hagenberg{new Town{2, "Hagenberg", upperAustria.get()}};
+    QScopedPointer<Town> melk{new Town{3, "Melk", nullptr}};
+
+    {
+        QVariantMap boundParameters;
+        QString statement =
+            generator.generateInsertStatement(cache.get<Town>(), hagenberg.get(), boundParameters);
+
+        QCOMPARE(statement, R"(INSERT INTO "Town"("name","province_id") VALUES(?,?))");
+        QCOMPARE(boundParameters.values(), (QVariantList{"Hagenberg", 1}));
+    }
+
+    {
+        QVariantMap boundParameters;
+        QString statement =
+            generator.generateInsertStatement(cache.get<Town>(), melk.get(), boundParameters);
+
+        QCOMPARE(statement, R"(INSERT INTO "Town"("name","province_id") VALUES(?,?))");
+        QCOMPARE(boundParameters.values(), (QVariantList{"Melk", QVariant::fromValue(nullptr)}));
+    }
+
+    for (Town* town : {hagenberg.get(), melk.get()})
+    {
+        QVariantMap boundParameters;
+        QString statement =
+            generator.generateUpdateStatement(cache.get<Town>(), town, boundParameters);
+
+        QCOMPARE(statement, R"(UPDATE Town SET name = ?,province_id = ? WHERE "id" = ?)");
+        QCOMPARE(boundParameters.size(), 3);
+        QCOMPARE(boundParameters.values().last(), town->id());
+    }
+
+    for (Town* town : {hagenberg.get(), melk.get()})
+    {
+        QVariantMap boundParameters;
+        QString statement =
+            generator.generateDeleteStatement(cache.get<Town>(), town, boundParameters);
+
+        QCOMPARE(statement.simplified(), R"(DELETE FROM "Town" WHERE "id" = ?)");
+        QCOMPARE(boundParameters.values(), QVariantList{town->id()});
+    }
+}
+
+void SqliteStatementGenerator::testPositionalLimitOffset()
+{
+    QOrmSqliteStatementGenerator generator{QOrmSqliteStatementGenerator::PositionalParameters};
+
+    {
+        QVariantMap boundParameters;
+        QString actual = generator.generateLimitOffsetClause(10, std::nullopt, boundParameters);
+
+        QCOMPARE(actual, "LIMIT ? OFFSET ?");
+        QCOMPARE(boundParameters.values(), (QVariantList{10, 0}));
+    }
+
+    {
+        QVariantMap boundParameters;
+        QString actual = generator.generateLimitOffsetClause(std::nullopt, 42, boundParameters);
+
+        QCOMPARE(actual, "LIMIT ? OFFSET ?");
+        QCOMPARE(boundParameters.values(), (QVariantList{-1, 42}));
+    }
+}
+
 QTEST_APPLESS_MAIN(SqliteStatementGenerator)
 
 #include "tst_sqlitestatementgenerator.moc"
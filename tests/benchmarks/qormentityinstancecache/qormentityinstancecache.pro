@@ -0,0 +1,17 @@
+QT += testlib orm
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath benchmark c++17
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+TARGET = tst_bench_entityinstancecache
+
+SOURCES +=  tst_bench_entityinstancecache.cpp \
+    ../../auto/qormentityinstancecache/domain/province.cpp \
+    ../../auto/qormentityinstancecache/domain/town.cpp
+
+HEADERS += \
+    ../../auto/qormentityinstancecache/domain/province.h \
+    ../../auto/qormentityinstancecache/domain/town.h
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2019 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QOrmEntityInstanceCache>
+
+#include <QOrmMetadataCache>
+#include <QtTest>
+
+#include "../../auto/qormentityinstancecache/domain/province.h"
+#include "../../auto/qormentityinstancecache/domain/town.h"
+
+#include <memory>
+#include <vector>
+
+Q_DECLARE_METATYPE(QOrm::ChangeTracking)
+
+class EntityInstanceCacheBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void benchmarkFinalizeAndTake_data();
+    void benchmarkFinalizeAndTake();
+};
+
+void EntityInstanceCacheBenchmark::initTestCase()
+{
+    qRegisterOrmEntity<Province, Town>();
+}
+
+void EntityInstanceCacheBenchmark::benchmarkFinalizeAndTake_data()
+{
+    QTest::addColumn<QOrm::ChangeTracking>("changeTracking");
+
+    QTest::newRow("notify signals") << QOrm::ChangeTracking::NotifySignals;
+    QTest::newRow("snapshots") << QOrm::ChangeTracking::Snapshots;
+}
+
+void EntityInstanceCacheBenchmark::benchmarkFinalizeAndTake()
+{
+    QFETCH(QOrm::ChangeTracking, changeTracking);
+
+    QOrmMetadataCache metadataCache;
+    const QOrmMetadata& metadata = metadataCache.get<Town>();
+
+    std::vector<std::unique_ptr<Town>> towns;
+
+    for (int i = 0; i < 10000; ++i)
+        towns.emplace_back(new Town(i + 1, QString{"Town %1"}.arg(i), nullptr));
+
+    QBENCHMARK
+    {
+        QOrmEntityInstanceCache instanceCache;
+        instanceCache.setChangeTracking(changeTracking);
+
+        for (const auto& town : towns)
+        {
+            instanceCache.insert(metadata, town.get());
+            instanceCache.finalize(metadata, town.get());
+        }
+
+        for (const auto& town : towns)
+            instanceCache.take(town.get());
+    }
+}
+
+QTEST_APPLESS_MAIN(EntityInstanceCacheBenchmark)
+
+#include "tst_bench_entityinstancecache.moc"
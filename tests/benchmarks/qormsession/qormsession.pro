@@ -0,0 +1,15 @@
+QT = core testlib orm orm-private
+
+CONFIG += benchmark warn_on silent c++17
+
+TARGET = tst_bench_ormsession
+
+SOURCES +=  tst_bench_ormsession.cpp \
+    ../../auto/qormsession/domain/province.cpp \
+    ../../auto/qormsession/domain/town.cpp \
+    ../../auto/qormsession/domain/person.cpp \
+
+HEADERS += \
+    ../../auto/qormsession/domain/province.h \
+    ../../auto/qormsession/domain/town.h \
+    ../../auto/qormsession/domain/person.h \
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2020-2021 Dmitriy Purgin <dpurgin@gmail.com>
+ * Copyright (C) 2019-2022 Dmitriy Purgin <dmitriy.purgin@sequality.at>
+ * Copyright (C) 2019-2022 sequality software engineering e.U. <office@sequality.at>
+ *
+ * This file is part of QtOrm library.
+ *
+ * QtOrm is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QtOrm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QtOrm.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+
+#include <QOrmMetadataCache>
+#include <QOrmSession>
+#include <QOrmSqliteConfiguration>
+#include <QOrmSqliteProvider>
+
+#include "../../auto/qormsession/domain/person.h"
+#include "../../auto/qormsession/domain/province.h"
+#include "../../auto/qormsession/domain/town.h"
+
+#include "private/qormglobal_p.h"
+
+class OrmSessionBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void benchmarkPropertyAccess_data();
+    void benchmarkPropertyAccess();
+    void benchmarkSelect();
+};
+
+void OrmSessionBenchmark::init()
+{
+    QFile db{"testdb.db"};
+
+    if (db.exists())
+        QVERIFY(db.remove());
+
+    qRegisterOrmEntity<Town, Province, Person>();
+}
+
+void OrmSessionBenchmark::benchmarkPropertyAccess_data()
+{
+    QTest::addColumn<bool>("byMapping");
+
+    QTest::newRow("by name") << false;
+    QTest::newRow("by mapping") << true;
+}
+
+void OrmSessionBenchmark::benchmarkPropertyAccess()
+{
+    QFETCH(bool, byMapping);
+
+    QOrmMetadataCache metadataCache;
+    const QOrmPropertyMapping& mapping =
+        *metadataCache.get<Province>().classPropertyMapping("name");
+
+    Province province;
+    QVariant value{QString::fromUtf8("Oberösterreich")};
+
+    QBENCHMARK
+    {
+        for (int i = 0; i < 100000; ++i)
+        {
+            if (byMapping)
+            {
+                QVERIFY(QOrmPrivate::setPropertyValue(&province, mapping, value));
+                QCOMPARE(QOrmPrivate::propertyValue(&province, mapping), value);
+            }
+            else
+            {
+                QVERIFY(QOrmPrivate::setPropertyValue(&province, "name", value));
+                QCOMPARE(QOrmPrivate::propertyValue(&province, "name"), value);
+            }
+        }
+    }
+}
+
+void OrmSessionBenchmark::benchmarkSelect()
+{
+    static constexpr int provinceCount = 10000;
+
+    QOrmSqliteConfiguration sqliteConfiguration;
+    sqliteConfiguration.setVerbose(false);
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Recreate);
+    sqliteConfiguration.setDatabaseName("testdb.db");
+
+    {
+        QOrmSessionConfiguration sessionConfiguration{
+            new QOrmSqliteProvider{sqliteConfiguration}, true};
+        QOrmSession session{sessionConfiguration};
+
+        QVector<Province*> provinces;
+
+        for (int i = 0; i < provinceCount; ++i)
+            provinces.push_back(new Province{QString{"Province %1"}.arg(i)});
+
+        QVERIFY(session.mergeAll(provinces));
+    }
+
+    sqliteConfiguration.setSchemaMode(QOrmSqliteConfiguration::SchemaMode::Bypass);
+
+    // a new session per iteration: all rows are hydrated instead of taken from the cache
+    QBENCHMARK
+    {
+        QOrmSessionConfiguration sessionConfiguration{
+            new QOrmSqliteProvider{sqliteConfiguration}, true};
+        QOrmSession session{sessionConfiguration};
+
+        QCOMPARE(session.from<Province>().select().toVector().size(), provinceCount);
+    }
+}
+
+QTEST_GUILESS_MAIN(OrmSessionBenchmark)
+
+#include "tst_bench_ormsession.moc"